@@ -34,6 +34,27 @@
 #include "gsm/apps/gsm_mqtt_client.h"
 #include "gsm/gsm_mem.h"
 #include "gsm/gsm_pbuf.h"
+#include "gsm/gsm_timeout.h"
+
+#if GSM_CFG_MQTT_RECONNECT || __DOXYGEN__
+
+/**
+ * \brief           Subscription entry, restored after reconnect
+ */
+typedef struct {
+    char* topic;                                /*!< Allocated copy of topic. Set to `NULL` when entry is not used */
+    gsm_mqtt_qos_t qos;                         /*!< Subscription quality of service */
+    uint8_t accepted;                           /*!< Set to `1` when server accepted subscription */
+    uint16_t pkt_id;                            /*!< Packet ID of subscribe waiting for acknowledge, `0` if none */
+    gsm_mqtt_qos_t pending_qos;                 /*!< Quality of service of subscribe waiting for acknowledge */
+} mqtt_sub_t;
+
+#endif /* GSM_CFG_MQTT_RECONNECT || __DOXYGEN__ */
+
+#if GSM_CFG_MQTT_V5 || __DOXYGEN__
+/* Length of topic alias array, at least 1 element is required */
+#define MQTT_TOPIC_ALIAS_ARR_LEN        (GSM_CFG_MQTT_TOPIC_ALIAS_MAX > 0 ? GSM_CFG_MQTT_TOPIC_ALIAS_MAX : 1)
+#endif /* GSM_CFG_MQTT_V5 || __DOXYGEN__ */
 
 /**
  * \brief           MQTT client connection
@@ -50,7 +71,12 @@ typedef struct gsm_mqtt_client {
 
     gsm_buff_t tx_buff;                         /*!< Buffer for raw output data to transmit */
 
-    uint8_t is_sending;                         /*!< Flag if we are sending data currently */
+    size_t sends_len[GSM_CFG_MQTT_MAX_SENDS];   /*!< Length of each send command in flight, in order of submission */
+    size_t sends_cnt;                           /*!< Number of send commands in flight */
+    size_t sends_stale;                         /*!< Number of send events still expected from previous connections */
+    size_t sending_len;                         /*!< Number of bytes from beginning of output buffer in flight */
+    uint8_t* gather_buff;                       /*!< Linear copy of data wrapped around end of output buffer, in flight */
+    size_t gather_idx;                          /*!< Index in \ref sends_len of send using \ref gather_buff */
     uint32_t sent_total;                        /*!< Total number of bytes sent so far on connection */
     uint32_t written_total;                     /*!< Total number of bytes written into send buffer and queued for send */
 
@@ -67,6 +93,42 @@ typedef struct gsm_mqtt_client {
     uint8_t msg_rem_len_mult;                   /*!< Multiplier for remaining length */
     uint32_t msg_curr_pos;                      /*!< Current buffer write pointer */
 
+#if GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__
+    const gsm_mqtt_client_queue_ops_t* queue_ops;   /*!< Offline queue storage operations */
+    void* queue_arg;                            /*!< Offline queue storage argument */
+    size_t queue_in_flight;                     /*!< Number of records from beginning of queue written to connection */
+    size_t queue_sent;                          /*!< Number of records from beginning of queue sent at least once.
+                                                    These are replayed with duplicate flag set */
+    size_t queue_restored;                      /*!< Number of records from beginning of queue found in storage when it was set.
+                                                    User argument of these records is not known */
+    void** queue_args;                          /*!< User arguments of records behind restored ones, in queue order */
+    size_t queue_args_cnt;                      /*!< Number of used entries in \ref queue_args */
+    size_t queue_args_size;                     /*!< Number of allocated entries in \ref queue_args */
+    gsm_mqtt_client_queue_stats_t queue_stats;  /*!< Queue statistics */
+    uint32_t queue_drain_start_time;            /*!< Time of last accepted connection, used for drain rate */
+    uint32_t queue_drained_conn;                /*!< Number of drained messages since last accepted connection */
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__ */
+
+#if GSM_CFG_MQTT_RECONNECT || __DOXYGEN__
+    const char* host;                           /*!< Host address used for reconnect */
+    gsm_port_t port;                            /*!< Host port used for reconnect */
+    uint8_t reconnect;                          /*!< Set to `1` when automatic reconnect is enabled */
+    uint8_t reconnect_scheduled;                /*!< Set to `1` when reconnect timeout is waiting */
+    uint8_t reconnect_stop;                     /*!< Set to `1` when user disconnected or server refused the client */
+    uint8_t reconnect_attempt;                  /*!< Number of reconnect attempts since last accepted connection */
+    uint32_t rand_state;                        /*!< State of random generator for backoff jitter */
+    mqtt_sub_t subs[GSM_CFG_MQTT_MAX_SUBSCRIPTIONS];/*!< List of active subscriptions */
+#endif /* GSM_CFG_MQTT_RECONNECT || __DOXYGEN__ */
+
+#if GSM_CFG_MQTT_V5 || __DOXYGEN__
+    uint16_t receive_max;                       /*!< Maximal number of unacknowledged publish packets with QoS, set by server */
+    uint16_t topic_alias_max;                   /*!< Maximal topic alias accepted by server */
+    uint8_t max_qos;                            /*!< Maximal QoS of publish packets accepted by server */
+    uint8_t retain_avail;                       /*!< Set to `1` when server accepts retained messages */
+    char* topic_aliases[MQTT_TOPIC_ALIAS_ARR_LEN];  /*!< Topics assigned to aliases on current connection */
+    uint8_t disconnect_reason;                  /*!< Reason code of DISCONNECT packet received from server */
+#endif /* GSM_CFG_MQTT_V5 || __DOXYGEN__ */
+
     void* arg;                                  /*!< User argument */
 } gsm_mqtt_client_t;
 
@@ -96,6 +158,7 @@ typedef enum {
     MQTT_MSG_TYPE_PINGREQ =     0x0C,           /*!< Ping request */
     MQTT_MSG_TYPE_PINGRESP =    0x0D,           /*!< Ping response */
     MQTT_MSG_TYPE_DISCONNECT =  0x0E,           /*!< Disconnect notification */
+    MQTT_MSG_TYPE_AUTH =        0x0F,           /*!< Authentication exchange, MQTT v5.0 only */
 } mqtt_msg_type_t;
 
 /* List of flags for CONNECT message type */
@@ -110,6 +173,16 @@ typedef enum {
 #define MQTT_PARSER_STATE_CALC_REM_LEN  0x01    /*!< MQTT parser in calculating remaining length state */
 #define MQTT_PARSER_STATE_READ_REM      0x02    /*!< MQTT parser in reading remaining bytes state */
 
+/* Check if connection uses MQTT v5.0 protocol */
+#if GSM_CFG_MQTT_V5
+#define MQTT_IS_V5(client)              ((client)->info->protocol_version == GSM_MQTT_PROTOCOL_VERSION_5_0)
+#else
+#define MQTT_IS_V5(client)              0
+#endif /* GSM_CFG_MQTT_V5 */
+
+/* Reason codes equal or greater than this value indicate failure in MQTT v5.0 */
+#define MQTT_REASON_FAILURE             0x80
+
 /* Get packet type from incoming byte */
 #define MQTT_RCV_GET_PACKET_TYPE(d)     ((mqtt_msg_type_t)(((d) >> 0x04) & 0x0F))
 #define MQTT_RCV_GET_PACKET_QOS(d)      ((gsm_mqtt_qos_t)(((d) >> 0x01) & 0x03))
@@ -120,6 +193,39 @@ typedef enum {
 #define MQTT_REQUEST_FLAG_PENDING       0x02    /*!< Request object is pending waiting for response from server */
 #define MQTT_REQUEST_FLAG_SUBSCRIBE     0x04    /*!< Request object has subscribe type */
 #define MQTT_REQUEST_FLAG_UNSUBSCRIBE   0x08    /*!< Request object has unsubscribe type */
+#define MQTT_REQUEST_FLAG_QUEUED        0x10    /*!< Request object is publish packet from offline queue */
+#define MQTT_REQUEST_FLAG_RESTORE       0x20    /*!< Request object is subscribe packet to restore subscriptions */
+
+#if GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__
+
+/* Number of user argument entries allocated at once for offline queue */
+#define MQTT_QUEUE_ARGS_STEP            8
+
+/* Stored record header: packet ID, topic length and payload length (MSB first), QoS and flags */
+#define MQTT_QUEUE_REC_HDR_LEN          8
+#define MQTT_QUEUE_REC_FLAGS_POS        7
+
+/* Flags byte of stored record header */
+#define MQTT_QUEUE_REC_FLAG_RETAIN      0x01    /*!< Message has retain flag set */
+#define MQTT_QUEUE_REC_FLAG_RELEASED    0x02    /*!< Server received message with QoS 2, only release step is left */
+
+/**
+ * \brief           Offline queue record header,
+ *                  followed by topic and payload in the same record
+ *
+ * Header is stored as fixed number of bytes in defined order,
+ * independent of structure layout and endianness of the host
+ */
+typedef struct {
+    uint16_t pkt_id;                            /*!< Packet ID, kept for all send attempts of message */
+    uint16_t topic_len;                         /*!< Length of topic */
+    uint16_t payload_len;                       /*!< Length of payload */
+    uint8_t qos;                                /*!< Quality of service */
+    uint8_t retain;                             /*!< Retain flag */
+    uint8_t released;                           /*!< Set to `1` when server received message with QoS 2 */
+} mqtt_queue_rec_hdr_t;
+
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__ */
 
 #if GSM_CFG_DBG
 
@@ -129,7 +235,7 @@ mqtt_msg_type_to_str(mqtt_msg_type_t msg_type) {
         "UNKNOWN",
         "CONNECT", "CONNACK", "PUBLISH", "PUBACK", "PUBREC", "PUBREL",
         "PUBCOMP", "SUBSCRIBE", "SUBACK", "UNSUBSCRIBE", "UNSUBACK",
-        "PINGREQ", "PINGRESP", "DISCONNECT"
+        "PINGREQ", "PINGRESP", "DISCONNECT", "AUTH"
     };
     return strings[(uint8_t)msg_type];
 }
@@ -154,9 +260,20 @@ mqtt_evt_fn_default(gsm_mqtt_client_p client, gsm_mqtt_evt_t* evt) {
  */
 static uint16_t
 create_packet_id(gsm_mqtt_client_p client) {
-    if (++client->last_packet_id == 0) {
-        client->last_packet_id = 1;
-    }
+    size_t i;
+
+    /* Packet ID of queued message is assigned earlier and may still be in use */
+    do {
+        if (++client->last_packet_id == 0) {
+            client->last_packet_id = 1;
+        }
+        for (i = 0; i < GSM_CFG_MQTT_MAX_REQUESTS; ++i) {
+            if ((client->requests[i].status & MQTT_REQUEST_FLAG_PENDING)
+                && client->requests[i].packet_id == client->last_packet_id) {
+                break;
+            }
+        }
+    } while (i < GSM_CFG_MQTT_MAX_REQUESTS);
     return client->last_packet_id;
 }
 
@@ -253,9 +370,11 @@ request_send_err_callback(gsm_mqtt_client_p client, uint8_t status, void* arg) {
     if (client->evt.type == GSM_MQTT_EVT_PUBLISH) {
         client->evt.evt.publish.arg = arg;
         client->evt.evt.publish.res = gsmERR;
+        client->evt.evt.publish.reason_code = 0;
     } else {
         client->evt.evt.sub_unsub_scribed.arg = arg;
         client->evt.evt.sub_unsub_scribed.res = gsmERR;
+        client->evt.evt.sub_unsub_scribed.reason_code = 0;
     }
     client->evt_fn(client, &client->evt);
 }
@@ -371,128 +490,1082 @@ write_ack_rec_rel_resp(gsm_mqtt_client_p client, mqtt_msg_type_t msg_type, uint1
         GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE,
             "[MQTT] No memory to write %s packet\r\n", mqtt_msg_type_to_str(msg_type));
     }
-    return 0;
+    return 0;
+}
+
+/**
+ * \brief           Write string to output buffer
+ * \param[in]       client: MQTT client
+ * \param[in]       str: String to write to buffer
+ * \param[in]       len: Length of string
+ */
+static void
+write_string(gsm_mqtt_client_p client, const char* str, uint16_t len) {
+    write_u16(client, len);                     /* Write string length */
+    gsm_buff_write(&client->tx_buff, str, len); /* Write string to buffer */
+}
+
+/**
+ * \brief           Send the actual data to the remote
+ *
+ * Data not yet passed to connection are sent with single command, up to \ref GSM_CFG_CONN_MAX_DATA_LEN bytes.
+ * Linear data are sent directly from output buffer.
+ * When data wrap around end of output buffer, both parts are copied to temporary linear memory first.
+ *
+ * \param[in]       client: MQTT client
+ */
+static void
+send_data(gsm_mqtt_client_p client) {
+    size_t len, linear_len;
+    const uint8_t* addr;
+    uint8_t* gather = NULL;
+    gsmr_t res;
+
+    if (client->sends_cnt >= GSM_CFG_MQTT_MAX_SENDS) {  /* All sends are in flight */
+        return;
+    }
+
+    len = gsm_buff_get_full(&client->tx_buff) - client->sending_len;/* Get length of data not yet in flight */
+    if (len == 0) {
+        /*
+         * If buffer is empty, reset it to default state (read & write pointers)
+         * This is to make sure everytime function needs to send data,
+         * it can do it in single shot rather than in 2 attempts (when read > write pointer).
+         * Effectively this means faster transmission of MQTT packets and lower latency.
+         */
+        if (client->sends_cnt == 0) {
+            gsm_buff_reset(&client->tx_buff);
+        }
+        return;
+    }
+    len = GSM_MIN(len, GSM_CFG_CONN_MAX_DATA_LEN);
+
+    /* Get part of data, directly available in linear memory after data in flight */
+    linear_len = gsm_buff_get_linear_block_read_length(&client->tx_buff);
+    addr = gsm_buff_get_linear_block_read_address(&client->tx_buff);
+    if (client->sending_len < linear_len) {
+        addr += client->sending_len;
+        linear_len -= client->sending_len;
+    } else {                                    /* Data in flight already cover end of buffer */
+        addr = client->tx_buff.buff + (client->sending_len - linear_len);
+        linear_len = len;                       /* Remaining data are linear from beginning of buffer */
+    }
+
+    /* Data wrap around end of buffer, gather both parts to single send */
+    if (linear_len < len) {
+        if (client->gather_buff == NULL
+            && (gather = gsm_mem_malloc(sizeof(*gather) * len)) != NULL) {
+            gsm_buff_peek(&client->tx_buff, client->sending_len, gather, len);
+            addr = gather;
+        } else {
+            len = linear_len;                   /* Send linear part only */
+        }
+    }
+
+    if ((res = gsm_conn_send(client->conn, addr, len, NULL, 0)) == gsmOK) {
+        if (gather != NULL) {
+            client->gather_buff = gather;
+            client->gather_idx = client->sends_cnt;
+        }
+        client->sends_len[client->sends_cnt++] = len;
+        client->sending_len += len;             /* Increase number of bytes in flight */
+        client->written_total += len;           /* Increase number of bytes written to queue */
+    } else {
+        gsm_mem_free_s((void **)&gather);
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING,
+            "[MQTT] Cannot send data with error: %d\r\n", (int)res);
+    }
+}
+
+/**
+ * \brief           Remove oldest send command from list of sends in flight
+ * \param[in]       client: MQTT client
+ * \return          Length of removed send in units of bytes
+ */
+static size_t
+sends_pop(gsm_mqtt_client_p client) {
+    size_t len;
+
+    if (client->sends_cnt == 0) {
+        return 0;
+    }
+    len = client->sends_len[0];
+    for (size_t i = 1; i < client->sends_cnt; ++i) {
+        client->sends_len[i - 1] = client->sends_len[i];
+    }
+    --client->sends_cnt;
+    client->sending_len -= len;
+
+    if (client->gather_buff != NULL) {
+        if (client->gather_idx == 0) {          /* Gathered data have been sent */
+            gsm_mem_free_s((void **)&client->gather_buff);
+        } else {
+            --client->gather_idx;
+        }
+    }
+    return len;
+}
+
+#if GSM_CFG_MQTT_V5 || __DOXYGEN__
+
+/**
+ * \brief           Read variable byte integer
+ * \param[in]       d: Input data
+ * \param[in]       len: Length of input data
+ * \param[out]      val: Output value
+ * \return          Number of bytes used for encoding or `0` on error
+ */
+static size_t
+read_varint(const uint8_t* d, size_t len, uint32_t* val) {
+    uint32_t v = 0;
+
+    for (size_t i = 0; i < len && i < 4; ++i) {
+        v |= GSM_U32(d[i] & 0x7F) << (7 * i);
+        if (!(d[i] & 0x80)) {
+            *val = v;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Parse single MQTT v5.0 property
+ * \param[in]       d: Property data, starting with identifier
+ * \param[in]       len: Length of remaining properties
+ * \param[out]      id: Property identifier
+ * \param[out]      num: Value of integer property
+ * \param[out]      data: Pointer to string or binary property data
+ * \param[out]      data_len: Length of string or binary property data
+ * \return          Number of bytes used by property or `0` on error
+ */
+static size_t
+prop_parse(const uint8_t* d, size_t len, uint8_t* id, uint32_t* num, const uint8_t** data, size_t* data_len) {
+    size_t l;
+
+    if (len < 1) {
+        return 0;
+    }
+    *id = d[0];
+    *num = 0;
+    *data = NULL;
+    *data_len = 0;
+    switch (d[0]) {
+        case 0x01: case 0x17: case 0x19: case 0x24: /* Byte */
+        case 0x25: case 0x28: case 0x29: case 0x2A: {
+            if (len < 2) {
+                return 0;
+            }
+            *num = d[1];
+            return 2;
+        }
+        case 0x13: case 0x21: case 0x22: case 0x23: {   /* 2-byte integer */
+            if (len < 3) {
+                return 0;
+            }
+            *num = (GSM_U32(d[1]) << 8) | GSM_U32(d[2]);
+            return 3;
+        }
+        case 0x02: case 0x11: case 0x18: case 0x27: {   /* 4-byte integer */
+            if (len < 5) {
+                return 0;
+            }
+            *num = (GSM_U32(d[1]) << 24) | (GSM_U32(d[2]) << 16) | (GSM_U32(d[3]) << 8) | GSM_U32(d[4]);
+            return 5;
+        }
+        case 0x0B: {                            /* Variable byte integer */
+            l = read_varint(&d[1], len - 1, num);
+            return l > 0 ? 1 + l : 0;
+        }
+        case 0x26: {                            /* String pair, data includes both length prefixes */
+            size_t l2;
+            if (len < 3) {
+                return 0;
+            }
+            l = 2 + ((GSM_SZ(d[1]) << 8) | GSM_SZ(d[2]));
+            if (len < 1 + l + 2) {
+                return 0;
+            }
+            l2 = 2 + ((GSM_SZ(d[1 + l]) << 8) | GSM_SZ(d[1 + l + 1]));
+            if (len < 1 + l + l2) {
+                return 0;
+            }
+            *data = &d[1];
+            *data_len = l + l2;
+            return 1 + l + l2;
+        }
+        case 0x03: case 0x08: case 0x09: case 0x12: /* String or binary data */
+        case 0x15: case 0x16: case 0x1A: case 0x1C: case 0x1F: {
+            if (len < 3) {
+                return 0;
+            }
+            l = (GSM_SZ(d[1]) << 8) | GSM_SZ(d[2]);
+            if (len < 3 + l) {
+                return 0;
+            }
+            *data = &d[3];
+            *data_len = l;
+            return 3 + l;
+        }
+        default:
+            return 0;
+    }
+}
+
+/**
+ * \brief           Get property block following variable byte integer length
+ * \param[in]       d: Data starting with properties length
+ * \param[in]       len: Length of available data
+ * \param[out]      props: Pointer to first property
+ * \param[out]      props_len: Length of properties
+ * \return          Number of bytes used by length and properties or `0` on error
+ */
+static size_t
+props_get(const uint8_t* d, size_t len, const uint8_t** props, size_t* props_len) {
+    uint32_t plen;
+    size_t l;
+
+    *props = NULL;
+    *props_len = 0;
+    if ((l = read_varint(d, len, &plen)) == 0 || (l + plen) > len) {
+        return 0;
+    }
+    *props = &d[l];
+    *props_len = plen;
+    return l + plen;
+}
+
+/**
+ * \brief           Get maximal number of topic aliases used on current connection
+ * \param[in]       client: MQTT client
+ * \return          Number of aliases
+ */
+static uint16_t
+topic_alias_cnt(gsm_mqtt_client_p client) {
+    return GSM_MIN(client->topic_alias_max, GSM_U16(GSM_CFG_MQTT_TOPIC_ALIAS_MAX));
+}
+
+/**
+ * \brief           Find topic alias assigned to topic
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to search for
+ * \param[in]       len: Length of topic
+ * \return          Topic alias or `0` if not assigned
+ */
+static uint16_t
+topic_alias_find(gsm_mqtt_client_p client, const char* topic, uint16_t len) {
+    for (uint16_t i = 0; i < topic_alias_cnt(client); ++i) {
+        if (client->topic_aliases[i] != NULL
+            && !strncmp(client->topic_aliases[i], topic, len) && client->topic_aliases[i][len] == '\0') {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Assign new topic alias to topic
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to assign alias to
+ * \param[in]       len: Length of topic
+ * \return          New topic alias or `0` if no alias available
+ */
+static uint16_t
+topic_alias_new(gsm_mqtt_client_p client, const char* topic, uint16_t len) {
+    for (uint16_t i = 0; i < topic_alias_cnt(client); ++i) {
+        if (client->topic_aliases[i] == NULL) {
+            if ((client->topic_aliases[i] = gsm_mem_malloc(len + 1)) == NULL) {
+                return 0;
+            }
+            GSM_MEMCPY(client->topic_aliases[i], topic, len);
+            client->topic_aliases[i][len] = '\0';
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Release all topic aliases, they are valid only on single connection
+ * \param[in]       client: MQTT client
+ */
+static void
+topic_alias_reset(gsm_mqtt_client_p client) {
+    for (size_t i = 0; i < MQTT_TOPIC_ALIAS_ARR_LEN; ++i) {
+        gsm_mem_free_s((void **)&client->topic_aliases[i]);
+    }
+}
+
+/**
+ * \brief           Convert CONNACK reason code of MQTT v5.0 to connection status
+ * \param[in]       reason: Reason code
+ * \return          Connection status
+ */
+static gsm_mqtt_conn_status_t
+connack_reason_to_status(uint8_t reason) {
+    switch (reason) {
+        case 0x00: return GSM_MQTT_CONN_STATUS_ACCEPTED;
+        case 0x84: return GSM_MQTT_CONN_STATUS_REFUSED_PROTOCOL_VERSION;
+        case 0x85: return GSM_MQTT_CONN_STATUS_REFUSED_ID;
+        case 0x86: return GSM_MQTT_CONN_STATUS_REFUSED_USER_PASS;
+        case 0x87: return GSM_MQTT_CONN_STATUS_REFUSED_NOT_AUTHORIZED;
+        default: return GSM_MQTT_CONN_STATUS_REFUSED_SERVER;
+    }
+}
+
+#endif /* GSM_CFG_MQTT_V5 || __DOXYGEN__ */
+
+/**
+ * \brief           Check if new publish packet with quality of service may be sent
+ *
+ * On MQTT v5.0 number of unacknowledged packets is limited by receive maximum of server
+ *
+ * \param[in]       client: MQTT client
+ * \return          `1` if packet may be sent, `0` otherwise
+ */
+static uint8_t
+publish_window_available(gsm_mqtt_client_p client) {
+#if GSM_CFG_MQTT_V5
+    if (MQTT_IS_V5(client)) {
+        uint16_t cnt = 0;
+        for (size_t i = 0; i < GSM_CFG_MQTT_MAX_REQUESTS; ++i) {
+            if ((client->requests[i].status & MQTT_REQUEST_FLAG_PENDING) && client->requests[i].packet_id != 0
+                && !(client->requests[i].status & (MQTT_REQUEST_FLAG_SUBSCRIBE | MQTT_REQUEST_FLAG_UNSUBSCRIBE))) {
+                ++cnt;
+            }
+        }
+        return cnt < client->receive_max;
+    }
+#endif /* GSM_CFG_MQTT_V5 */
+    GSM_UNUSED(client);
+    return 1;
+}
+
+/**
+ * \brief           Write PUBLISH packet to output buffer, except payload
+ *
+ * On MQTT v5.0 connection topic alias is used when available
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       len_topic: Length of topic
+ * \param[in]       payload_len: Length of payload, written by caller after this function
+ * \param[in]       qos: Quality of service
+ * \param[in]       retain: Retain parameter value
+ * \param[in]       dup: Duplicate flag
+ * \param[in]       pkt_id: Packet ID, used when quality of service is greater than `0`
+ * \return          Number of RAW bytes of packet or `0` if no memory available
+ */
+static uint16_t
+write_publish_hdr(gsm_mqtt_client_p client, const char* topic, uint16_t len_topic, uint16_t payload_len,
+                  gsm_mqtt_qos_t qos, uint8_t retain, uint8_t dup, uint16_t pkt_id) {
+    uint32_t rem_len;
+    uint16_t raw_len, alias = 0;
+    uint8_t alias_exists = 0;
+
+#if GSM_CFG_MQTT_V5
+    if (MQTT_IS_V5(client)) {
+        if ((alias = topic_alias_find(client, topic, len_topic)) != 0) {
+            alias_exists = 1;                   /* Topic string can be omitted */
+        } else {
+            alias = topic_alias_new(client, topic, len_topic);  /* Decide before packet is sized */
+        }
+    }
+#endif /* GSM_CFG_MQTT_V5 */
+
+    /*
+     * Calculate remaining length of packet
+     *
+     * rem_len = 2 (topic_len) + topic_len + 2 (pkt_id, only if qos > 0) + payload_len
+     *              + properties (v5 only; 1 for length + 3 for topic alias, if used)
+     */
+    rem_len = 2 + (alias_exists ? 0 : len_topic) + payload_len;
+    if (qos > 0) {
+        rem_len += 2;
+    }
+    if (MQTT_IS_V5(client)) {
+        rem_len += 1 + (alias > 0 ? 3 : 0);     /* Properties length and topic alias */
+    }
+    if ((raw_len = output_check_enough_memory(client, rem_len)) == 0) {
+#if GSM_CFG_MQTT_V5
+        if (alias > 0 && !alias_exists) {       /* Server never learns new alias */
+            gsm_mem_free_s((void **)&client->topic_aliases[alias - 1]);
+        }
+#endif /* GSM_CFG_MQTT_V5 */
+        return 0;
+    }
+
+    write_fixed_header(client, MQTT_MSG_TYPE_PUBLISH, dup, qos, retain, rem_len);
+    write_string(client, topic, alias_exists ? 0 : len_topic);  /* Empty topic when alias is known to server */
+    if (qos > 0) {
+        write_u16(client, pkt_id);              /* Write packet ID */
+    }
+#if GSM_CFG_MQTT_V5
+    if (MQTT_IS_V5(client)) {
+        write_u8(client, alias > 0 ? 3 : 0);    /* Properties length */
+        if (alias > 0) {
+            write_u8(client, GSM_U8(GSM_MQTT_PROP_TOPIC_ALIAS));
+            write_u16(client, alias);
+        }
+    }
+#endif /* GSM_CFG_MQTT_V5 */
+    GSM_UNUSED(alias);
+    return raw_len;
+}
+
+/**
+ * \brief           Close a MQTT connection with server
+ * \param[in]       client: MQTT client
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+mqtt_close(gsm_mqtt_client_p client) {
+    gsmr_t res = gsmERR;
+    if (client->conn_state != GSM_MQTT_CONN_DISCONNECTED
+        && client->conn_state != GSM_MQTT_CONN_DISCONNECTING) {
+
+        res = gsm_conn_close(client->conn, 0);  /* Close the connection in non-blocking mode */
+        if (res == gsmOK) {
+            client->conn_state = GSM_MQTT_CONN_DISCONNECTING;
+        }
+    }
+    return res;
+}
+
+#if GSM_CFG_MQTT_RECONNECT || __DOXYGEN__
+
+/**
+ * \brief           Add topic to subscription list, waiting for server to acknowledge it
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to add
+ * \param[in]       len: Length of topic
+ * \param[in]       qos: Subscription quality of service
+ * \param[in]       pkt_id: Packet ID of subscribe packet
+ */
+static void
+subs_add(gsm_mqtt_client_p client, const char* topic, uint16_t len, gsm_mqtt_qos_t qos, uint16_t pkt_id) {
+    mqtt_sub_t* free_sub = NULL;
+
+    for (size_t i = 0; i < GSM_CFG_MQTT_MAX_SUBSCRIPTIONS; ++i) {
+        mqtt_sub_t* sub = &client->subs[i];
+        if (sub->topic == NULL) {
+            if (free_sub == NULL) {
+                free_sub = sub;
+            }
+        } else if (!strcmp(sub->topic, topic)) {
+            sub->pkt_id = pkt_id;               /* Already known, update QoS on acknowledge */
+            sub->pending_qos = qos;
+            return;
+        }
+    }
+    if (free_sub != NULL && (free_sub->topic = gsm_mem_malloc(len + 1)) != NULL) {
+        GSM_MEMCPY(free_sub->topic, topic, len + 1);
+        free_sub->accepted = 0;
+        free_sub->pkt_id = pkt_id;
+        free_sub->pending_qos = qos;
+    } else {
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING,
+            "[MQTT] No memory to remember subscription %s, it will not be restored\r\n", topic);
+    }
+}
+
+/**
+ * \brief           Process subscribe acknowledge for topics in subscription list
+ * \param[in]       client: MQTT client
+ * \param[in]       pkt_id: Packet ID of acknowledged subscribe packet. Use `0` to drop all waiting subscribes
+ * \param[in]       accepted: Set to `1` when server accepted subscription
+ */
+static void
+subs_ack(gsm_mqtt_client_p client, uint16_t pkt_id, uint8_t accepted) {
+    for (size_t i = 0; i < GSM_CFG_MQTT_MAX_SUBSCRIPTIONS; ++i) {
+        mqtt_sub_t* sub = &client->subs[i];
+        if (sub->topic == NULL || sub->pkt_id == 0 || (pkt_id != 0 && sub->pkt_id != pkt_id)) {
+            continue;
+        }
+        sub->pkt_id = 0;
+        if (accepted) {
+            sub->accepted = 1;
+            sub->qos = sub->pending_qos;
+        } else if (!sub->accepted) {            /* Rejected topics are not restored */
+            gsm_mem_free_s((void **)&sub->topic);
+        }
+    }
+}
+
+/**
+ * \brief           Remove topic from subscription list
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to remove
+ */
+static void
+subs_remove(gsm_mqtt_client_p client, const char* topic) {
+    for (size_t i = 0; i < GSM_CFG_MQTT_MAX_SUBSCRIPTIONS; ++i) {
+        if (client->subs[i].topic != NULL && !strcmp(client->subs[i].topic, topic)) {
+            gsm_mem_free_s((void **)&client->subs[i].topic);
+        }
+    }
+}
+
+/* Check if subscription is accepted and not subscribed again yet */
+#define SUBS_RESTORE_NEEDED(sub)        ((sub)->topic != NULL && (sub)->accepted && (sub)->pkt_id == 0)
+
+/**
+ * \brief           Restore subscriptions after connection was accepted without session
+ *
+ * All topics are written to single SUBSCRIBE packet if output buffer allows it,
+ * otherwise multiple packets are used.
+ * Topics subscribed again by user on connect event are already pending and are skipped
+ *
+ * \param[in]       client: MQTT client
+ */
+static void
+subs_restore(gsm_mqtt_client_p client) {
+    gsm_mqtt_request_t* request;
+    uint32_t rem_len;
+    uint16_t pkt_id;
+    size_t start = 0, end, min_len;
+
+    min_len = 2 + (MQTT_IS_V5(client) ? 1 : 0); /* Packet ID and properties length on MQTT v5.0 */
+    while (start < GSM_CFG_MQTT_MAX_SUBSCRIPTIONS) {
+        /* Find how many subscriptions fit to output buffer */
+        rem_len = min_len;
+        for (end = start; end < GSM_CFG_MQTT_MAX_SUBSCRIPTIONS; ++end) {
+            if (SUBS_RESTORE_NEEDED(&client->subs[end])) {
+                uint32_t len = 2 + strlen(client->subs[end].topic) + 1;
+
+                /* Remaining length of single packet is limited to 16-bit value, together with fixed header */
+                if (rem_len + len > GSM_U32(0xFFFF - 5)
+                    || !output_check_enough_memory(client, GSM_U16(rem_len + len))) {
+                    break;
+                }
+                rem_len += len;
+            }
+        }
+        if (rem_len == min_len) {               /* No topics to write */
+            if (end < GSM_CFG_MQTT_MAX_SUBSCRIPTIONS) {
+                GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING, "[MQTT] No memory to restore subscriptions\r\n");
+            }
+            break;
+        }
+
+        pkt_id = create_packet_id(client);
+        if ((request = request_create(client, pkt_id, NULL)) == NULL) {
+            GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING, "[MQTT] No free request to restore subscriptions\r\n");
+            break;
+        }
+        write_fixed_header(client, MQTT_MSG_TYPE_SUBSCRIBE, 0, (gsm_mqtt_qos_t)1, 0, GSM_U16(rem_len));
+        write_u16(client, pkt_id);
+        if (MQTT_IS_V5(client)) {
+            write_u8(client, 0);                /* No properties */
+        }
+        for (; start < end; ++start) {
+            if (SUBS_RESTORE_NEEDED(&client->subs[start])) {
+                write_string(client, client->subs[start].topic, GSM_U16(strlen(client->subs[start].topic)));
+                write_u8(client, GSM_U8(client->subs[start].qos));
+            }
+        }
+        request->status |= MQTT_REQUEST_FLAG_SUBSCRIBE | MQTT_REQUEST_FLAG_RESTORE;
+        request_set_pending(client, request);
+
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE, "[MQTT] Restoring subscriptions, pkt_id: %d\r\n", (int)pkt_id);
+    }
+    send_data(client);
+}
+
+/**
+ * \brief           Get next pseudo-random number for backoff jitter
+ * \param[in]       client: MQTT client
+ * \return          Random number
+ */
+static uint32_t
+reconnect_rand(gsm_mqtt_client_p client) {
+    uint32_t x = client->rand_state;
+
+    if (x == 0) {
+        x = gsm_sys_now() ^ GSM_U32((size_t)client) ^ 0x2545F491UL;
+        if (x == 0) {
+            x = 1;
+        }
+    }
+    x ^= x << 13;                               /* Xorshift generator */
+    x ^= x >> 17;
+    x ^= x << 5;
+    client->rand_state = x;
+    return x;
+}
+
+static void mqtt_reconnect_timeout_cb(void* arg);
+
+/**
+ * \brief           Schedule next reconnect attempt with exponential backoff and jitter
+ * \param[in]       client: MQTT client
+ */
+static void
+reconnect_schedule(gsm_mqtt_client_p client) {
+    uint32_t delay;
+
+    if (!client->reconnect || client->reconnect_stop || client->reconnect_scheduled) {
+        return;
+    }
+
+    delay = GSM_CFG_MQTT_RECONNECT_MIN_DELAY;
+    for (uint8_t i = 0; i < client->reconnect_attempt && delay < GSM_CFG_MQTT_RECONNECT_MAX_DELAY; ++i) {
+        delay <<= 1;
+    }
+    delay = GSM_MIN(delay, GSM_U32(GSM_CFG_MQTT_RECONNECT_MAX_DELAY));
+    delay = delay / 2 + reconnect_rand(client) % (delay / 2 + 1);   /* Random jitter in upper half of delay */
+    if (client->reconnect_attempt < 0xFF) {
+        ++client->reconnect_attempt;
+    }
+
+    if (gsm_timeout_add(delay, mqtt_reconnect_timeout_cb, client) == gsmOK) {
+        client->reconnect_scheduled = 1;
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_STATE,
+            "[MQTT] Reconnect attempt %d scheduled in %d ms\r\n", (int)client->reconnect_attempt, (int)delay);
+    }
+}
+
+/**
+ * \brief           Reconnect timeout callback
+ * \param[in]       arg: MQTT client
+ */
+static void
+mqtt_reconnect_timeout_cb(void* arg) {
+    gsm_mqtt_client_p client = arg;
+
+    client->reconnect_scheduled = 0;
+    if (!client->reconnect || client->reconnect_stop
+        || client->conn_state != GSM_MQTT_CONN_DISCONNECTED) {
+        return;
+    }
+    if (gsm_network_is_attached()
+        && gsm_conn_start(&client->conn, GSM_CONN_TYPE_TCP, client->host, client->port, client, mqtt_conn_cb, 0) == gsmOK) {
+        client->conn_state = GSM_MQTT_CONN_CONNECTING;
+    } else {
+        reconnect_schedule(client);             /* Not possible to start, try later */
+    }
+}
+
+/**
+ * \brief           Cancel waiting reconnect
+ * \param[in]       client: MQTT client
+ */
+static void
+reconnect_cancel(gsm_mqtt_client_p client) {
+    if (client->reconnect_scheduled) {
+        gsm_timeout_remove_with_arg(mqtt_reconnect_timeout_cb, client);
+        client->reconnect_scheduled = 0;
+    }
+}
+
+#endif /* GSM_CFG_MQTT_RECONNECT || __DOXYGEN__ */
+
+/**
+ * \brief           Subscribe/Unsubscribe to/from MQTT topic
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: MQTT topic to (un)subscribe
+ * \param[in]       qos: Quality of service, used only on subscribe part
+ * \param[in]       arg: Custom argument
+ * \param[in]       sub: Status set to `1` on subscribe or `0` on unsubscribe
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+sub_unsub(gsm_mqtt_client_p client, const char* topic, gsm_mqtt_qos_t qos, void* arg, uint8_t sub) {
+    gsm_mqtt_request_t* request;
+    uint32_t rem_len;
+    uint16_t len_topic, pkt_id;
+    uint8_t ret = 0;
+
+    if ((len_topic = GSM_U16(strlen(topic))) == 0) {
+        return 0;
+    }
+
+    /*
+     * Calculate remaining length of packet
+     *
+     * rem_len = 2 (topic_len) + topic_len + 2 (pkt_id) + qos (if sub) + 1 (properties length, v5 only)
+     */
+    rem_len = 2 + len_topic + 2;
+    if (sub) {
+        ++rem_len;
+    }
+
+    gsm_core_lock();
+    if (MQTT_IS_V5(client)) {
+        ++rem_len;
+    }
+    if (client->conn_state == GSM_MQTT_CONNECTED
+        && output_check_enough_memory(client, rem_len)) {   /* Check if enough memory to write packet data */
+        pkt_id = create_packet_id(client);      /* Create new packet ID */
+        request = request_create(client, pkt_id, arg);  /* Create request for packet */
+        if (request != NULL) {                  /* Do we have a request */
+            write_fixed_header(client, sub ? MQTT_MSG_TYPE_SUBSCRIBE : MQTT_MSG_TYPE_UNSUBSCRIBE, 0, (gsm_mqtt_qos_t)1, 0, rem_len);
+            write_u16(client, pkt_id);          /* Write packet ID */
+            if (MQTT_IS_V5(client)) {
+                write_u8(client, 0);            /* No properties */
+            }
+            write_string(client, topic, len_topic); /* Write topic string to packet */
+            if (sub) {                          /* Send quality of service only on subscribe */
+                write_u8(client, GSM_MIN(GSM_U8(qos), GSM_U8(GSM_MQTT_QOS_EXACTLY_ONCE)));  /* Write quality of service */
+            }
+
+            request->status |= sub ? MQTT_REQUEST_FLAG_SUBSCRIBE : MQTT_REQUEST_FLAG_UNSUBSCRIBE;
+            request_set_pending(client, request);   /* Set request as pending waiting for server reply */
+            send_data(client);                  /* Try to send data */
+#if GSM_CFG_MQTT_RECONNECT
+            if (sub) {
+                subs_add(client, topic, len_topic, (gsm_mqtt_qos_t)GSM_MIN(GSM_U8(qos), GSM_U8(GSM_MQTT_QOS_EXACTLY_ONCE)), pkt_id);
+            } else {
+                subs_remove(client, topic);
+            }
+#endif /* GSM_CFG_MQTT_RECONNECT */
+            ret = 1;
+        }
+    }
+    gsm_core_unlock();
+    return ret;
+}
+
+#if GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__
+
+/**
+ * \brief           Write part of queue record directly to output buffer
+ * \param[in]       client: MQTT client
+ * \param[in]       index: Record index in queue
+ * \param[in]       offset: Byte offset inside record
+ * \param[in]       len: Number of bytes to write
+ */
+static void
+write_from_queue(gsm_mqtt_client_p client, size_t index, size_t offset, size_t len) {
+    size_t l;
+
+    while (len > 0) {
+        l = GSM_MIN(len, gsm_buff_get_linear_block_write_length(&client->tx_buff));
+        l = client->queue_ops->read(client->queue_arg, index, offset,
+                gsm_buff_get_linear_block_write_address(&client->tx_buff), l);
+        if (l == 0) {
+            break;
+        }
+        gsm_buff_advance(&client->tx_buff, l);
+        offset += l;
+        len -= l;
+    }
+}
+
+/**
+ * \brief           Write publish message to offline queue
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       topic_len: Length of topic
+ * \param[in]       payload: Message data
+ * \param[in]       payload_len: Length of payload data
+ * \param[in]       qos: Quality of service, must be greater than `0`
+ * \param[in]       retain: Retain parameter value
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+mqtt_queue_push(gsm_mqtt_client_p client, const char* topic, uint16_t topic_len, const void* payload,
+                uint16_t payload_len, uint8_t qos, uint8_t retain, void* arg) {
+    gsm_mqtt_client_queue_chunk_t chunks[3];
+    uint8_t hdr[MQTT_QUEUE_REC_HDR_LEN];
+    uint16_t pkt_id;
+    uint32_t rem_len, raw_len, l;
+    gsmr_t res;
+
+    if (payload == NULL) {
+        payload_len = 0;
+    }
+
+    /*
+     * Message must fit to output buffer at once when sent,
+     * record which never fits would block the queue forever
+     */
+    rem_len = 2 + GSM_U32(topic_len) + 2 + GSM_U32(payload_len);
+#if GSM_CFG_MQTT_V5
+    rem_len += 1 + 3;                           /* Properties length and topic alias, if used */
+#endif /* GSM_CFG_MQTT_V5 */
+    raw_len = rem_len + 1;                      /* Remaining length + first (packet start) byte */
+    l = rem_len;
+    do {                                        /* Calculate bytes for encoding remaining length itself */
+        ++raw_len;
+        l >>= 7;
+    } while (l > 0);
+    if (rem_len > 0xFFFF || raw_len >= client->tx_buff.size) {
+        ++client->queue_stats.dropped;
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING, "[MQTT] Message too big for output buffer, not queued\r\n");
+        return gsmERRMEM;
+    }
+
+    /* User argument is kept in memory only, pointer is not valid after restart */
+    if (client->queue_args_cnt == client->queue_args_size) {
+        void** args = gsm_mem_realloc(client->queue_args,
+                        sizeof(*args) * (client->queue_args_size + MQTT_QUEUE_ARGS_STEP));
+        if (args == NULL) {
+            ++client->queue_stats.dropped;
+            return gsmERRMEM;
+        }
+        client->queue_args = args;
+        client->queue_args_size += MQTT_QUEUE_ARGS_STEP;
+    }
+
+    pkt_id = create_packet_id(client);          /* Same ID is used when message is replayed */
+    hdr[0] = GSM_U8(pkt_id >> 8);
+    hdr[1] = GSM_U8(pkt_id);
+    hdr[2] = GSM_U8(topic_len >> 8);
+    hdr[3] = GSM_U8(topic_len);
+    hdr[4] = GSM_U8(payload_len >> 8);
+    hdr[5] = GSM_U8(payload_len);
+    hdr[6] = GSM_MIN(qos, GSM_U8(GSM_MQTT_QOS_EXACTLY_ONCE));
+    hdr[MQTT_QUEUE_REC_FLAGS_POS] = retain ? MQTT_QUEUE_REC_FLAG_RETAIN : 0;
+
+    chunks[0].data = hdr;
+    chunks[0].len = sizeof(hdr);
+    chunks[1].data = topic;
+    chunks[1].len = topic_len;
+    chunks[2].data = payload;
+    chunks[2].len = payload_len;
+
+    res = client->queue_ops->push(client->queue_arg, chunks, GSM_ARRAYSIZE(chunks));
+    if (res == gsmOK) {
+        client->queue_args[client->queue_args_cnt++] = arg;
+        ++client->queue_stats.enqueued;
+    } else {
+        ++client->queue_stats.dropped;
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING, "[MQTT] Offline queue storage rejected message\r\n");
+    }
+    return res;
+}
+
+/**
+ * \brief           Read and decode header of queue record
+ * \param[in]       client: MQTT client
+ * \param[in]       index: Record index in queue
+ * \param[out]      hdr: Decoded record header
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+mqtt_queue_read_hdr(gsm_mqtt_client_p client, size_t index, mqtt_queue_rec_hdr_t* hdr) {
+    uint8_t b[MQTT_QUEUE_REC_HDR_LEN];
+
+    if (client->queue_ops->read(client->queue_arg, index, 0, b, sizeof(b)) != sizeof(b)) {
+        return 0;
+    }
+    hdr->pkt_id = GSM_U16((b[0] << 8) | b[1]);
+    hdr->topic_len = GSM_U16((b[2] << 8) | b[3]);
+    hdr->payload_len = GSM_U16((b[4] << 8) | b[5]);
+    hdr->qos = GSM_MIN(b[6], GSM_U8(GSM_MQTT_QOS_EXACTLY_ONCE));
+    hdr->retain = GSM_U8((b[MQTT_QUEUE_REC_FLAGS_POS] & MQTT_QUEUE_REC_FLAG_RETAIN) > 0);
+    hdr->released = GSM_U8((b[MQTT_QUEUE_REC_FLAGS_POS] & MQTT_QUEUE_REC_FLAG_RELEASED) > 0);
+    return 1;
+}
+
+/**
+ * \brief           Get user argument of queue record
+ * \param[in]       client: MQTT client
+ * \param[in]       index: Record index in queue
+ * \return          User argument, `NULL` for records restored from storage
+ */
+static void *
+mqtt_queue_get_arg(gsm_mqtt_client_p client, size_t index) {
+    if (index < client->queue_restored || index - client->queue_restored >= client->queue_args_cnt) {
+        return NULL;
+    }
+    return client->queue_args[index - client->queue_restored];
 }
 
 /**
- * \brief           Write string to output buffer
+ * \brief           Find in-flight queue record by its packet ID
+ *
+ * Acknowledges of messages with different quality of service may come in different order,
+ * record is found among in-flight ones by its packet ID
+ *
  * \param[in]       client: MQTT client
- * \param[in]       str: String to write to buffer
- * \param[in]       len: Length of string
+ * \param[in]       pkt_id: Packet ID of message
+ * \param[out]      hdr: Header of found record
+ * \return          Record index, number of in-flight records if not found
  */
-static void
-write_string(gsm_mqtt_client_p client, const char* str, uint16_t len) {
-    write_u16(client, len);                     /* Write string length */
-    gsm_buff_write(&client->tx_buff, str, len); /* Write string to buffer */
+static size_t
+mqtt_queue_find(gsm_mqtt_client_p client, uint16_t pkt_id, mqtt_queue_rec_hdr_t* hdr) {
+    size_t idx;
+
+    for (idx = 0; idx < client->queue_in_flight; ++idx) {
+        if (mqtt_queue_read_hdr(client, idx, hdr) && hdr->pkt_id == pkt_id) {
+            break;
+        }
+    }
+    return idx;
 }
 
 /**
- * \brief           Send the actual data to the remote
+ * \brief           Mark queue record with QoS 2 as received by server
+ *
+ * Message is replayed with release packet after reconnect, instead of publish packet
+ *
  * \param[in]       client: MQTT client
+ * \param[in]       pkt_id: Packet ID of message confirmed with PUBREC
  */
 static void
-send_data(gsm_mqtt_client_p client) {
-    size_t len;
-    const void* addr;
+mqtt_queue_release(gsm_mqtt_client_p client, uint16_t pkt_id) {
+    mqtt_queue_rec_hdr_t hdr;
+    size_t idx;
+    uint8_t flags;
 
-    if (client->is_sending) {                   /* We are currently sending data */
+    if (client->queue_ops == NULL
+        || (idx = mqtt_queue_find(client, pkt_id, &hdr)) == client->queue_in_flight) {
         return;
     }
-
-    len = gsm_buff_get_linear_block_read_length(&client->tx_buff);  /* Get length of linear memory */
-    if (len > 0) {                                  /* Anything to send? */
-        gsmr_t res;
-        addr = gsm_buff_get_linear_block_read_address(&client->tx_buff);/* Get address of linear memory */
-        if ((res = gsm_conn_send(client->conn, addr, len, NULL, 0)) == gsmOK) {
-            client->written_total += len;       /* Increase number of bytes written to queue */
-            client->is_sending = 1;             /* Remember active sending flag */
-        } else {
-            GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING,
-                "[MQTT] Cannot send data with error: %d\r\n", (int)res);
-        }
-    } else {
-        /*
-         * If buffer is empty, reset it to default state (read & write pointers)
-         * This is to make sure everytime function needs to send data,
-         * it can do it in single shot rather than in 2 attempts (when read > write pointer).
-         * Effectively this means faster transmission of MQTT packets and lower latency.
-         */
-        gsm_buff_reset(&client->tx_buff);
+    flags = MQTT_QUEUE_REC_FLAG_RELEASED | (hdr.retain ? MQTT_QUEUE_REC_FLAG_RETAIN : 0);
+    if (client->queue_ops->update(client->queue_arg, idx, MQTT_QUEUE_REC_FLAGS_POS, &flags, 1) != gsmOK) {
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING, "[MQTT] Offline queue storage failed to update message\r\n");
     }
 }
 
 /**
- * \brief           Close a MQTT connection with server
+ * \brief           Remove queue record after server acknowledged it
  * \param[in]       client: MQTT client
- * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ * \param[in]       pkt_id: Packet ID of acknowledged message
  */
-static gsmr_t
-mqtt_close(gsm_mqtt_client_p client) {
-    gsmr_t res = gsmERR;
-    if (client->conn_state != GSM_MQTT_CONN_DISCONNECTED
-        && client->conn_state != GSM_MQTT_CONN_DISCONNECTING) {
+static void
+mqtt_queue_ack(gsm_mqtt_client_p client, uint16_t pkt_id) {
+    mqtt_queue_rec_hdr_t hdr;
+    size_t idx;
 
-        res = gsm_conn_close(client->conn, 0);  /* Close the connection in non-blocking mode */
-        if (res == gsmOK) {
-            client->conn_state = GSM_MQTT_CONN_DISCONNECTING;
+    if (client->queue_ops == NULL
+        || (idx = mqtt_queue_find(client, pkt_id, &hdr)) == client->queue_in_flight) {
+        return;
+    }
+    if (client->queue_ops->remove(client->queue_arg, idx) != gsmOK) {
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING, "[MQTT] Offline queue storage failed to remove message\r\n");
+        return;
+    }
+    if (idx < client->queue_restored) {
+        --client->queue_restored;
+    } else {
+        for (idx -= client->queue_restored; idx + 1 < client->queue_args_cnt; ++idx) {
+            client->queue_args[idx] = client->queue_args[idx + 1];
         }
+        --client->queue_args_cnt;
     }
-    return res;
+    --client->queue_in_flight;
+    if (client->queue_sent > 0) {
+        --client->queue_sent;
+    }
+    ++client->queue_stats.drained;
+    ++client->queue_drained_conn;
 }
 
 /**
- * \brief           Subscribe/Unsubscribe to/from MQTT topic
+ * \brief           Write queued messages, not yet in-flight, to output buffer and send them
+ *
+ * Up to \ref GSM_CFG_MQTT_OFFLINE_QUEUE_BATCH messages are written one after another
+ * and sent with single send command, instead of waiting for server reply on each of them
+ *
  * \param[in]       client: MQTT client
- * \param[in]       topic: MQTT topic to (un)subscribe
- * \param[in]       qos: Quality of service, used only on subscribe part
- * \param[in]       arg: Custom argument
- * \param[in]       sub: Status set to `1` on subscribe or `0` on unsubscribe
- * \return          `1` on success, `0` otherwise
  */
-static uint8_t
-sub_unsub(gsm_mqtt_client_p client, const char* topic, gsm_mqtt_qos_t qos, void* arg, uint8_t sub) {
+static void
+mqtt_queue_drain(gsm_mqtt_client_p client) {
+    mqtt_queue_rec_hdr_t hdr;
     gsm_mqtt_request_t* request;
-    uint32_t rem_len;
-    uint16_t len_topic, pkt_id;
-    uint8_t ret = 0;
+    char* topic;
+    size_t cnt, idx;
+    uint16_t raw_len, pkt_id;
+    uint8_t batch = 0, dup, qos, retain;
 
-    if ((len_topic = GSM_U16(strlen(topic))) == 0) {
-        return 0;
+    if (client->queue_ops == NULL || client->conn_state != GSM_MQTT_CONNECTED) {
+        return;
     }
 
-    /*
-     * Calculate remaining length of packet
-     *
-     * rem_len = 2 (topic_len) + topic_len + 2 (pkt_id) + qos (if sub)
-     */
-    rem_len = 2 + len_topic + 2;
-    if (sub) {
-        ++rem_len;
-    }
+    cnt = client->queue_ops->get_count(client->queue_arg);
+    while (client->queue_in_flight < cnt && batch < GSM_CFG_MQTT_OFFLINE_QUEUE_BATCH
+        && publish_window_available(client)) {
+        idx = client->queue_in_flight;
+        if (!mqtt_queue_read_hdr(client, idx, &hdr)) {
+            break;
+        }
+        if (request_get_pending(client, hdr.pkt_id) != NULL) {
+            break;                              /* Wait until other packet with the same ID is acknowledged */
+        }
 
-    gsm_core_lock();
-    if (client->conn_state == GSM_MQTT_CONNECTED
-        && output_check_enough_memory(client, rem_len)) {   /* Check if enough memory to write packet data */
-        pkt_id = create_packet_id(client);      /* Create new packet ID */
-        request = request_create(client, pkt_id, arg);  /* Create request for packet */
-        if (request != NULL) {                  /* Do we have a request */
-            write_fixed_header(client, sub ? MQTT_MSG_TYPE_SUBSCRIBE : MQTT_MSG_TYPE_UNSUBSCRIBE, 0, (gsm_mqtt_qos_t)1, 0, rem_len);
-            write_u16(client, pkt_id);          /* Write packet ID */
-            write_string(client, topic, len_topic); /* Write topic string to packet */
-            if (sub) {                          /* Send quality of service only on subscribe */
-                write_u8(client, GSM_MIN(GSM_U8(qos), GSM_U8(GSM_MQTT_QOS_EXACTLY_ONCE)));  /* Write quality of service */
+        /* Server already received message with QoS 2, continue with release step only */
+        if (hdr.released) {
+            if ((request = request_create(client, hdr.pkt_id, mqtt_queue_get_arg(client, idx))) == NULL) {
+                break;
             }
+            if (!write_ack_rec_rel_resp(client, MQTT_MSG_TYPE_PUBREL, hdr.pkt_id, (gsm_mqtt_qos_t)1)) {
+                request_delete(client, request);
+                break;
+            }
+            request->status |= MQTT_REQUEST_FLAG_QUEUED;
+            request_set_pending(client, request);
 
-            request->status |= sub ? MQTT_REQUEST_FLAG_SUBSCRIBE : MQTT_REQUEST_FLAG_UNSUBSCRIBE;
-            request_set_pending(client, request);   /* Set request as pending waiting for server reply */
-            send_data(client);                  /* Try to send data */
-            ret = 1;
+            GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE,
+                "[MQTT] Queued publish release written. Index: %d, pkt_id: %d\r\n", (int)idx, (int)hdr.pkt_id);
+
+            ++client->queue_in_flight;
+            ++batch;
+            continue;
+        }
+        qos = hdr.qos;
+        retain = hdr.retain;
+#if GSM_CFG_MQTT_V5
+        /* Message may be stored before limits of server were known */
+        qos = GSM_MIN(qos, client->max_qos);
+        retain = GSM_U8(retain && client->retain_avail);
+#endif /* GSM_CFG_MQTT_V5 */
+        pkt_id = qos > 0 ? hdr.pkt_id : 0;
+
+        /* Topic is needed in memory to compare it with topic aliases */
+        if ((topic = gsm_mem_malloc(GSM_SZ(hdr.topic_len) + 1)) == NULL) {
+            break;
+        }
+        topic[client->queue_ops->read(client->queue_arg, idx, MQTT_QUEUE_REC_HDR_LEN, topic, hdr.topic_len)] = '\0';
+
+        if ((request = request_create(client, pkt_id, mqtt_queue_get_arg(client, idx))) == NULL) {
+            gsm_mem_free(topic);
+            break;
+        }
+
+        /* Message was already sent on previous connection, set duplicate flag */
+        dup = GSM_U8(qos > 0 && idx < client->queue_sent);
+        raw_len = write_publish_hdr(client, topic, hdr.topic_len, hdr.payload_len,
+                    (gsm_mqtt_qos_t)qos, retain, dup, pkt_id);
+        gsm_mem_free(topic);
+        if (raw_len == 0) {
+            request_delete(client, request);
+            break;
+        }
+        request->expected_sent_len = client->written_total + raw_len;
+        write_from_queue(client, idx, MQTT_QUEUE_REC_HDR_LEN + hdr.topic_len, hdr.payload_len);
+
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE,
+            "[MQTT] Queued publish written. Index: %d, pkt_id: %d, dup: %d\r\n",
+            (int)idx, (int)pkt_id, (int)dup);
+
+        ++client->queue_in_flight;
+        ++batch;
+        if (qos > 0) {
+            request->status |= MQTT_REQUEST_FLAG_QUEUED;
+        } else {
+            /* Server does not accept QoS, there is no acknowledge to wait for */
+            if (client->queue_in_flight > client->queue_sent) {
+                client->queue_sent = client->queue_in_flight;
+            }
+            mqtt_queue_ack(client, hdr.pkt_id);
+            cnt = client->queue_ops->get_count(client->queue_arg);
         }
+        request_set_pending(client, request);
+    }
+    if (client->queue_in_flight > client->queue_sent) {
+        client->queue_sent = client->queue_in_flight;
+    }
+    if (batch > 0) {
+        send_data(client);                      /* Send complete batch at once */
     }
-    gsm_core_unlock();
-    return ret;
 }
 
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__ */
+
 /**
  * \brief           Process incoming fully received message
  * \param[in]       client: MQTT client
@@ -514,9 +1587,48 @@ mqtt_process_incoming_message(gsm_mqtt_client_p client) {
     switch (msg_type) {
         case MQTT_MSG_TYPE_CONNACK: {
             gsm_mqtt_conn_status_t err = (gsm_mqtt_conn_status_t)client->rx_buff[1];
+            uint8_t session_present = GSM_U8(client->rx_buff[0] & 0x01);
+            const uint8_t* props = NULL;
+            size_t props_len = 0;
+#if GSM_CFG_MQTT_RECONNECT
+            uint8_t restore = 0;
+#endif /* GSM_CFG_MQTT_RECONNECT */
             if (client->conn_state == GSM_MQTT_CONNECTING) {
+#if GSM_CFG_MQTT_V5
+                if (MQTT_IS_V5(client)) {
+                    uint32_t num;
+
+                    err = connack_reason_to_status(client->rx_buff[1]);
+                    if (client->msg_rem_len > 2) {
+                        props_get(&client->rx_buff[2], client->msg_rem_len - 2, &props, &props_len);
+                    }
+                    if (gsm_mqtt_client_prop_find(props, props_len, GSM_MQTT_PROP_RECEIVE_MAXIMUM, &num, NULL, NULL) && num > 0) {
+                        client->receive_max = GSM_U16(num);
+                    }
+                    if (gsm_mqtt_client_prop_find(props, props_len, GSM_MQTT_PROP_TOPIC_ALIAS_MAXIMUM, &num, NULL, NULL)) {
+                        client->topic_alias_max = GSM_U16(num);
+                    }
+                    if (gsm_mqtt_client_prop_find(props, props_len, GSM_MQTT_PROP_MAXIMUM_QOS, &num, NULL, NULL)) {
+                        client->max_qos = GSM_U8(GSM_MIN(num, GSM_U32(GSM_MQTT_QOS_EXACTLY_ONCE)));
+                    }
+                    if (gsm_mqtt_client_prop_find(props, props_len, GSM_MQTT_PROP_RETAIN_AVAILABLE, &num, NULL, NULL)) {
+                        client->retain_avail = GSM_U8(num > 0);
+                    }
+                }
+#endif /* GSM_CFG_MQTT_V5 */
                 if (err == GSM_MQTT_CONN_STATUS_ACCEPTED) {
                     client->conn_state = GSM_MQTT_CONNECTED;
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
+                    client->queue_drain_start_time = gsm_sys_now();
+                    client->queue_drained_conn = 0;
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
+#if GSM_CFG_MQTT_RECONNECT
+                    client->reconnect_attempt = 0;
+                    /* Server did not keep subscriptions, send them again after user was notified */
+                    restore = GSM_U8(!(client->info->keep_session && session_present));
+                } else if (err != GSM_MQTT_CONN_STATUS_REFUSED_SERVER) {
+                    client->reconnect_stop = 1; /* Retry will not help, server will refuse again */
+#endif /* GSM_CFG_MQTT_RECONNECT */
                 }
                 GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE,
                     "[MQTT] CONNACK received with result: %d\r\n", (int)err);
@@ -524,7 +1636,20 @@ mqtt_process_incoming_message(gsm_mqtt_client_p client) {
                 /* Notify user layer */
                 client->evt.type = GSM_MQTT_EVT_CONNECT;
                 client->evt.evt.connect.status = err;
+                client->evt.evt.connect.session_present = session_present;
+                client->evt.evt.connect.reason_code = client->rx_buff[1];
+                client->evt.evt.connect.props = props;
+                client->evt.evt.connect.props_len = props_len;
                 client->evt_fn(client, &client->evt);
+#if GSM_CFG_MQTT_RECONNECT
+                /* Topics subscribed by user in event callback are not sent twice */
+                if (restore && client->conn_state == GSM_MQTT_CONNECTED) {
+                    subs_restore(client);
+                }
+#endif /* GSM_CFG_MQTT_RECONNECT */
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
+                mqtt_queue_drain(client);       /* Replay messages stored while offline */
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
             } else {
                 /* Protocol violation here */
                 GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE,
@@ -535,6 +1660,8 @@ mqtt_process_incoming_message(gsm_mqtt_client_p client) {
         case MQTT_MSG_TYPE_PUBLISH: {
             uint16_t topic_len, data_len;
             uint8_t *topic, *data, dup;
+            const uint8_t* props = NULL;
+            size_t props_len = 0;
 
             qos = MQTT_RCV_GET_PACKET_QOS(client->msg_hdr_byte);    /* Get QoS from received packet */
             dup = MQTT_RCV_GET_PACKET_DUP(client->msg_hdr_byte);    /* Get duplicate flag */
@@ -551,6 +1678,11 @@ mqtt_process_incoming_message(gsm_mqtt_client_p client) {
             } else {
                 pkt_id = 0;                     /* No packet ID */
             }
+#if GSM_CFG_MQTT_V5
+            if (MQTT_IS_V5(client)) {           /* Properties are before payload */
+                data += props_get(data, client->msg_rem_len - (data - client->rx_buff), &props, &props_len);
+            }
+#endif /* GSM_CFG_MQTT_V5 */
             data_len = client->msg_rem_len - (data - client->rx_buff);  /* Calculate length of remaining data */
 
             GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE,
@@ -580,6 +1712,8 @@ mqtt_process_incoming_message(gsm_mqtt_client_p client) {
             client->evt.evt.publish_recv.payload_len = data_len;
             client->evt.evt.publish_recv.dup = dup;
             client->evt.evt.publish_recv.qos = qos;
+            client->evt.evt.publish_recv.props = props;
+            client->evt.evt.publish_recv.props_len = props_len;
             client->evt_fn(client, &client->evt);
             break;
         }
@@ -596,9 +1730,45 @@ mqtt_process_incoming_message(gsm_mqtt_client_p client) {
         case MQTT_MSG_TYPE_PUBREL:
         case MQTT_MSG_TYPE_PUBACK:
         case MQTT_MSG_TYPE_PUBCOMP: {
+            uint8_t reason = 0;
             pkt_id = client->rx_buff[0] << 8 | client->rx_buff[1];  /* Get packet ID */
 
-            if (msg_type == MQTT_MSG_TYPE_PUBREC) { /* Publish record received from server */
+            /* Publish acknowledges on MQTT v5.0 may include reason code, success if omitted */
+            if (MQTT_IS_V5(client) && client->msg_rem_len > 2
+                && msg_type != MQTT_MSG_TYPE_SUBACK && msg_type != MQTT_MSG_TYPE_UNSUBACK) {
+                reason = client->rx_buff[2];
+            }
+
+            if (msg_type == MQTT_MSG_TYPE_PUBREC && reason >= MQTT_REASON_FAILURE) {
+                gsm_mqtt_request_t* request;
+
+                /* Server refused message, there is no release step */
+                if ((request = request_get_pending(client, pkt_id)) != NULL) {
+                    client->evt.type = GSM_MQTT_EVT_PUBLISH;
+                    client->evt.evt.publish.arg = request->arg;
+                    client->evt.evt.publish.res = gsmERR;
+                    client->evt.evt.publish.reason_code = reason;
+                    client->evt_fn(client, &client->evt);
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
+                    if (request->status & MQTT_REQUEST_FLAG_QUEUED) {
+                        mqtt_queue_ack(client, pkt_id); /* Retry will not help, remove message from queue */
+                    }
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
+                    request_delete(client, request);
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
+                    mqtt_queue_drain(client);
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
+                }
+            } else if (msg_type == MQTT_MSG_TYPE_PUBREC) {  /* Publish record received from server */
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
+                gsm_mqtt_request_t* request;
+
+                /* Publish must not be sent again, only release, when connection is lost before PUBCOMP */
+                if ((request = request_get_pending(client, pkt_id)) != NULL
+                    && (request->status & MQTT_REQUEST_FLAG_QUEUED)) {
+                    mqtt_queue_release(client, pkt_id);
+                }
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
                 write_ack_rec_rel_resp(client, MQTT_MSG_TYPE_PUBREL, pkt_id, (gsm_mqtt_qos_t)1);    /* Send back publish release message */
             } else if (msg_type == MQTT_MSG_TYPE_PUBREL) {  /* Publish release was received */
                 write_ack_rec_rel_resp(client, MQTT_MSG_TYPE_PUBCOMP, pkt_id, (gsm_mqtt_qos_t)0);   /* Send back publish complete */
@@ -619,10 +1789,47 @@ mqtt_process_incoming_message(gsm_mqtt_client_p client) {
                 if (request != NULL) {
                     if (msg_type == MQTT_MSG_TYPE_SUBACK
                         || msg_type == MQTT_MSG_TYPE_UNSUBACK) {
-                        client->evt.type = msg_type == MQTT_MSG_TYPE_SUBACK ? GSM_MQTT_EVT_SUBSCRIBE : GSM_MQTT_EVT_UNSUBSCRIBE;
-                        client->evt.evt.sub_unsub_scribed.arg = request->arg;
-                        client->evt.evt.sub_unsub_scribed.res = client->rx_buff[2] < 3 ? gsmOK : gsmERR;
-                        client->evt_fn(client, &client->evt);
+                        gsmr_t res = gsmOK;
+                        size_t i = 2;
+                        uint8_t failure = 3;
+
+#if GSM_CFG_MQTT_V5
+                        if (MQTT_IS_V5(client)) {   /* Reason codes follow properties, also on UNSUBACK */
+                            const uint8_t* props;
+                            size_t props_len;
+
+                            i += props_get(&client->rx_buff[2], client->msg_rem_len - 2, &props, &props_len);
+                            failure = MQTT_REASON_FAILURE;
+                        }
+#endif /* GSM_CFG_MQTT_V5 */
+                        if (i < client->msg_rem_len) {
+                            reason = client->rx_buff[i];
+                        }
+
+                        /* Check return code of each topic, there are multiple on restored subscriptions */
+                        for (; (msg_type == MQTT_MSG_TYPE_SUBACK || MQTT_IS_V5(client)) && i < client->msg_rem_len; ++i) {
+                            if (client->rx_buff[i] >= failure) {
+                                if (res == gsmOK) {
+                                    reason = client->rx_buff[i];    /* Report first failure */
+                                }
+                                res = gsmERR;
+                            }
+                        }
+                        if (request->status & MQTT_REQUEST_FLAG_RESTORE) {
+                            GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE,
+                                "[MQTT] Subscriptions restored with result: %d\r\n", (int)res);
+                        } else {
+#if GSM_CFG_MQTT_RECONNECT
+                            if (msg_type == MQTT_MSG_TYPE_SUBACK) {
+                                subs_ack(client, pkt_id, res == gsmOK); /* Remember only accepted subscriptions */
+                            }
+#endif /* GSM_CFG_MQTT_RECONNECT */
+                            client->evt.type = msg_type == MQTT_MSG_TYPE_SUBACK ? GSM_MQTT_EVT_SUBSCRIBE : GSM_MQTT_EVT_UNSUBSCRIBE;
+                            client->evt.evt.sub_unsub_scribed.arg = request->arg;
+                            client->evt.evt.sub_unsub_scribed.res = res;
+                            client->evt.evt.sub_unsub_scribed.reason_code = reason;
+                            client->evt_fn(client, &client->evt);
+                        }
 
                     /*
                      * Final acknowledge of packet received
@@ -632,10 +1839,19 @@ mqtt_process_incoming_message(gsm_mqtt_client_p client) {
                             || msg_type == MQTT_MSG_TYPE_PUBACK) {
                         client->evt.type = GSM_MQTT_EVT_PUBLISH;
                         client->evt.evt.publish.arg = request->arg;
-                        client->evt.evt.publish.res = gsmOK;
+                        client->evt.evt.publish.res = reason < MQTT_REASON_FAILURE ? gsmOK : gsmERR;
+                        client->evt.evt.publish.reason_code = reason;
                         client->evt_fn(client, &client->evt);
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
+                        if (request->status & MQTT_REQUEST_FLAG_QUEUED) {
+                            mqtt_queue_ack(client, pkt_id);/* Remove acknowledged record from queue */
+                        }
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
                     }
                     request_delete(client, request);    /* Delete request object */
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
+                    mqtt_queue_drain(client);   /* Request is free, continue with queue */
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
                 } else {
                     /* Protocol violation at this point! */
                     GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE,
@@ -644,6 +1860,14 @@ mqtt_process_incoming_message(gsm_mqtt_client_p client) {
             }
             break;
         }
+#if GSM_CFG_MQTT_V5
+        case MQTT_MSG_TYPE_DISCONNECT: {        /* Only MQTT v5.0 server may send it */
+            client->disconnect_reason = client->msg_rem_len > 0 ? client->rx_buff[0] : 0;
+            GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE,
+                "[MQTT] DISCONNECT received from server with reason: %d\r\n", (int)client->disconnect_reason);
+            break;                              /* Server closes connection after it */
+        }
+#endif /* GSM_CFG_MQTT_V5 */
         default:
             return 0;
     }
@@ -768,8 +1992,18 @@ static void
 mqtt_connected_cb(gsm_mqtt_client_p client) {
     uint16_t rem_len, len_id, len_pass = 0, len_user = 0, len_will_topic = 0, len_will_message = 0;
     uint8_t flags = 0;
+#if GSM_CFG_MQTT_V5
+    uint8_t props_len = 0;
+#endif /* GSM_CFG_MQTT_V5 */
 
-    flags |= MQTT_FLAG_CONNECT_CLEAN_SESSION;   /* Start as clean session */
+    while (client->sends_cnt > 0) {             /* Start with no sends in flight */
+        sends_pop(client);
+    }
+    client->sending_len = 0;
+
+    if (!client->info->keep_session) {
+        flags |= MQTT_FLAG_CONNECT_CLEAN_SESSION;   /* Start as clean session */
+    }
 
     /*
      * Remaining length consist of fixed header data
@@ -778,6 +2012,19 @@ mqtt_connected_cb(gsm_mqtt_client_p client) {
      * Minimum length consists of 2 + "MQTT" (4) + protocol_level (1) + flags (1) + keep_alive (2)
      */
     rem_len = 10;                               /* Set remaining length of fixed header */
+#if GSM_CFG_MQTT_V5
+    client->receive_max = 0xFFFF;               /* Defaults until CONNACK properties are received */
+    client->topic_alias_max = 0;
+    client->max_qos = GSM_U8(GSM_MQTT_QOS_EXACTLY_ONCE);
+    client->retain_avail = 1;
+    topic_alias_reset(client);
+    if (MQTT_IS_V5(client)) {
+        if (client->info->keep_session) {
+            props_len += 5;                     /* Session expiry interval */
+        }
+        rem_len += 1 + props_len;               /* Properties with length */
+    }
+#endif /* GSM_CFG_MQTT_V5 */
 
     len_id = GSM_U16(strlen(client->info->id)); /* Get cliend ID length */
     rem_len += len_id + 2;                      /* Add client id length including length entries */
@@ -790,6 +2037,9 @@ mqtt_connected_cb(gsm_mqtt_client_p client) {
         len_will_message = GSM_U16(strlen(client->info->will_message));
 
         rem_len += len_will_topic + 2;          /* Add will topic parameter */
+        if (MQTT_IS_V5(client)) {
+            ++rem_len;                          /* Empty will properties */
+        }
         rem_len += len_will_message + 2;        /* Add will message parameter */
     }
 
@@ -814,11 +2064,24 @@ mqtt_connected_cb(gsm_mqtt_client_p client) {
     /* Write everything to output buffer */
     write_fixed_header(client, MQTT_MSG_TYPE_CONNECT, 0, (gsm_mqtt_qos_t)0, 0, rem_len);
     write_string(client, "MQTT", 4);            /* Protocol name */
-    write_u8(client, 4);                        /* Protocol version */
+    write_u8(client, MQTT_IS_V5(client) ? 5 : 4);   /* Protocol version */
     write_u8(client, flags);                    /* Flags for CONNECT message */
     write_u16(client, client->info->keep_alive);/* Keep alive timeout in units of seconds */
+#if GSM_CFG_MQTT_V5
+    if (MQTT_IS_V5(client)) {
+        write_u8(client, props_len);            /* Properties length */
+        if (client->info->keep_session) {
+            write_u8(client, GSM_U8(GSM_MQTT_PROP_SESSION_EXPIRY));
+            write_u16(client, GSM_U16(GSM_U32(GSM_CFG_MQTT_SESSION_EXPIRY) >> 16));
+            write_u16(client, GSM_U16(GSM_CFG_MQTT_SESSION_EXPIRY));
+        }
+    }
+#endif /* GSM_CFG_MQTT_V5 */
     write_string(client, client->info->id, len_id); /* This is client ID string */
     if (flags & MQTT_FLAG_CONNECT_WILL) {       /* Check for will topic */
+        if (MQTT_IS_V5(client)) {
+            write_u8(client, 0);                /* No will properties */
+        }
         write_string(client, client->info->will_topic, len_will_topic); /* Write topic to packet */
         write_string(client, client->info->will_message, len_will_message); /* Write message to packet */
     }
@@ -854,15 +2117,28 @@ mqtt_data_recv_cb(gsm_mqtt_client_p client, gsm_pbuf_p pbuf) {
 /**
  * \brief           Data sent callback
  * \param[in]       client: MQTT client
+ * \param[in]       conn: Connection where data were sent
  * \param[in]       sent_len: Number of bytes sent (or not)
  * \param[in]       successful: Send status. Set to `1` on success or `0` if send error occurred
  * \return          `1` on success, `0` otherwise
  */
 static uint8_t
-mqtt_data_sent_cb(gsm_mqtt_client_p client, size_t sent_len, uint8_t successful) {
+mqtt_data_sent_cb(gsm_mqtt_client_p client, gsm_conn_p conn, size_t sent_len, uint8_t successful) {
     gsm_mqtt_request_t* request;
+    size_t len;
 
-    client->is_sending = 0;                     /* We are not sending anymore */
+    /*
+     * Sends of closed connection are finished before sends of new one,
+     * even if new connection uses the same connection handle
+     */
+    if (client->sends_stale > 0 || conn != client->conn || client->sends_cnt == 0) {
+        if (client->sends_stale > 0) {
+            --client->sends_stale;
+        }
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE, "[MQTT] Ignoring send event of previous connection\r\n");
+        return 1;
+    }
+    len = sends_pop(client);                    /* Oldest send has finished */
     client->sent_total += sent_len;
 
     client->poll_time = 0;                      /* Reset kep alive time */
@@ -879,7 +2155,7 @@ mqtt_data_sent_cb(gsm_mqtt_client_p client, size_t sent_len, uint8_t successful)
         mqtt_close(client);
         return 0;
     }
-    gsm_buff_skip(&client->tx_buff, sent_len);  /* Skip buffer for actual sent data */
+    gsm_buff_skip(&client->tx_buff, len);       /* Skip buffer for actual sent data */
 
     /*
      * Check pending publish requests without QoS because there is no confirmation received by server.
@@ -903,6 +2179,9 @@ mqtt_data_sent_cb(gsm_mqtt_client_p client, size_t sent_len, uint8_t successful)
         }
     }
 
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
+    mqtt_queue_drain(client);                   /* Output memory is free, write more queued messages */
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
     send_data(client);                          /* Try to send more */
     return 1;
 }
@@ -966,6 +2245,13 @@ mqtt_closed_cb(gsm_mqtt_client_p client, gsmr_t res, uint8_t forced) {
      * when we are connected or in disconnecting mode
      */
     client->conn_state = GSM_MQTT_CONN_DISCONNECTED;/* Connection is disconnected, ready to be established again */
+#if GSM_CFG_MQTT_V5
+    client->evt.evt.disconnect.reason_code = client->disconnect_reason;
+    client->disconnect_reason = 0;
+    topic_alias_reset(client);                  /* Aliases are valid for single connection only */
+#else
+    client->evt.evt.disconnect.reason_code = 0;
+#endif /* GSM_CFG_MQTT_V5 */
     client->evt.evt.disconnect.is_accepted = state == GSM_MQTT_CONNECTED || state == GSM_MQTT_CONN_DISCONNECTING;   /* Set connection state */
     client->evt.type = GSM_MQTT_EVT_DISCONNECT; /* Connection disconnected from server */
     client->evt_fn(client, &client->evt);       /* Notify upper layer about closed connection */
@@ -977,14 +2263,33 @@ mqtt_closed_cb(gsm_mqtt_client_p client, gsmr_t res, uint8_t forced) {
         void* arg = request->arg;
 
         request_delete(client, request);        /* Delete request */
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
+        if (status & MQTT_REQUEST_FLAG_QUEUED) {
+            continue;                           /* Message stays in queue and is sent again */
+        }
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
+        if (status & MQTT_REQUEST_FLAG_RESTORE) {
+            continue;                           /* Internal request, user is not aware of it */
+        }
         request_send_err_callback(client, status, arg); /* Send error callback to user */
     }
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
+    client->queue_in_flight = 0;
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
     GSM_MEMSET(client->requests, 0x00, sizeof(client->requests));
 
-    client->is_sending = client->sent_total = client->written_total = 0;
+    client->sends_stale += client->sends_cnt;   /* Events of sends in flight still come later */
+    while (client->sends_cnt > 0) {             /* Release sends in flight */
+        sends_pop(client);
+    }
+    client->sent_total = client->written_total = 0;
     client->parser_state = MQTT_PARSER_STATE_INIT;
     gsm_buff_reset(&client->tx_buff);           /* Reset TX buffer */
 
+#if GSM_CFG_MQTT_RECONNECT
+    subs_ack(client, 0, 0);                     /* Subscribes without acknowledge failed */
+    reconnect_schedule(client);                 /* Does nothing if user closed connection */
+#endif /* GSM_CFG_MQTT_RECONNECT */
     GSM_UNUSED(forced);
 
     return 1;
@@ -1025,7 +2330,11 @@ mqtt_conn_cb(gsm_evt_t* evt) {
                 /* Notify user upper layer */
                 client->evt.type = GSM_MQTT_EVT_CONNECT;
                 client->evt.evt.connect.status = GSM_MQTT_CONN_STATUS_TCP_FAILED;   /* TCP connection failed */
+                client->evt.evt.connect.session_present = 0;
                 client->evt_fn(client, &client->evt);   /* Notify upper layer about closed connection */
+#if GSM_CFG_MQTT_RECONNECT
+                reconnect_schedule(client);
+#endif /* GSM_CFG_MQTT_RECONNECT */
             }
             break;
         }
@@ -1045,7 +2354,7 @@ mqtt_conn_cb(gsm_evt_t* evt) {
         /* Data send event */
         case GSM_EVT_CONN_SEND: {
             /* Data sent callback */
-            mqtt_data_sent_cb(client,
+            mqtt_data_sent_cb(client, conn,
                 gsm_evt_conn_send_get_length(evt),
                 gsm_evt_conn_send_get_result(evt) == gsmOK);
             break;
@@ -1102,12 +2411,27 @@ gsm_mqtt_client_new(size_t tx_buff_len, size_t rx_buff_len) {
 
 /**
  * \brief           Delete MQTT client structure
- * \note            MQTT client must be disconnected first
+ * \note            MQTT client must be disconnected first.
+ *                  When automatic reconnect is used, disable it before last disconnect
  * \param[in]       client: MQTT client
  */
 void
 gsm_mqtt_client_delete(gsm_mqtt_client_p client) {
     if (client != NULL) {
+#if GSM_CFG_MQTT_RECONNECT
+        gsm_core_lock();
+        reconnect_cancel(client);               /* Timeout must not run on freed client */
+        gsm_core_unlock();
+        for (size_t i = 0; i < GSM_CFG_MQTT_MAX_SUBSCRIPTIONS; ++i) {
+            gsm_mem_free_s((void **)&client->subs[i].topic);
+        }
+#endif /* GSM_CFG_MQTT_RECONNECT */
+#if GSM_CFG_MQTT_V5
+        topic_alias_reset(client);
+#endif /* GSM_CFG_MQTT_V5 */
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
+        gsm_mem_free_s((void **)&client->queue_args);
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
         gsm_mem_free_s((void **)&client->rx_buff);
         gsm_buff_free(&client->tx_buff);
         gsm_mem_free_s((void **)&client);
@@ -1117,6 +2441,8 @@ gsm_mqtt_client_delete(gsm_mqtt_client_p client) {
 /**
  * \brief           Connect to MQTT server
  * \note            After TCP connection is established, CONNECT packet is automatically sent to server
+ * \note            When automatic reconnect is enabled, `host` and `info` memory must stay valid
+ *                  until client is disconnected by user
  * \param[in]       client: MQTT client
  * \param[in]       host: Host address for server
  * \param[in]       port: Host port number
@@ -1138,6 +2464,12 @@ gsm_mqtt_client_connect(gsm_mqtt_client_p client, const char* host, gsm_port_t p
     if (gsm_network_is_attached() && client->conn_state == GSM_MQTT_CONN_DISCONNECTED) {
         client->info = info;                    /* Save client info parameters */
         client->evt_fn = evt_fn != NULL ? evt_fn : mqtt_evt_fn_default;
+#if GSM_CFG_MQTT_RECONNECT
+        client->host = host;
+        client->port = port;
+        client->reconnect_stop = 0;
+        client->reconnect_attempt = 0;
+#endif /* GSM_CFG_MQTT_RECONNECT */
 
         /* Start a new connection in non-blocking mode */
         res = gsm_conn_start(&client->conn, GSM_CONN_TYPE_TCP, host, port, client, mqtt_conn_cb, 0);
@@ -1160,6 +2492,13 @@ gsm_mqtt_client_disconnect(gsm_mqtt_client_p client) {
     gsmr_t res = gsmERR;
 
     gsm_core_lock();
+#if GSM_CFG_MQTT_RECONNECT
+    client->reconnect_stop = 1;                 /* User wants to stay disconnected */
+    if (client->reconnect_scheduled) {
+        reconnect_cancel(client);
+        res = gsmOK;                            /* Waiting reconnect is canceled */
+    }
+#endif /* GSM_CFG_MQTT_RECONNECT */
     if (client->conn_state != GSM_MQTT_CONN_DISCONNECTED
         && client->conn_state != GSM_MQTT_CONN_DISCONNECTING) {
         res = mqtt_close(client);               /* Close client connection */
@@ -1199,8 +2538,10 @@ gsm_mqtt_client_unsubscribe(gsm_mqtt_client_p client, const char* topic, void* a
  * \param[in]       topic: Topic to send message to
  * \param[in]       payload: Message data
  * \param[in]       payload_len: Length of payload data
- * \param[in]       qos: Quality of service. This parameter can be a value of \ref gsm_mqtt_qos_t enumeration
- * \param[in]       retain: Retian parameter value
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref gsm_mqtt_qos_t enumeration.
+ *                      On MQTT v5.0 it is lowered to maximum QoS supported by server
+ * \param[in]       retain: Retian parameter value.
+ *                      On MQTT v5.0 message is refused with \ref gsmERR when server does not support retained messages
  * \param[in]       arg: User custom argument used in callback
  * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
  */
@@ -1209,31 +2550,55 @@ gsm_mqtt_client_publish(gsm_mqtt_client_p client, const char* topic, const void*
                         uint16_t payload_len, gsm_mqtt_qos_t qos, uint8_t retain, void* arg) {
     gsmr_t res = gsmOK;
     gsm_mqtt_request_t* request = NULL;
-    uint32_t rem_len, raw_len;
-    uint16_t len_topic, pkt_id;
-    uint8_t qos_u8 = GSM_U8(qos);
+    uint16_t len_topic, pkt_id, raw_len;
+    uint8_t qos_u8 = GSM_MIN(GSM_U8(qos), GSM_U8(GSM_MQTT_QOS_EXACTLY_ONCE));
 
     if (!(len_topic = GSM_U16(strlen(topic)))) {    /* Get length of topic */
         return gsmERR;
     }
+    if (payload == NULL) {
+        payload_len = 0;
+    }
 
+    gsm_core_lock();
+#if GSM_CFG_MQTT_V5
+    if (retain && !client->retain_avail) {
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE, "[MQTT] Retained messages are not supported by server\r\n");
+        gsm_core_unlock();
+        return gsmERR;
+    }
+    qos_u8 = GSM_MIN(qos_u8, client->max_qos);  /* Server must not receive higher QoS than it supports */
+#endif /* GSM_CFG_MQTT_V5 */
+#if GSM_CFG_MQTT_OFFLINE_QUEUE
     /*
-     * Calculate remaining length of packet
-     *
-     * rem_len = 2 (topic_len) + topic_len + 2 (pkt_idm only if qos > 0) + payload_len
+     * With offline queue, all messages with QoS are written to queue first.
+     * This keeps order of messages even if some of them wait for connection
      */
-    rem_len = 2 + len_topic + (payload != NULL ? payload_len : 0);
-    if (qos_u8 > 0) {
-        rem_len += 2;
+    if (client->queue_ops != NULL && qos_u8 > 0) {
+        if ((res = mqtt_queue_push(client, topic, len_topic, payload, payload_len, qos_u8, retain, arg)) == gsmOK) {
+            mqtt_queue_drain(client);
+        }
+        gsm_core_unlock();
+        return res;
     }
-
-    gsm_core_lock();
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE */
     if (client->conn_state != GSM_MQTT_CONNECTED) {
         res = gsmCLOSED;
-    } else if ((raw_len = output_check_enough_memory(client, rem_len)) != 0) {
+    } else if (qos_u8 > 0 && !publish_window_available(client)) {
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE, "[MQTT] Receive maximum of server reached\r\n");
+        res = gsmERRMEM;
+    } else {
         pkt_id = qos_u8 > 0 ? create_packet_id(client) : 0; /* Create new packet ID */
         request = request_create(client, pkt_id, arg);  /* Create request for packet */
-        if (request != NULL) {
+        if (request == NULL) {
+            GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE, "[MQTT] No free request available to publish message\r\n");
+            res = gsmERRMEM;
+        } else if ((raw_len = write_publish_hdr(client, topic, len_topic, payload_len,
+                    (gsm_mqtt_qos_t)qos_u8, retain, 0, pkt_id)) == 0) {
+            request_delete(client, request);
+            GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE, "[MQTT] Not enough memory to publish message\r\n");
+            res = gsmERRMEM;
+        } else {
             /*
              * Set expected number of bytes we should send before
              * we can say that this packet was sent.
@@ -1243,12 +2608,7 @@ gsm_mqtt_client_publish(gsm_mqtt_client_p client, const char* topic, const void*
              */
             request->expected_sent_len = client->written_total + raw_len;
 
-            write_fixed_header(client, MQTT_MSG_TYPE_PUBLISH, 0, (gsm_mqtt_qos_t)GSM_MIN(qos_u8, GSM_U8(GSM_MQTT_QOS_EXACTLY_ONCE)), retain, rem_len);
-            write_string(client, topic, len_topic); /* Write topic string to packet */
-            if (qos_u8) {
-                write_u16(client, pkt_id);      /* Write packet ID */
-            }
-            if (payload != NULL && payload_len) {
+            if (payload_len > 0) {
                 write_data(client, payload, payload_len);   /* Write RAW topic payload */
             }
             request_set_pending(client, request);   /* Set request as pending waiting for server reply */
@@ -1257,18 +2617,165 @@ gsm_mqtt_client_publish(gsm_mqtt_client_p client, const char* topic, const void*
 
             GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE,
                 "[MQTT] Pkt publish start. QoS: %d, pkt_id: %d\r\n", (int)qos_u8, (int)pkt_id);
-        } else {
-            GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE, "[MQTT] No free request available to publish message\r\n");
-            res = gsmERRMEM;
         }
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+#if GSM_CFG_MQTT_RECONNECT || __DOXYGEN__
+
+/**
+ * \brief           Enable or disable automatic reconnect
+ *
+ * When enabled, client connects again to last server used in \ref gsm_mqtt_client_connect
+ * after connection was lost or could not be established.
+ * Delay between attempts starts with \ref GSM_CFG_MQTT_RECONNECT_MIN_DELAY and doubles
+ * on every failed attempt, up to \ref GSM_CFG_MQTT_RECONNECT_MAX_DELAY, with random jitter.
+ *
+ * Subscriptions are restored with single SUBSCRIBE packet,
+ * unless server reports session present for client with \ref gsm_mqtt_client_info_t.keep_session set.
+ *
+ * \note            Reconnect stops after \ref gsm_mqtt_client_disconnect call
+ *                  or when server refuses client for reason other than unavailable server
+ * \param[in]       client: MQTT client
+ * \param[in]       enable: Set to `1` to enable or `0` to disable reconnect
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_client_set_reconnect(gsm_mqtt_client_p client, uint8_t enable) {
+    GSM_ASSERT("client != NULL", client != NULL);
+
+    gsm_core_lock();
+    client->reconnect = GSM_U8(!!enable);
+    gsm_core_unlock();
+    return gsmOK;
+}
+
+#endif /* GSM_CFG_MQTT_RECONNECT || __DOXYGEN__ */
+
+#if GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__
+
+/**
+ * \brief           Set offline queue storage for publish messages with quality of service `1` or `2`
+ *
+ * When queue is set, \ref gsm_mqtt_client_publish writes such messages to queue
+ * also when client is not connected. Messages are sent once connection is accepted,
+ * and removed from queue only after server acknowledged them.
+ *
+ * Messages already in storage, for example left in file from previous run,
+ * are sent with packet ID they were written with and report `NULL` user argument.
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       ops: Storage operations. Set to `NULL` to disable queue
+ * \param[in]       arg: Storage argument, passed to all storage functions
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_client_queue_set(gsm_mqtt_client_p client, const gsm_mqtt_client_queue_ops_t* ops, void* arg) {
+    gsmr_t res = gsmOK;
+
+    GSM_ASSERT("client != NULL", client != NULL);
+
+    gsm_core_lock();
+    if (client->queue_in_flight > 0) {          /* Cannot change while messages wait for acknowledge */
+        res = gsmERR;
     } else {
-        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE, "[MQTT] Not enough memory to publish message\r\n");
-        res = gsmERRMEM;
+        mqtt_queue_rec_hdr_t hdr;
+
+        client->queue_ops = ops;
+        client->queue_arg = arg;
+        client->queue_sent = 0;
+        client->queue_restored = ops != NULL ? ops->get_count(arg) : 0;
+        client->queue_args_cnt = client->queue_args_size = 0;
+        gsm_mem_free_s((void **)&client->queue_args);
+
+        /* Continue packet IDs after restored messages, to avoid waiting for the same ID */
+        if (client->queue_restored > 0
+            && mqtt_queue_read_hdr(client, client->queue_restored - 1, &hdr)) {
+            client->last_packet_id = hdr.pkt_id;
+        }
     }
     gsm_core_unlock();
     return res;
 }
 
+/**
+ * \brief           Get offline queue statistics
+ * \param[in]       client: MQTT client
+ * \param[out]      stats: Output statistics structure
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_client_queue_get_stats(gsm_mqtt_client_p client, gsm_mqtt_client_queue_stats_t* stats) {
+    uint32_t elapsed;
+
+    GSM_ASSERT("client != NULL", client != NULL);
+    GSM_ASSERT("stats != NULL", stats != NULL);
+
+    gsm_core_lock();
+    *stats = client->queue_stats;
+    stats->depth = client->queue_ops != NULL ? client->queue_ops->get_count(client->queue_arg) : 0;
+    stats->in_flight = client->queue_in_flight;
+    stats->drain_rate = 0;
+    if (client->conn_state == GSM_MQTT_CONNECTED) {
+        elapsed = gsm_sys_now() - client->queue_drain_start_time;
+        if (elapsed > 0) {
+            stats->drain_rate = GSM_U32((uint64_t)client->queue_drained_conn * 1000 / elapsed);
+        }
+    }
+    gsm_core_unlock();
+    return gsmOK;
+}
+
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__ */
+
+#if GSM_CFG_MQTT_V5 || __DOXYGEN__
+
+/**
+ * \brief           Find MQTT v5.0 property in properties received from server
+ *
+ * Use it with properties from \ref GSM_MQTT_EVT_CONNECT or \ref GSM_MQTT_EVT_PUBLISH_RECV events.
+ * For string pair properties, `data` points to first string length and includes both strings
+ *
+ * \param[in]       props: Properties data
+ * \param[in]       props_len: Length of properties data
+ * \param[in]       id: Property identifier to search for
+ * \param[out]      num: Pointer to output integer value. Set to `NULL` if not used
+ * \param[out]      data: Pointer to output string or binary data pointer. Set to `NULL` if not used
+ * \param[out]      data_len: Pointer to output data length. Set to `NULL` if not used
+ * \return          `1` if property found, `0` otherwise
+ */
+uint8_t
+gsm_mqtt_client_prop_find(const uint8_t* props, size_t props_len, gsm_mqtt_prop_t id,
+                            uint32_t* num, const uint8_t** data, size_t* data_len) {
+    const uint8_t* d;
+    size_t l, dl;
+    uint32_t n;
+    uint8_t pid;
+
+    while (props != NULL && props_len > 0
+        && (l = prop_parse(props, props_len, &pid, &n, &d, &dl)) > 0) {
+        if (pid == GSM_U8(id)) {
+            if (num != NULL) {
+                *num = n;
+            }
+            if (data != NULL) {
+                *data = d;
+            }
+            if (data_len != NULL) {
+                *data_len = dl;
+            }
+            return 1;
+        }
+        props += l;
+        props_len -= l;
+    }
+    return 0;
+}
+
+#endif /* GSM_CFG_MQTT_V5 || __DOXYGEN__ */
+
 /**
  * \brief           Test if client is connected to server and accepted to MQTT protocol
  * \note            Function will return error if TCP is connected but MQTT not accepted
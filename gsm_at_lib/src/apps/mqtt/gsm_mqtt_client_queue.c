@@ -0,0 +1,233 @@
+/**
+ * \file            gsm_mqtt_client_queue.c
+ * \brief           MQTT client offline queue RAM storage
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include "gsm/apps/gsm_mqtt_client_queue.h"
+#include "gsm/gsm_mem.h"
+
+#if GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__
+
+/* Each record is prefixed with 2 bytes of length, MSB first */
+#define RAM_REC_HDR_LEN                 2
+
+/**
+ * \brief           Get length of record at specific byte offset in buffer
+ * \param[in]       q: RAM queue
+ * \param[in]       pos: Byte offset from read pointer
+ * \return          Record length, excluding length prefix
+ */
+static size_t
+ram_rec_len(gsm_mqtt_client_queue_ram_t* q, size_t pos) {
+    uint8_t b[RAM_REC_HDR_LEN];
+
+    if (gsm_buff_peek(&q->buff, pos, b, sizeof(b)) != sizeof(b)) {
+        return 0;
+    }
+    return (GSM_SZ(b[0]) << 8) | GSM_SZ(b[1]);
+}
+
+/**
+ * \brief           Store new record to RAM queue
+ * \param[in]       arg: RAM queue
+ * \param[in]       chunks: Array of record chunks
+ * \param[in]       chunks_cnt: Number of chunks
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+ram_push(void* arg, const gsm_mqtt_client_queue_chunk_t* chunks, size_t chunks_cnt) {
+    gsm_mqtt_client_queue_ram_t* q = arg;
+    uint8_t b[RAM_REC_HDR_LEN];
+    size_t len = 0;
+
+    for (size_t i = 0; i < chunks_cnt; ++i) {
+        len += chunks[i].len;
+    }
+    if (len > 0xFFFF || gsm_buff_get_free(&q->buff) < (len + RAM_REC_HDR_LEN)) {
+        return gsmERRMEM;
+    }
+
+    b[0] = GSM_U8(len >> 8);
+    b[1] = GSM_U8(len);
+    gsm_buff_write(&q->buff, b, sizeof(b));     /* Write length prefix */
+    for (size_t i = 0; i < chunks_cnt; ++i) {
+        gsm_buff_write(&q->buff, chunks[i].data, chunks[i].len);
+    }
+    ++q->count;
+    return gsmOK;
+}
+
+/**
+ * \brief           Read part of record from RAM queue
+ * \param[in]       arg: RAM queue
+ * \param[in]       index: Record index from beginning of queue
+ * \param[in]       offset: Byte offset inside record
+ * \param[out]      data: Output memory
+ * \param[in]       len: Number of bytes to read
+ * \return          Number of bytes copied to output memory
+ */
+static size_t
+ram_read(void* arg, size_t index, size_t offset, void* data, size_t len) {
+    gsm_mqtt_client_queue_ram_t* q = arg;
+    size_t pos = 0, rec_len;
+
+    if (index >= q->count) {
+        return 0;
+    }
+    for (; index > 0; --index) {                /* Skip records in front */
+        pos += RAM_REC_HDR_LEN + ram_rec_len(q, pos);
+    }
+    rec_len = ram_rec_len(q, pos);
+    if (offset >= rec_len) {
+        return 0;
+    }
+    len = GSM_MIN(len, rec_len - offset);
+    return gsm_buff_peek(&q->buff, pos + RAM_REC_HDR_LEN + offset, data, len);
+}
+
+/**
+ * \brief           Remove record from RAM queue
+ *
+ * Records in front of removed one are moved towards the end by its length,
+ * freed memory is then skipped at the beginning of buffer
+ *
+ * \param[in]       arg: RAM queue
+ * \param[in]       index: Record index from beginning of queue
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+ram_remove(void* arg, size_t index) {
+    gsm_mqtt_client_queue_ram_t* q = arg;
+    size_t pos = 0, len;
+
+    if (index >= q->count) {
+        return gsmERR;
+    }
+    for (; index > 0; --index) {                /* Skip records in front */
+        pos += RAM_REC_HDR_LEN + ram_rec_len(q, pos);
+    }
+    len = RAM_REC_HDR_LEN + ram_rec_len(q, pos);
+    for (; pos > 0; --pos) {                    /* Move from last byte backwards, regions may overlap */
+        q->buff.buff[(q->buff.r + pos - 1 + len) % q->buff.size] = q->buff.buff[(q->buff.r + pos - 1) % q->buff.size];
+    }
+    gsm_buff_skip(&q->buff, len);
+    if (--q->count == 0) {
+        gsm_buff_reset(&q->buff);               /* Start from beginning of memory */
+    }
+    return gsmOK;
+}
+
+/**
+ * \brief           Overwrite part of record in RAM queue
+ * \param[in]       arg: RAM queue
+ * \param[in]       index: Record index from beginning of queue
+ * \param[in]       offset: Byte offset inside record
+ * \param[in]       data: New data
+ * \param[in]       len: Number of bytes to write
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+ram_update(void* arg, size_t index, size_t offset, const void* data, size_t len) {
+    gsm_mqtt_client_queue_ram_t* q = arg;
+    const uint8_t* d = data;
+    size_t pos = 0, rec_len;
+
+    if (index >= q->count) {
+        return gsmERR;
+    }
+    for (; index > 0; --index) {                /* Skip records in front */
+        pos += RAM_REC_HDR_LEN + ram_rec_len(q, pos);
+    }
+    rec_len = ram_rec_len(q, pos);
+    if (offset > rec_len || len > rec_len - offset) {
+        return gsmERR;
+    }
+    pos += RAM_REC_HDR_LEN + offset;
+    for (size_t i = 0; i < len; ++i) {
+        q->buff.buff[(q->buff.r + pos + i) % q->buff.size] = d[i];
+    }
+    return gsmOK;
+}
+
+/**
+ * \brief           Get number of records in RAM queue
+ * \param[in]       arg: RAM queue
+ * \return          Number of records
+ */
+static size_t
+ram_get_count(void* arg) {
+    return ((gsm_mqtt_client_queue_ram_t *)arg)->count;
+}
+
+/**
+ * \brief           RAM ring buffer storage operations
+ *
+ * Use \ref gsm_mqtt_client_queue_ram_t object, initialized with \ref gsm_mqtt_client_queue_ram_init, as argument
+ */
+const gsm_mqtt_client_queue_ops_t
+gsm_mqtt_client_queue_ram_ops = {
+    .push = ram_push,
+    .read = ram_read,
+    .remove = ram_remove,
+    .update = ram_update,
+    .get_count = ram_get_count,
+};
+
+/**
+ * \brief           Initialize RAM queue storage
+ * \param[in]       q: RAM queue to initialize
+ * \param[in]       size: Size of storage in units of bytes. Each record uses `2` bytes for length
+ *                      in addition to packet topic and payload
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gsm_mqtt_client_queue_ram_init(gsm_mqtt_client_queue_ram_t* q, size_t size) {
+    if (q == NULL) {
+        return 0;
+    }
+    q->count = 0;
+    return gsm_buff_init(&q->buff, size);
+}
+
+/**
+ * \brief           Free RAM queue storage
+ * \note            Queue must not be used by any client anymore
+ * \param[in]       q: RAM queue to free
+ */
+void
+gsm_mqtt_client_queue_ram_free(gsm_mqtt_client_queue_ram_t* q) {
+    if (q != NULL) {
+        gsm_buff_free(&q->buff);
+        q->count = 0;
+    }
+}
+
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__ */
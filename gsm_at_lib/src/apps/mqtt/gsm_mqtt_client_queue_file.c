@@ -0,0 +1,467 @@
+/**
+ * \file            gsm_mqtt_client_queue_file.c
+ * \brief           MQTT client offline queue file storage
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include <stdio.h>
+#include "gsm/apps/gsm_mqtt_client_queue.h"
+
+#if (GSM_CFG_MQTT_OFFLINE_QUEUE && GSM_CFG_MQTT_OFFLINE_QUEUE_FILE) || __DOXYGEN__
+
+/* File header: 4 bytes read position + 4 bytes record count, MSB first */
+#define FILE_HDR_LEN                    8
+
+/* Each record is prefixed with 2 bytes of length, MSB first */
+#define FILE_REC_HDR_LEN                2
+
+/* Bit in length prefix of record removed out of order, skipped on read */
+#define FILE_REC_REMOVED                0x8000
+
+/**
+ * \brief           Write file header with current read position and count
+ * \param[in]       q: File queue
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+file_write_hdr(gsm_mqtt_client_queue_file_t* q) {
+    uint8_t b[FILE_HDR_LEN];
+
+    for (size_t i = 0; i < 4; ++i) {
+        b[i] = GSM_U8(q->read_pos >> (24 - 8 * i));
+        b[4 + i] = GSM_U8(q->count >> (24 - 8 * i));
+    }
+    if (fseek(q->file, 0, SEEK_SET) != 0
+        || fwrite(b, 1, sizeof(b), q->file) != sizeof(b)) {
+        return 0;
+    }
+    return fflush(q->file) == 0;
+}
+
+/**
+ * \brief           Empty file and write fresh header
+ * \param[in]       q: File queue
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+file_truncate(gsm_mqtt_client_queue_file_t* q) {
+    q->file = freopen(q->path, "w+b", q->file);
+    if (q->file == NULL) {
+        return 0;
+    }
+    q->read_pos = q->write_pos = FILE_HDR_LEN;
+    q->count = 0;
+    q->removed_len = 0;
+    return file_write_hdr(q);
+}
+
+/**
+ * \brief           Get length of record at specific file position
+ * \param[in]       q: File queue
+ * \param[in]       pos: Absolute file position of record
+ * \param[out]      removed: Set to `1` when record was removed out of order. Set to `NULL` if not used
+ * \return          Record length, excluding length prefix
+ */
+static size_t
+file_rec_len(gsm_mqtt_client_queue_file_t* q, uint32_t pos, uint8_t* removed) {
+    uint8_t b[FILE_REC_HDR_LEN];
+    size_t len = 0;
+
+    if (fseek(q->file, (long)pos, SEEK_SET) == 0
+        && fread(b, 1, sizeof(b), q->file) == sizeof(b)) {
+        len = (GSM_SZ(b[0]) << 8) | GSM_SZ(b[1]);
+    }
+    if (removed != NULL) {
+        *removed = GSM_U8((len & FILE_REC_REMOVED) > 0);
+    }
+    return len & ~GSM_SZ(FILE_REC_REMOVED);
+}
+
+/**
+ * \brief           Get file position of record, skipping records removed out of order
+ * \param[in]       q: File queue
+ * \param[in]       pos: Absolute file position to start search from
+ * \param[in]       index: Index of record not removed, counted from `pos`
+ * \return          Absolute file position of record
+ */
+static uint32_t
+file_rec_pos(gsm_mqtt_client_queue_file_t* q, uint32_t pos, size_t index) {
+    size_t len;
+    uint8_t removed;
+
+    while (pos < q->write_pos) {
+        len = file_rec_len(q, pos, &removed);
+        if (!removed) {
+            if (index == 0) {
+                break;
+            }
+            --index;
+        }
+        pos += FILE_REC_HDR_LEN + len;
+    }
+    return pos;
+}
+
+/**
+ * \brief           Rewrite file with complete records only
+ *
+ * Standard library cannot shorten opened file, records not removed yet are copied
+ * to temporary file and back to emptied queue file
+ *
+ * \param[in]       q: File queue
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+file_compact(gsm_mqtt_client_queue_file_t* q) {
+    FILE* tmp;
+    uint8_t b[64];
+    uint32_t len = 0, count = q->count, rec_len;
+    size_t l;
+    uint8_t ok = 1, removed;
+
+    if ((tmp = tmpfile()) == NULL) {
+        return 0;
+    }
+    for (uint32_t pos = q->read_pos; ok && pos < q->write_pos; pos += rec_len) {
+        rec_len = FILE_REC_HDR_LEN + GSM_U32(file_rec_len(q, pos, &removed));
+        if (removed) {
+            continue;
+        }
+        ok = fseek(q->file, (long)pos, SEEK_SET) == 0;
+        for (uint32_t i = 0; ok && i < rec_len; i += GSM_U32(l)) {
+            l = GSM_MIN(sizeof(b), GSM_SZ(rec_len - i));
+            ok = fread(b, 1, l, q->file) == l && fwrite(b, 1, l, tmp) == l;
+        }
+        len += rec_len;
+    }
+    if (ok) {
+        rewind(tmp);
+        ok = file_truncate(q) && fseek(q->file, FILE_HDR_LEN, SEEK_SET) == 0;
+        for (uint32_t i = 0; ok && i < len; i += GSM_U32(l)) {
+            l = GSM_MIN(sizeof(b), GSM_SZ(len - i));
+            ok = fread(b, 1, l, tmp) == l && fwrite(b, 1, l, q->file) == l;
+        }
+        if (ok) {
+            q->write_pos = FILE_HDR_LEN + len;
+            q->count = count;
+            ok = file_write_hdr(q);
+        }
+    }
+    fclose(tmp);
+    return ok;
+}
+
+/**
+ * \brief           Check records after file was opened and drop incomplete ones
+ *
+ * Record count in header is updated only after record was completely written,
+ * records beyond it, or cut by end of file, are partially written and removed
+ *
+ * \param[in]       q: File queue with header read from file
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+file_recover(gsm_mqtt_client_queue_file_t* q) {
+    uint32_t pos = q->read_pos, size, count = 0, removed_len = 0;
+    size_t len;
+    long end;
+    uint8_t removed;
+
+    if (fseek(q->file, 0, SEEK_END) != 0 || (end = ftell(q->file)) < 0) {
+        return 0;
+    }
+    size = GSM_U32(end);
+    q->write_pos = size;                        /* Allow reading up to end of file */
+    while (count < q->count && pos < size && (size - pos) >= FILE_REC_HDR_LEN) {
+        len = file_rec_len(q, pos, &removed);
+        if ((size - pos - FILE_REC_HDR_LEN) < len) {
+            break;                              /* Record is cut by end of file */
+        }
+        pos += FILE_REC_HDR_LEN + GSM_U32(len);
+        if (removed) {
+            removed_len += FILE_REC_HDR_LEN + GSM_U32(len);
+        } else {
+            ++count;
+            q->write_pos = pos;
+            q->removed_len += removed_len;      /* Removed records in front of complete one stay in file */
+            removed_len = 0;
+        }
+    }
+    if (count == 0) {
+        return file_truncate(q);
+    }
+    if (count == q->count && q->write_pos == size) {
+        return 1;                               /* File is consistent */
+    }
+    GSM_DEBUGF(GSM_CFG_DBG_MQTT | GSM_DBG_TYPE_TRACE | GSM_DBG_LVL_WARNING,
+        "[MQTT] Offline queue file recovered with %d complete records\r\n", (int)count);
+    q->count = count;
+    if (q->write_pos != size) {
+        return file_compact(q);                 /* Cut partially written data */
+    }
+    return file_write_hdr(q);
+}
+
+/**
+ * \brief           Store new record to file queue
+ * \param[in]       arg: File queue
+ * \param[in]       chunks: Array of record chunks
+ * \param[in]       chunks_cnt: Number of chunks
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+file_push(void* arg, const gsm_mqtt_client_queue_chunk_t* chunks, size_t chunks_cnt) {
+    gsm_mqtt_client_queue_file_t* q = arg;
+    uint8_t b[FILE_REC_HDR_LEN];
+    size_t len = 0;
+
+    for (size_t i = 0; i < chunks_cnt; ++i) {
+        len += chunks[i].len;
+    }
+    if (q->file == NULL || len >= FILE_REC_REMOVED) {
+        return gsmERRMEM;
+    }
+
+    /* Write after last complete record, overwriting data of failed write */
+    b[0] = GSM_U8(len >> 8);
+    b[1] = GSM_U8(len);
+    if (fseek(q->file, (long)q->write_pos, SEEK_SET) != 0
+        || fwrite(b, 1, sizeof(b), q->file) != sizeof(b)) {
+        return gsmERRMEM;
+    }
+    for (size_t i = 0; i < chunks_cnt; ++i) {
+        if (chunks[i].len > 0 && fwrite(chunks[i].data, 1, chunks[i].len, q->file) != chunks[i].len) {
+            return gsmERRMEM;
+        }
+    }
+
+    /* Count is updated last, partially written record is ignored after restart */
+    ++q->count;
+    if (!file_write_hdr(q)) {
+        --q->count;
+        return gsmERRMEM;
+    }
+    q->write_pos += GSM_U32(FILE_REC_HDR_LEN + len);
+    return gsmOK;
+}
+
+/**
+ * \brief           Read part of record from file queue
+ * \param[in]       arg: File queue
+ * \param[in]       index: Record index from beginning of queue
+ * \param[in]       offset: Byte offset inside record
+ * \param[out]      data: Output memory
+ * \param[in]       len: Number of bytes to read
+ * \return          Number of bytes copied to output memory
+ */
+static size_t
+file_read(void* arg, size_t index, size_t offset, void* data, size_t len) {
+    gsm_mqtt_client_queue_file_t* q = arg;
+    uint32_t pos;
+    size_t rec_len;
+
+    if (q->file == NULL || index >= q->count) {
+        return 0;
+    }
+    pos = file_rec_pos(q, q->read_pos, index);
+    rec_len = file_rec_len(q, pos, NULL);
+    if (offset >= rec_len) {
+        return 0;
+    }
+    len = GSM_MIN(len, rec_len - offset);
+    if (fseek(q->file, (long)(pos + FILE_REC_HDR_LEN + offset), SEEK_SET) != 0) {
+        return 0;
+    }
+    return fread(data, 1, len, q->file);
+}
+
+/**
+ * \brief           Remove record from file queue
+ *
+ * First record is removed by moving read position, other records are marked as removed
+ * in their length prefix. Mark is written before header, in case of power loss
+ * header count is corrected when file is opened again
+ *
+ * \param[in]       arg: File queue
+ * \param[in]       index: Record index from beginning of queue
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+file_remove(void* arg, size_t index) {
+    gsm_mqtt_client_queue_file_t* q = arg;
+    uint8_t b[FILE_REC_HDR_LEN];
+    uint32_t pos;
+    size_t len;
+
+    if (q->file == NULL || index >= q->count) {
+        return gsmERR;
+    }
+    if (q->count == 1) {                        /* Last record, start with empty file */
+        return file_truncate(q) ? gsmOK : gsmERR;
+    }
+    pos = file_rec_pos(q, q->read_pos, index);
+    len = file_rec_len(q, pos, NULL);
+    if (index == 0) {                           /* Move to next record not removed yet */
+        pos += FILE_REC_HDR_LEN + GSM_U32(len);
+        q->read_pos = file_rec_pos(q, pos, 0);
+        q->removed_len -= q->read_pos - pos;    /* Skipped records are in front of read position now */
+    } else {
+        b[0] = GSM_U8((len | FILE_REC_REMOVED) >> 8);
+        b[1] = GSM_U8(len);
+        if (fseek(q->file, (long)pos, SEEK_SET) != 0
+            || fwrite(b, 1, sizeof(b), q->file) != sizeof(b)) {
+            return gsmERR;
+        }
+        q->removed_len += FILE_REC_HDR_LEN + GSM_U32(len);
+    }
+    --q->count;
+    if (!file_write_hdr(q)) {
+        return gsmERR;
+    }
+
+    /* Drop removed records when they take more space than remaining ones */
+    len = (q->read_pos - FILE_HDR_LEN) + q->removed_len;
+    if (len >= GSM_CFG_MQTT_OFFLINE_QUEUE_FILE_COMPACT
+        && len >= (q->write_pos - q->read_pos - q->removed_len)) {
+        return file_compact(q) ? gsmOK : gsmERR;
+    }
+    return gsmOK;
+}
+
+/**
+ * \brief           Overwrite part of record in file queue
+ * \param[in]       arg: File queue
+ * \param[in]       index: Record index from beginning of queue
+ * \param[in]       offset: Byte offset inside record
+ * \param[in]       data: New data
+ * \param[in]       len: Number of bytes to write
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+file_update(void* arg, size_t index, size_t offset, const void* data, size_t len) {
+    gsm_mqtt_client_queue_file_t* q = arg;
+    uint32_t pos;
+    size_t rec_len;
+
+    if (q->file == NULL || index >= q->count) {
+        return gsmERR;
+    }
+    pos = file_rec_pos(q, q->read_pos, index);
+    rec_len = file_rec_len(q, pos, NULL);
+    if (offset > rec_len || len > rec_len - offset) {
+        return gsmERR;
+    }
+    if (fseek(q->file, (long)(pos + FILE_REC_HDR_LEN + offset), SEEK_SET) != 0
+        || fwrite(data, 1, len, q->file) != len) {
+        return gsmERR;
+    }
+    return fflush(q->file) == 0 ? gsmOK : gsmERR;
+}
+
+/**
+ * \brief           Get number of records in file queue
+ * \param[in]       arg: File queue
+ * \return          Number of records
+ */
+static size_t
+file_get_count(void* arg) {
+    return ((gsm_mqtt_client_queue_file_t *)arg)->count;
+}
+
+/**
+ * \brief           File storage operations
+ *
+ * Use \ref gsm_mqtt_client_queue_file_t object, opened with \ref gsm_mqtt_client_queue_file_open, as argument
+ */
+const gsm_mqtt_client_queue_ops_t
+gsm_mqtt_client_queue_file_ops = {
+    .push = file_push,
+    .read = file_read,
+    .remove = file_remove,
+    .update = file_update,
+    .get_count = file_get_count,
+};
+
+/**
+ * \brief           Open file queue storage
+ *
+ * Records left in file from previous run are kept and replayed on next connect.
+ * Record partially written before power loss is removed from file
+ *
+ * \param[in]       q: File queue to open
+ * \param[in]       path: Path to file. Memory must stay valid until queue is closed
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gsm_mqtt_client_queue_file_open(gsm_mqtt_client_queue_file_t* q, const char* path) {
+    uint8_t b[FILE_HDR_LEN];
+
+    if (q == NULL || path == NULL) {
+        return 0;
+    }
+    q->path = path;
+    q->removed_len = 0;
+    q->file = fopen(path, "r+b");
+    if (q->file != NULL) {
+        if (fread(b, 1, sizeof(b), q->file) == sizeof(b)) {
+            q->read_pos = q->count = 0;
+            for (size_t i = 0; i < 4; ++i) {
+                q->read_pos = (q->read_pos << 8) | b[i];
+                q->count = (q->count << 8) | b[4 + i];
+            }
+            if (q->read_pos >= FILE_HDR_LEN) {
+                return file_recover(q);
+            }
+        }
+        fclose(q->file);                        /* Invalid file, start from scratch */
+    }
+    q->file = fopen(path, "w+b");
+    if (q->file == NULL) {
+        return 0;
+    }
+    q->read_pos = q->write_pos = FILE_HDR_LEN;
+    q->count = 0;
+    return file_write_hdr(q);
+}
+
+/**
+ * \brief           Close file queue storage
+ * \note            Queue must not be used by any client anymore
+ * \param[in]       q: File queue to close
+ */
+void
+gsm_mqtt_client_queue_file_close(gsm_mqtt_client_queue_file_t* q) {
+    if (q != NULL && q->file != NULL) {
+        fclose(q->file);
+        q->file = NULL;
+    }
+}
+
+#endif /* (GSM_CFG_MQTT_OFFLINE_QUEUE && GSM_CFG_MQTT_OFFLINE_QUEUE_FILE) || __DOXYGEN__ */
@@ -0,0 +1,1295 @@
+/**
+ * \file            gsm_mqtt_sn_client.c
+ * \brief           MQTT-SN client over UDP connection
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include "gsm/apps/gsm_mqtt_sn_client.h"
+#include "gsm/gsm_mem.h"
+#include "gsm/gsm_pbuf.h"
+
+/**
+ * \brief           Registered topic entry
+ */
+typedef struct {
+    char* name;                                 /*!< Allocated copy of topic name. Set to `NULL` when entry is not used */
+    uint16_t id;                                /*!< Topic ID assigned by gateway */
+} mqtt_sn_topic_t;
+
+/**
+ * \brief           MQTT-SN client connection
+ */
+typedef struct gsm_mqtt_sn_client {
+    gsm_conn_p conn;                            /*!< Active UDP connection to gateway */
+    const gsm_mqtt_sn_client_info_t* info;      /*!< Connection info */
+    gsm_mqtt_sn_state_t state;                  /*!< Client state */
+
+    gsm_mqtt_sn_evt_t evt;                      /*!< MQTT-SN event callback */
+    gsm_mqtt_sn_evt_fn evt_fn;                  /*!< Event callback function */
+
+    uint8_t* tx_buff;                           /*!< Request waiting for gateway reply, kept for retransmission */
+    size_t tx_buff_len;                         /*!< Length of request buffer */
+    size_t tx_len;                              /*!< Length of request in buffer. Set to `0` when there is no request */
+    uint8_t req_reply;                          /*!< Message type expected from gateway as reply to request */
+    uint16_t req_msg_id;                        /*!< Message ID of request */
+    uint8_t req_retries;                        /*!< Number of retransmissions of request */
+    uint32_t req_time;                          /*!< Time in units of milliseconds when request was last sent */
+    void* req_arg;                              /*!< User argument of request */
+
+    uint8_t* rx_buff;                           /*!< Buffer for received datagram */
+    size_t rx_buff_len;                         /*!< Length of receive buffer */
+
+    uint16_t last_msg_id;                       /*!< Last used message ID */
+    uint32_t last_tx_time;                      /*!< Time in units of milliseconds of last packet sent to gateway */
+
+    mqtt_sn_topic_t topics[GSM_CFG_MQTT_SN_MAX_TOPICS]; /*!< Topic names with IDs assigned by gateway */
+
+    void* arg;                                  /*!< User argument */
+} gsm_mqtt_sn_client_t;
+
+/* Tracing debug message */
+#define GSM_CFG_DBG_MQTT_SN_TRACE               (GSM_CFG_DBG_MQTT_SN | GSM_DBG_TYPE_TRACE)
+#define GSM_CFG_DBG_MQTT_SN_STATE               (GSM_CFG_DBG_MQTT_SN | GSM_DBG_TYPE_STATE)
+#define GSM_CFG_DBG_MQTT_SN_TRACE_WARNING       (GSM_CFG_DBG_MQTT_SN | GSM_DBG_TYPE_TRACE | GSM_DBG_LVL_WARNING)
+
+/**
+ * \brief           List of MQTT-SN message types
+ */
+typedef enum {
+    MQTT_SN_MSG_TYPE_ADVERTISE =    0x00,       /*!< Gateway advertisement */
+    MQTT_SN_MSG_TYPE_SEARCHGW =     0x01,       /*!< Search for gateway */
+    MQTT_SN_MSG_TYPE_GWINFO =       0x02,       /*!< Gateway information */
+    MQTT_SN_MSG_TYPE_CONNECT =      0x04,       /*!< Client requests a connection to gateway */
+    MQTT_SN_MSG_TYPE_CONNACK =      0x05,       /*!< Acknowledge connection request */
+    MQTT_SN_MSG_TYPE_REGISTER =     0x0A,       /*!< Register topic name */
+    MQTT_SN_MSG_TYPE_REGACK =       0x0B,       /*!< Register acknowledgement */
+    MQTT_SN_MSG_TYPE_PUBLISH =      0x0C,       /*!< Publish message */
+    MQTT_SN_MSG_TYPE_PUBACK =       0x0D,       /*!< Publish acknowledgement */
+    MQTT_SN_MSG_TYPE_PUBCOMP =      0x0E,       /*!< Publish complete */
+    MQTT_SN_MSG_TYPE_PUBREC =       0x0F,       /*!< Publish received */
+    MQTT_SN_MSG_TYPE_PUBREL =       0x10,       /*!< Publish release */
+    MQTT_SN_MSG_TYPE_SUBSCRIBE =    0x12,       /*!< Subscribe to topic */
+    MQTT_SN_MSG_TYPE_SUBACK =       0x13,       /*!< Subscribe acknowledgement */
+    MQTT_SN_MSG_TYPE_UNSUBSCRIBE =  0x14,       /*!< Unsubscribe from topic */
+    MQTT_SN_MSG_TYPE_UNSUBACK =     0x15,       /*!< Unsubscribe acknowledgement */
+    MQTT_SN_MSG_TYPE_PINGREQ =      0x16,       /*!< Ping request */
+    MQTT_SN_MSG_TYPE_PINGRESP =     0x17,       /*!< Ping response */
+    MQTT_SN_MSG_TYPE_DISCONNECT =   0x18,       /*!< Disconnect notification */
+} mqtt_sn_msg_type_t;
+
+/* List of flags in flags field */
+#define MQTT_SN_FLAG_DUP                0x80
+#define MQTT_SN_FLAG_QOS(qos)           ((GSM_U8(qos) & 0x03) << 5)
+#define MQTT_SN_FLAG_RETAIN             0x10
+#define MQTT_SN_FLAG_CLEAN_SESSION      0x04
+#define MQTT_SN_FLAG_TOPIC_TYPE(type)   (GSM_U8(type) & 0x03)
+
+/* Get values from flags field */
+#define MQTT_SN_GET_QOS(flags)          ((gsm_mqtt_sn_qos_t)(((flags) >> 5) & 0x03))
+#define MQTT_SN_GET_TOPIC_TYPE(flags)   ((gsm_mqtt_sn_topic_type_t)((flags) & 0x03))
+
+/* Protocol ID of MQTT-SN v1.2 */
+#define MQTT_SN_PROTOCOL_ID             0x01
+
+/* Get 2-byte value from buffer, MSB first */
+#define MQTT_SN_GET_U16(d)              GSM_U16((GSM_U16((d)[0]) << 8) | GSM_U16((d)[1]))
+
+static gsmr_t   mqtt_sn_conn_cb(gsm_evt_t* evt);
+
+/**
+ * \brief           Default event callback function
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       evt: Event
+ */
+static void
+mqtt_sn_evt_fn_default(gsm_mqtt_sn_client_p client, gsm_mqtt_sn_evt_t* evt) {
+    GSM_UNUSED(client);
+    GSM_UNUSED(evt);
+}
+
+/**
+ * \brief           Create new message ID
+ * \param[in]       client: MQTT-SN client
+ * \return          New message ID
+ */
+static uint16_t
+create_msg_id(gsm_mqtt_sn_client_p client) {
+    if (++client->last_msg_id == 0) {
+        client->last_msg_id = 1;
+    }
+    return client->last_msg_id;
+}
+
+/**
+ * \brief           Write message header
+ *
+ * Length field uses `1` byte for messages up to `255` bytes or `3` bytes otherwise
+ *
+ * \param[out]      d: Output memory
+ * \param[in]       type: Message type
+ * \param[in]       len: Length of message, excluding length and message type fields
+ * \return          Number of bytes written
+ */
+static size_t
+write_hdr(uint8_t* d, mqtt_sn_msg_type_t type, size_t len) {
+    if (len + 2 <= 0xFF) {
+        d[0] = GSM_U8(len + 2);
+        d[1] = GSM_U8(type);
+        return 2;
+    }
+    len += 4;
+    d[0] = 0x01;
+    d[1] = GSM_U8(len >> 8);
+    d[2] = GSM_U8(len);
+    d[3] = GSM_U8(type);
+    return 4;
+}
+
+/**
+ * \brief           Write 2-byte value, MSB first
+ * \param[out]      d: Output memory
+ * \param[in]       num: Value to write
+ */
+static void
+write_u16(uint8_t* d, uint16_t num) {
+    d[0] = GSM_U8(num >> 8);
+    d[1] = GSM_U8(num);
+}
+
+/**
+ * \brief           Write data to UDP connection, one call per datagram part
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       data: Data to write
+ * \param[in]       len: Length of data
+ * \param[in]       flush: Set to `1` on last part of datagram
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+send_part(gsm_mqtt_sn_client_p client, const void* data, size_t len, uint8_t flush) {
+    client->last_tx_time = gsm_sys_now();
+    return gsm_conn_write(client->conn, data, len, flush, NULL);
+}
+
+/**
+ * \brief           Get length of request header in request buffer
+ * \param[in]       client: MQTT-SN client
+ * \return          Header length, including message type
+ */
+static size_t
+request_hdr_len(gsm_mqtt_sn_client_p client) {
+    return client->tx_buff[0] == 0x01 ? 4 : 2;
+}
+
+/**
+ * \brief           Get length of request data after message type
+ * \param[in]       client: MQTT-SN client
+ * \return          Length of request data
+ */
+static size_t
+request_body_len(gsm_mqtt_sn_client_p client) {
+    return client->tx_len - request_hdr_len(client);
+}
+
+/**
+ * \brief           Prepare new request in request buffer
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       type: Message type
+ * \param[in]       len: Length of message, excluding length and message type fields
+ * \return          Pointer to write message data to or `NULL` if not enough memory
+ */
+static uint8_t *
+request_prepare(gsm_mqtt_sn_client_p client, mqtt_sn_msg_type_t type, size_t len) {
+    size_t hdr_len = len + 2 <= 0xFF ? 2 : 4;
+
+    if ((hdr_len + len) > client->tx_buff_len || (hdr_len + len) > GSM_CFG_CONN_MAX_DATA_LEN) {
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_SN_TRACE_WARNING, "[MQTT-SN] Not enough memory for request\r\n");
+        return NULL;
+    }
+    hdr_len = write_hdr(client->tx_buff, type, len);
+    client->tx_len = hdr_len + len;
+    return &client->tx_buff[hdr_len];
+}
+
+/**
+ * \brief           Send prepared request and start waiting for gateway reply
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       reply: Expected reply message type
+ * \param[in]       msg_id: Message ID of request or `0` if not used
+ * \param[in]       arg: User argument
+ */
+static void
+request_send(gsm_mqtt_sn_client_p client, mqtt_sn_msg_type_t reply, uint16_t msg_id, void* arg) {
+    client->req_reply = GSM_U8(reply);
+    client->req_msg_id = msg_id;
+    client->req_arg = arg;
+    client->req_retries = 0;
+    client->req_time = gsm_sys_now();
+    send_part(client, client->tx_buff, client->tx_len, 1);
+}
+
+/**
+ * \brief           Check if reply matches pending request
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       reply: Received message type
+ * \param[in]       msg_id: Received message ID or `0` if not used
+ * \return          `1` if it matches, `0` otherwise
+ */
+static uint8_t
+request_match(gsm_mqtt_sn_client_p client, mqtt_sn_msg_type_t reply, uint16_t msg_id) {
+    return client->tx_len > 0 && client->req_reply == GSM_U8(reply) && client->req_msg_id == msg_id;
+}
+
+/**
+ * \brief           Find registered topic by name
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       name: Topic name
+ * \param[in]       len: Length of topic name
+ * \return          Topic entry or `NULL` if not found
+ */
+static mqtt_sn_topic_t *
+topic_find_name(gsm_mqtt_sn_client_p client, const char* name, size_t len) {
+    for (size_t i = 0; i < GSM_CFG_MQTT_SN_MAX_TOPICS; ++i) {
+        if (client->topics[i].name != NULL
+            && !strncmp(client->topics[i].name, name, len) && client->topics[i].name[len] == '\0') {
+            return &client->topics[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Find registered topic by ID
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       id: Topic ID
+ * \return          Topic entry or `NULL` if not found
+ */
+static mqtt_sn_topic_t *
+topic_find_id(gsm_mqtt_sn_client_p client, uint16_t id) {
+    for (size_t i = 0; i < GSM_CFG_MQTT_SN_MAX_TOPICS; ++i) {
+        if (client->topics[i].name != NULL && client->topics[i].id == id) {
+            return &client->topics[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Add topic name with ID assigned by gateway or update ID of existing entry
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       name: Topic name, not `NULL` terminated
+ * \param[in]       len: Length of topic name
+ * \param[in]       id: Topic ID
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+topic_add(gsm_mqtt_sn_client_p client, const char* name, size_t len, uint16_t id) {
+    mqtt_sn_topic_t* t;
+
+    if ((t = topic_find_name(client, name, len)) != NULL) {
+        t->id = id;
+        return 1;
+    }
+    for (size_t i = 0; i < GSM_CFG_MQTT_SN_MAX_TOPICS; ++i) {
+        t = &client->topics[i];
+        if (t->name == NULL) {
+            if ((t->name = gsm_mem_malloc(len + 1)) == NULL) {
+                return 0;
+            }
+            GSM_MEMCPY(t->name, name, len);
+            t->name[len] = '\0';
+            t->id = id;
+            return 1;
+        }
+    }
+    GSM_DEBUGF(GSM_CFG_DBG_MQTT_SN_TRACE_WARNING, "[MQTT-SN] No free entry for topic %.*s\r\n", (int)len, name);
+    return 0;
+}
+
+/**
+ * \brief           Remove all registered topics, they are valid for single connection only
+ * \param[in]       client: MQTT-SN client
+ */
+static void
+topic_reset(gsm_mqtt_sn_client_p client) {
+    for (size_t i = 0; i < GSM_CFG_MQTT_SN_MAX_TOPICS; ++i) {
+        gsm_mem_free_s((void **)&client->topics[i].name);
+    }
+}
+
+/**
+ * \brief           Close UDP connection with gateway
+ * \param[in]       client: MQTT-SN client
+ */
+static void
+mqtt_sn_close(gsm_mqtt_sn_client_p client) {
+    if (client->conn != NULL && client->state != GSM_MQTT_SN_STATE_CLOSED
+        && client->state != GSM_MQTT_SN_STATE_OPENING) {
+        gsm_conn_close(client->conn, 0);        /* Close the connection in non-blocking mode */
+    }
+}
+
+/**
+ * \brief           Finish pending request without gateway reply and notify user
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       res: Result for user
+ * \param[in]       rc: Return code for user
+ */
+static void
+request_fail(gsm_mqtt_sn_client_p client, gsmr_t res, gsm_mqtt_sn_rc_t rc) {
+    if (client->tx_len == 0) {
+        return;
+    }
+    client->tx_len = 0;                         /* Request is finished */
+    switch ((mqtt_sn_msg_type_t)client->tx_buff[request_hdr_len(client) - 1]) {
+        case MQTT_SN_MSG_TYPE_CONNECT: {
+            client->state = GSM_MQTT_SN_STATE_OPEN;
+            client->evt.type = GSM_MQTT_SN_EVT_CONNECT;
+            client->evt.evt.connect.rc = rc;
+            break;
+        }
+        case MQTT_SN_MSG_TYPE_REGISTER: {
+            client->evt.type = GSM_MQTT_SN_EVT_REGISTER;
+            client->evt.evt.reg.arg = client->req_arg;
+            client->evt.evt.reg.res = res;
+            client->evt.evt.reg.rc = rc;
+            client->evt.evt.reg.topic_id = 0;
+            break;
+        }
+        case MQTT_SN_MSG_TYPE_SUBSCRIBE:
+        case MQTT_SN_MSG_TYPE_UNSUBSCRIBE: {
+            client->evt.type = client->req_reply == MQTT_SN_MSG_TYPE_SUBACK ? GSM_MQTT_SN_EVT_SUBSCRIBE : GSM_MQTT_SN_EVT_UNSUBSCRIBE;
+            client->evt.evt.sub_unsub_scribed.arg = client->req_arg;
+            client->evt.evt.sub_unsub_scribed.res = res;
+            client->evt.evt.sub_unsub_scribed.rc = rc;
+            client->evt.evt.sub_unsub_scribed.topic_id = 0;
+            client->evt.evt.sub_unsub_scribed.qos = GSM_MQTT_SN_QOS_AT_MOST_ONCE;
+            break;
+        }
+        case MQTT_SN_MSG_TYPE_PUBLISH: {
+            client->evt.type = GSM_MQTT_SN_EVT_PUBLISH;
+            client->evt.evt.publish.arg = client->req_arg;
+            client->evt.evt.publish.res = res;
+            client->evt.evt.publish.rc = rc;
+            break;
+        }
+        default:
+            return;                             /* Internal requests, user is not notified */
+    }
+    client->evt_fn(client, &client->evt);
+}
+
+/**
+ * \brief           Send CONNECT message to gateway
+ * \param[in]       client: MQTT-SN client
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+send_connect(gsm_mqtt_sn_client_p client) {
+    uint8_t* d;
+    size_t len_id;
+
+    len_id = strlen(client->info->id);
+
+    /* Flags (1) + protocol ID (1) + duration (2) + client ID */
+    if ((d = request_prepare(client, MQTT_SN_MSG_TYPE_CONNECT, 4 + len_id)) == NULL) {
+        return gsmERRMEM;
+    }
+    d[0] = client->info->keep_session ? 0 : MQTT_SN_FLAG_CLEAN_SESSION;
+    d[1] = MQTT_SN_PROTOCOL_ID;
+    write_u16(&d[2], client->info->keep_alive);
+    GSM_MEMCPY(&d[4], client->info->id, len_id);
+
+    client->state = GSM_MQTT_SN_STATE_CONNECTING;
+    request_send(client, MQTT_SN_MSG_TYPE_CONNACK, 0, NULL);
+
+    GSM_DEBUGF(GSM_CFG_DBG_MQTT_SN_STATE, "[MQTT-SN] CONNECT sent\r\n");
+    return gsmOK;
+}
+
+/**
+ * \brief           Send acknowledge with topic ID, message ID and return code
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       type: Message type, either `REGACK` or `PUBACK`
+ * \param[in]       topic_id: Topic ID
+ * \param[in]       msg_id: Message ID
+ * \param[in]       rc: Return code
+ */
+static void
+send_ack(gsm_mqtt_sn_client_p client, mqtt_sn_msg_type_t type, uint16_t topic_id, uint16_t msg_id, gsm_mqtt_sn_rc_t rc) {
+    uint8_t d[7];
+
+    write_hdr(d, type, 5);
+    write_u16(&d[2], topic_id);
+    write_u16(&d[4], msg_id);
+    d[6] = GSM_U8(rc);
+    send_part(client, d, sizeof(d), 1);
+}
+
+/**
+ * \brief           Process received PUBLISH message
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       d: Message data after message type
+ * \param[in]       len: Length of message data
+ */
+static void
+process_publish(gsm_mqtt_sn_client_p client, const uint8_t* d, size_t len) {
+    mqtt_sn_topic_t* t = NULL;
+    gsm_mqtt_sn_topic_type_t topic_type;
+    gsm_mqtt_sn_qos_t qos;
+    uint16_t topic_id, msg_id;
+
+    if (len < 5) {
+        return;
+    }
+    topic_type = MQTT_SN_GET_TOPIC_TYPE(d[0]);
+    qos = MQTT_SN_GET_QOS(d[0]);
+    topic_id = MQTT_SN_GET_U16(&d[1]);
+    msg_id = MQTT_SN_GET_U16(&d[3]);
+
+    /* Topic ID must be known for normal topics */
+    if (topic_type == GSM_MQTT_SN_TOPIC_NORMAL && (t = topic_find_id(client, topic_id)) == NULL) {
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_SN_TRACE_WARNING,
+            "[MQTT-SN] Publish received on unknown topic ID %d\r\n", (int)topic_id);
+        if (qos == GSM_MQTT_SN_QOS_AT_LEAST_ONCE) {
+            send_ack(client, MQTT_SN_MSG_TYPE_PUBACK, topic_id, msg_id, GSM_MQTT_SN_RC_REJECTED_INVALID_TOPIC);
+        }
+        return;
+    }
+    if (qos == GSM_MQTT_SN_QOS_AT_LEAST_ONCE) {
+        send_ack(client, MQTT_SN_MSG_TYPE_PUBACK, topic_id, msg_id, GSM_MQTT_SN_RC_ACCEPTED);
+    }
+
+    client->evt.type = GSM_MQTT_SN_EVT_PUBLISH_RECV;
+    client->evt.evt.publish_recv.topic_type = topic_type;
+    client->evt.evt.publish_recv.topic_id = topic_id;
+    client->evt.evt.publish_recv.topic = t != NULL ? t->name : NULL;
+    client->evt.evt.publish_recv.payload = &d[5];
+    client->evt.evt.publish_recv.payload_len = len - 5;
+    client->evt.evt.publish_recv.dup = GSM_U8((d[0] & MQTT_SN_FLAG_DUP) != 0);
+    client->evt.evt.publish_recv.qos = qos;
+    client->evt_fn(client, &client->evt);
+}
+
+/**
+ * \brief           Process single received datagram
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       data: Datagram data
+ * \param[in]       data_len: Length of datagram
+ */
+static void
+mqtt_sn_process(gsm_mqtt_sn_client_p client, const uint8_t* data, size_t data_len) {
+    mqtt_sn_msg_type_t type;
+    const uint8_t* d;
+    size_t len, hdr_len;
+
+    /* Parse length field */
+    if (data_len < 2) {
+        return;
+    }
+    if (data[0] == 0x01) {
+        if (data_len < 4) {
+            return;
+        }
+        len = MQTT_SN_GET_U16(&data[1]);
+        hdr_len = 4;
+    } else {
+        len = data[0];
+        hdr_len = 2;
+    }
+    if (len < hdr_len || len > data_len) {
+        return;
+    }
+    type = (mqtt_sn_msg_type_t)data[hdr_len - 1];
+    d = &data[hdr_len];
+    len -= hdr_len;
+
+    GSM_DEBUGF(GSM_CFG_DBG_MQTT_SN_TRACE, "[MQTT-SN] Message type 0x%02X received\r\n", (unsigned)type);
+
+    switch (type) {
+        case MQTT_SN_MSG_TYPE_CONNACK: {
+            if (len < 1 || !request_match(client, type, 0)) {
+                break;
+            }
+            client->tx_len = 0;
+            client->state = d[0] == GSM_MQTT_SN_RC_ACCEPTED ? GSM_MQTT_SN_STATE_CONNECTED : GSM_MQTT_SN_STATE_OPEN;
+
+            client->evt.type = GSM_MQTT_SN_EVT_CONNECT;
+            client->evt.evt.connect.rc = (gsm_mqtt_sn_rc_t)d[0];
+            client->evt_fn(client, &client->evt);
+            break;
+        }
+        case MQTT_SN_MSG_TYPE_REGACK: {
+            const uint8_t* req;
+            uint16_t topic_id;
+
+            if (len < 5 || !request_match(client, type, MQTT_SN_GET_U16(&d[2]))) {
+                break;
+            }
+            topic_id = MQTT_SN_GET_U16(&d[0]);
+
+            /* Topic name is in REGISTER request, after topic ID and message ID */
+            req = &client->tx_buff[request_hdr_len(client)];
+            if (d[4] == GSM_MQTT_SN_RC_ACCEPTED) {
+                topic_add(client, (const char *)&req[4], request_body_len(client) - 4, topic_id);
+            }
+            client->tx_len = 0;
+
+            client->evt.type = GSM_MQTT_SN_EVT_REGISTER;
+            client->evt.evt.reg.arg = client->req_arg;
+            client->evt.evt.reg.res = d[4] == GSM_MQTT_SN_RC_ACCEPTED ? gsmOK : gsmERR;
+            client->evt.evt.reg.rc = (gsm_mqtt_sn_rc_t)d[4];
+            client->evt.evt.reg.topic_id = topic_id;
+            client->evt_fn(client, &client->evt);
+            break;
+        }
+        case MQTT_SN_MSG_TYPE_PUBACK: {
+            if (len < 5) {
+                break;
+            }
+            if (d[4] == GSM_MQTT_SN_RC_REJECTED_INVALID_TOPIC) {
+                mqtt_sn_topic_t* t;
+                if ((t = topic_find_id(client, MQTT_SN_GET_U16(&d[0]))) != NULL) {
+                    gsm_mem_free_s((void **)&t->name);  /* Gateway does not know it anymore, register again */
+                }
+            }
+            if (!request_match(client, type, MQTT_SN_GET_U16(&d[2]))) {
+                break;
+            }
+            client->tx_len = 0;
+
+            client->evt.type = GSM_MQTT_SN_EVT_PUBLISH;
+            client->evt.evt.publish.arg = client->req_arg;
+            client->evt.evt.publish.res = d[4] == GSM_MQTT_SN_RC_ACCEPTED ? gsmOK : gsmERR;
+            client->evt.evt.publish.rc = (gsm_mqtt_sn_rc_t)d[4];
+            client->evt_fn(client, &client->evt);
+            break;
+        }
+        case MQTT_SN_MSG_TYPE_SUBACK: {
+            const uint8_t* req;
+            uint16_t topic_id;
+
+            if (len < 6 || !request_match(client, type, MQTT_SN_GET_U16(&d[3]))) {
+                break;
+            }
+            topic_id = MQTT_SN_GET_U16(&d[1]);
+
+            /* Remember topic ID of normal topic name, gateway uses it when publishing */
+            req = &client->tx_buff[request_hdr_len(client)];
+            if (d[5] == GSM_MQTT_SN_RC_ACCEPTED && topic_id != 0
+                && MQTT_SN_GET_TOPIC_TYPE(req[0]) == GSM_MQTT_SN_TOPIC_NORMAL) {
+                topic_add(client, (const char *)&req[3], request_body_len(client) - 3, topic_id);
+            }
+            client->tx_len = 0;
+
+            client->evt.type = GSM_MQTT_SN_EVT_SUBSCRIBE;
+            client->evt.evt.sub_unsub_scribed.arg = client->req_arg;
+            client->evt.evt.sub_unsub_scribed.res = d[5] == GSM_MQTT_SN_RC_ACCEPTED ? gsmOK : gsmERR;
+            client->evt.evt.sub_unsub_scribed.rc = (gsm_mqtt_sn_rc_t)d[5];
+            client->evt.evt.sub_unsub_scribed.topic_id = topic_id;
+            client->evt.evt.sub_unsub_scribed.qos = MQTT_SN_GET_QOS(d[0]);
+            client->evt_fn(client, &client->evt);
+            break;
+        }
+        case MQTT_SN_MSG_TYPE_UNSUBACK: {
+            if (len < 2 || !request_match(client, type, MQTT_SN_GET_U16(&d[0]))) {
+                break;
+            }
+            client->tx_len = 0;
+
+            client->evt.type = GSM_MQTT_SN_EVT_UNSUBSCRIBE;
+            client->evt.evt.sub_unsub_scribed.arg = client->req_arg;
+            client->evt.evt.sub_unsub_scribed.res = gsmOK;
+            client->evt.evt.sub_unsub_scribed.rc = GSM_MQTT_SN_RC_ACCEPTED;
+            client->evt.evt.sub_unsub_scribed.topic_id = 0;
+            client->evt.evt.sub_unsub_scribed.qos = GSM_MQTT_SN_QOS_AT_MOST_ONCE;
+            client->evt_fn(client, &client->evt);
+            break;
+        }
+        case MQTT_SN_MSG_TYPE_REGISTER: {       /* Gateway registers topic before publishing on wildcard subscription */
+            uint16_t topic_id;
+
+            if (len < 5) {
+                break;
+            }
+            topic_id = MQTT_SN_GET_U16(&d[0]);
+            send_ack(client, MQTT_SN_MSG_TYPE_REGACK, topic_id, MQTT_SN_GET_U16(&d[2]),
+                topic_add(client, (const char *)&d[4], len - 4, topic_id) ? GSM_MQTT_SN_RC_ACCEPTED : GSM_MQTT_SN_RC_REJECTED_CONGESTION);
+            break;
+        }
+        case MQTT_SN_MSG_TYPE_PUBLISH: {
+            process_publish(client, d, len);
+            break;
+        }
+        case MQTT_SN_MSG_TYPE_PINGRESP: {
+            if (!request_match(client, type, 0)) {
+                break;
+            }
+            client->tx_len = 0;
+            if (client->state == GSM_MQTT_SN_STATE_AWAKE) {
+                client->state = GSM_MQTT_SN_STATE_ASLEEP;   /* All buffered messages received */
+                client->evt.type = GSM_MQTT_SN_EVT_WAKEUP;
+            } else {
+                client->evt.type = GSM_MQTT_SN_EVT_KEEP_ALIVE;
+            }
+            client->evt_fn(client, &client->evt);
+            break;
+        }
+        case MQTT_SN_MSG_TYPE_DISCONNECT: {
+            if (request_match(client, type, 0)) {
+                /* Sleep request includes duration */
+                if (request_body_len(client) >= 2) {
+                    client->tx_len = 0;
+                    client->state = GSM_MQTT_SN_STATE_ASLEEP;
+                    client->evt.type = GSM_MQTT_SN_EVT_SLEEP;
+                    client->evt_fn(client, &client->evt);
+                } else {
+                    client->tx_len = 0;
+                    mqtt_sn_close(client);      /* User disconnect finished */
+                }
+            } else if (client->state == GSM_MQTT_SN_STATE_CONNECTED
+                    || client->state == GSM_MQTT_SN_STATE_ASLEEP
+                    || client->state == GSM_MQTT_SN_STATE_AWAKE) {
+                /* Gateway dropped the client, UDP connection stays open */
+                request_fail(client, gsmCLOSED, GSM_MQTT_SN_RC_ACCEPTED);
+                client->state = GSM_MQTT_SN_STATE_OPEN;
+                topic_reset(client);
+                client->evt.type = GSM_MQTT_SN_EVT_DISCONNECT;
+                client->evt.evt.disconnect.is_accepted = 1;
+                client->evt_fn(client, &client->evt);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * \brief           Poll callback, retransmit request and send keep-alive
+ * \param[in]       client: MQTT-SN client
+ */
+static void
+mqtt_sn_poll_cb(gsm_mqtt_sn_client_p client) {
+    uint32_t now = gsm_sys_now();
+
+    if (client->tx_len > 0) {
+        if ((now - client->req_time) < GSM_CFG_MQTT_SN_RETRY_TIMEOUT) {
+            return;
+        }
+        if (client->req_retries < GSM_CFG_MQTT_SN_RETRY_COUNT) {
+            mqtt_sn_msg_type_t type = (mqtt_sn_msg_type_t)client->tx_buff[request_hdr_len(client) - 1];
+
+            /* Set duplicate flag on messages which have it */
+            if (type == MQTT_SN_MSG_TYPE_PUBLISH || type == MQTT_SN_MSG_TYPE_SUBSCRIBE) {
+                client->tx_buff[request_hdr_len(client)] |= MQTT_SN_FLAG_DUP;
+            }
+            ++client->req_retries;
+            client->req_time = now;
+            send_part(client, client->tx_buff, client->tx_len, 1);
+
+            GSM_DEBUGF(GSM_CFG_DBG_MQTT_SN_TRACE,
+                "[MQTT-SN] Request type 0x%02X sent again, retry %d\r\n", (unsigned)type, (int)client->req_retries);
+        } else {
+            GSM_DEBUGF(GSM_CFG_DBG_MQTT_SN_STATE, "[MQTT-SN] No reply from gateway, closing connection\r\n");
+
+            request_fail(client, gsmTIMEOUT, GSM_MQTT_SN_RC_TIMEOUT);
+            mqtt_sn_close(client);              /* Gateway is lost */
+        }
+        return;
+    }
+
+    /* Keep-alive is only sent by active client */
+    if (client->state == GSM_MQTT_SN_STATE_CONNECTED && client->info->keep_alive > 0
+        && (now - client->last_tx_time) >= (uint32_t)(client->info->keep_alive * 1000)) {
+        if (request_prepare(client, MQTT_SN_MSG_TYPE_PINGREQ, 0) != NULL) {
+            request_send(client, MQTT_SN_MSG_TYPE_PINGRESP, 0, NULL);
+            GSM_DEBUGF(GSM_CFG_DBG_MQTT_SN_TRACE, "[MQTT-SN] Sending PINGREQ\r\n");
+        }
+    }
+}
+
+/**
+ * \brief           Connection closed callback
+ * \param[in]       client: MQTT-SN client
+ */
+static void
+mqtt_sn_closed_cb(gsm_mqtt_sn_client_p client) {
+    gsm_mqtt_sn_state_t state = client->state;
+
+    client->conn = NULL;
+    request_fail(client, gsmCLOSED, GSM_MQTT_SN_RC_TIMEOUT);
+    client->state = GSM_MQTT_SN_STATE_CLOSED;
+    topic_reset(client);
+
+    client->evt.type = GSM_MQTT_SN_EVT_DISCONNECT;
+    client->evt.evt.disconnect.is_accepted = state == GSM_MQTT_SN_STATE_CONNECTED
+                                            || state == GSM_MQTT_SN_STATE_ASLEEP
+                                            || state == GSM_MQTT_SN_STATE_AWAKE
+                                            || state == GSM_MQTT_SN_STATE_DISCONNECTING;
+    client->evt_fn(client, &client->evt);
+}
+
+/**
+ * \brief           Connection callback
+ * \param[in]       evt: Callback parameters
+ * \result          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+mqtt_sn_conn_cb(gsm_evt_t* evt) {
+    gsm_conn_p conn;
+    gsm_mqtt_sn_client_p client = NULL;
+
+    conn = gsm_conn_get_from_evt(evt);          /* Get connection from event */
+    if (conn != NULL) {
+        client = gsm_conn_get_arg(conn);        /* Get client structure from connection */
+        if (client == NULL) {
+            gsm_conn_close(conn, 0);            /* Force connection close immediately */
+            return gsmERR;
+        }
+    } else if (evt->type != GSM_EVT_CONN_ERROR) {
+        return gsmERR;
+    }
+
+    switch (gsm_evt_get_type(evt)) {
+        /* UDP connection could not be started */
+        case GSM_EVT_CONN_ERROR: {
+            client = gsm_evt_conn_error_get_arg(evt);
+            if (client != NULL) {
+                client->state = GSM_MQTT_SN_STATE_CLOSED;
+                client->evt.type = GSM_MQTT_SN_EVT_CONNECT;
+                client->evt.evt.connect.rc = GSM_MQTT_SN_RC_UDP_FAILED;
+                client->evt_fn(client, &client->evt);
+            }
+            break;
+        }
+
+        /* UDP connection is ready, connect to gateway if requested */
+        case GSM_EVT_CONN_ACTIVE: {
+            client->conn = conn;
+            client->state = GSM_MQTT_SN_STATE_OPEN;
+            client->evt.type = GSM_MQTT_SN_EVT_OPEN;
+            client->evt_fn(client, &client->evt);
+            if (client->state == GSM_MQTT_SN_STATE_OPEN && client->info != NULL) {
+                send_connect(client);
+            }
+            break;
+        }
+
+        /* Datagram received from gateway */
+        case GSM_EVT_CONN_RECV: {
+            gsm_pbuf_p pbuf = gsm_evt_conn_recv_get_buff(evt);
+            size_t len = gsm_pbuf_length(pbuf, 1);
+
+            if (len <= client->rx_buff_len) {
+                gsm_pbuf_copy(pbuf, client->rx_buff, len, 0);
+                mqtt_sn_process(client, client->rx_buff, len);
+            } else {
+                GSM_DEBUGF(GSM_CFG_DBG_MQTT_SN_TRACE_WARNING,
+                    "[MQTT-SN] Datagram of %d bytes does not fit to receive buffer\r\n", (int)len);
+            }
+            gsm_conn_recved(conn, pbuf);        /* Notify stack about received data */
+            break;
+        }
+
+        /* Periodic poll for connection */
+        case GSM_EVT_CONN_POLL: {
+            mqtt_sn_poll_cb(client);
+            break;
+        }
+
+        /* Connection closed */
+        case GSM_EVT_CONN_CLOSE: {
+            mqtt_sn_closed_cb(client);
+            break;
+        }
+        default:
+            break;
+    }
+    return gsmOK;
+}
+
+/**
+ * \brief           Allocate a new MQTT-SN client structure
+ * \param[in]       tx_buff_len: Length of request buffer. Limits largest message sent with gateway reply,
+ *                      such as publish with \ref GSM_MQTT_SN_QOS_AT_LEAST_ONCE
+ * \param[in]       rx_buff_len: Length of receive buffer. Limits largest message received from gateway
+ * \return          Pointer to new allocated MQTT-SN client structure or `NULL` on failure
+ */
+gsm_mqtt_sn_client_p
+gsm_mqtt_sn_client_new(size_t tx_buff_len, size_t rx_buff_len) {
+    gsm_mqtt_sn_client_p client;
+
+    client = gsm_mem_malloc(sizeof(*client));
+    if (client != NULL) {
+        GSM_MEMSET(client, 0x00, sizeof(*client));
+        client->state = GSM_MQTT_SN_STATE_CLOSED;
+        client->evt_fn = mqtt_sn_evt_fn_default;
+        client->tx_buff_len = tx_buff_len;
+        client->rx_buff_len = rx_buff_len;
+        client->tx_buff = gsm_mem_malloc(tx_buff_len);
+        client->rx_buff = gsm_mem_malloc(rx_buff_len);
+        if (client->tx_buff == NULL || client->rx_buff == NULL) {
+            gsm_mem_free_s((void **)&client->tx_buff);
+            gsm_mem_free_s((void **)&client->rx_buff);
+            gsm_mem_free_s((void **)&client);
+        }
+    }
+    return client;
+}
+
+/**
+ * \brief           Delete MQTT-SN client structure
+ * \note            UDP connection must be closed first
+ * \param[in]       client: MQTT-SN client
+ */
+void
+gsm_mqtt_sn_client_delete(gsm_mqtt_sn_client_p client) {
+    if (client != NULL) {
+        topic_reset(client);
+        gsm_mem_free_s((void **)&client->tx_buff);
+        gsm_mem_free_s((void **)&client->rx_buff);
+        gsm_mem_free_s((void **)&client);
+    }
+}
+
+/**
+ * \brief           Connect to MQTT-SN gateway
+ *
+ * UDP connection is started first and \ref GSM_MQTT_SN_EVT_OPEN event is sent when it is active.
+ * CONNECT message is sent after, when `info` is set.
+ * When client is already open or asleep, CONNECT message is sent immediately
+ * and `host`, `port` parameters are not used.
+ *
+ * \note            `info` memory must stay valid until client is disconnected
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       host: Gateway host address
+ * \param[in]       port: Gateway port number
+ * \param[in]       evt_fn: Callback function for all events on this client
+ * \param[in]       info: Information structure for connection.
+ *                      Set to `NULL` to only open UDP connection for publish with \ref GSM_MQTT_SN_QOS_NO_CONNECT
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_sn_client_connect(gsm_mqtt_sn_client_p client, const char* host, gsm_port_t port,
+                           gsm_mqtt_sn_evt_fn evt_fn, const gsm_mqtt_sn_client_info_t* info) {
+    gsmr_t res = gsmERR;
+
+    GSM_ASSERT("client != NULL", client != NULL);
+    GSM_ASSERT("info == NULL || info->id != NULL", info == NULL || info->id != NULL);
+
+    gsm_core_lock();
+    client->evt_fn = evt_fn != NULL ? evt_fn : mqtt_sn_evt_fn_default;
+    if (client->state == GSM_MQTT_SN_STATE_CLOSED) {
+        if (host != NULL && port > 0) {
+            client->info = info;
+            res = gsm_conn_start(&client->conn, GSM_CONN_TYPE_UDP, host, port, client, mqtt_sn_conn_cb, 0);
+            if (res == gsmOK) {
+                client->state = GSM_MQTT_SN_STATE_OPENING;
+            }
+        }
+    } else if ((client->state == GSM_MQTT_SN_STATE_OPEN || client->state == GSM_MQTT_SN_STATE_ASLEEP)
+                && info != NULL) {
+        if (client->tx_len > 0) {
+            res = gsmINPROG;
+        } else {
+            client->info = info;
+            res = send_connect(client);
+        }
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Disconnect from MQTT-SN gateway and close UDP connection
+ *
+ * \ref GSM_MQTT_SN_EVT_DISCONNECT event is sent when UDP connection is closed
+ *
+ * \param[in]       client: MQTT-SN client
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_sn_client_disconnect(gsm_mqtt_sn_client_p client) {
+    gsmr_t res = gsmERR;
+
+    gsm_core_lock();
+    if (client->state == GSM_MQTT_SN_STATE_CONNECTED
+        || client->state == GSM_MQTT_SN_STATE_ASLEEP
+        || client->state == GSM_MQTT_SN_STATE_AWAKE) {
+        request_fail(client, gsmCLOSED, GSM_MQTT_SN_RC_ACCEPTED);   /* User is not interested in it anymore */
+        if (request_prepare(client, MQTT_SN_MSG_TYPE_DISCONNECT, 0) != NULL) {
+            client->state = GSM_MQTT_SN_STATE_DISCONNECTING;
+            request_send(client, MQTT_SN_MSG_TYPE_DISCONNECT, 0, NULL);
+            res = gsmOK;
+        }
+    } else if (client->state == GSM_MQTT_SN_STATE_OPEN
+            || client->state == GSM_MQTT_SN_STATE_CONNECTING) {
+        res = gsm_conn_close(client->conn, 0);
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Test if client is connected to gateway and active
+ * \param[in]       client: MQTT-SN client
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gsm_mqtt_sn_client_is_connected(gsm_mqtt_sn_client_p client) {
+    uint8_t res;
+
+    gsm_core_lock();
+    res = GSM_U8(client->state == GSM_MQTT_SN_STATE_CONNECTED);
+    gsm_core_unlock();
+
+    return res;
+}
+
+/**
+ * \brief           Put client to sleep
+ *
+ * Gateway buffers messages for client until it wakes up with \ref gsm_mqtt_sn_client_wakeup.
+ * Client must wake up or connect again before `duration` expires, otherwise gateway considers it lost
+ *
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       duration: Sleep duration in units of seconds
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_sn_client_sleep(gsm_mqtt_sn_client_p client, uint16_t duration) {
+    gsmr_t res = gsmERR;
+    uint8_t* d;
+
+    GSM_ASSERT("duration > 0", duration > 0);
+
+    gsm_core_lock();
+    if (client->state == GSM_MQTT_SN_STATE_CONNECTED) {
+        if (client->tx_len > 0) {
+            res = gsmINPROG;
+        } else if ((d = request_prepare(client, MQTT_SN_MSG_TYPE_DISCONNECT, 2)) != NULL) {
+            write_u16(d, duration);
+            request_send(client, MQTT_SN_MSG_TYPE_DISCONNECT, 0, NULL);
+            res = gsmOK;
+        } else {
+            res = gsmERRMEM;
+        }
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Wake up sleeping client to receive messages buffered by gateway
+ *
+ * \ref GSM_MQTT_SN_EVT_WAKEUP event is sent after all messages were received and client is asleep again.
+ * Use \ref gsm_mqtt_sn_client_connect to become active instead
+ *
+ * \param[in]       client: MQTT-SN client
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_sn_client_wakeup(gsm_mqtt_sn_client_p client) {
+    gsmr_t res = gsmERR;
+    size_t len_id;
+    uint8_t* d;
+
+    gsm_core_lock();
+    if (client->state == GSM_MQTT_SN_STATE_ASLEEP) {
+        len_id = strlen(client->info->id);
+        if (client->tx_len > 0) {
+            res = gsmINPROG;
+        } else if ((d = request_prepare(client, MQTT_SN_MSG_TYPE_PINGREQ, len_id)) != NULL) {
+            GSM_MEMCPY(d, client->info->id, len_id);    /* Client ID identifies sleeping client */
+            client->state = GSM_MQTT_SN_STATE_AWAKE;
+            request_send(client, MQTT_SN_MSG_TYPE_PINGRESP, 0, NULL);
+            res = gsmOK;
+        } else {
+            res = gsmERRMEM;
+        }
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Register topic name and get topic ID from gateway
+ *
+ * \ref GSM_MQTT_SN_EVT_REGISTER event is sent with assigned topic ID.
+ * Topic ID is also available later with \ref gsm_mqtt_sn_client_get_topic_id
+ *
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       topic: Topic name to register
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_sn_client_register(gsm_mqtt_sn_client_p client, const char* topic, void* arg) {
+    gsmr_t res = gsmERR;
+    size_t len_topic;
+    uint16_t msg_id;
+    uint8_t* d;
+
+    GSM_ASSERT("topic != NULL", topic != NULL);
+    if ((len_topic = strlen(topic)) == 0) {
+        return gsmPARERR;
+    }
+
+    gsm_core_lock();
+    if (client->state == GSM_MQTT_SN_STATE_CONNECTED) {
+        if (client->tx_len > 0) {
+            res = gsmINPROG;
+        } else if ((d = request_prepare(client, MQTT_SN_MSG_TYPE_REGISTER, 4 + len_topic)) != NULL) {
+            msg_id = create_msg_id(client);
+            write_u16(&d[0], 0);                /* Topic ID is not used by client */
+            write_u16(&d[2], msg_id);
+            GSM_MEMCPY(&d[4], topic, len_topic);
+            request_send(client, MQTT_SN_MSG_TYPE_REGACK, msg_id, arg);
+            res = gsmOK;
+        } else {
+            res = gsmERRMEM;
+        }
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Get topic ID of registered or subscribed topic name
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       topic: Topic name
+ * \param[out]      topic_id: Pointer to output topic ID
+ * \return          `1` if topic ID is known, `0` otherwise
+ */
+uint8_t
+gsm_mqtt_sn_client_get_topic_id(gsm_mqtt_sn_client_p client, const char* topic, uint16_t* topic_id) {
+    mqtt_sn_topic_t* t;
+    uint8_t res = 0;
+
+    gsm_core_lock();
+    if ((t = topic_find_name(client, topic, strlen(topic))) != NULL) {
+        *topic_id = t->id;
+        res = 1;
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Subscribe/Unsubscribe to/from topic
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       topic_type: Topic ID type
+ * \param[in]       topic: Topic name for normal and short topic types
+ * \param[in]       topic_id: Topic ID for predefined topic type
+ * \param[in]       qos: Quality of service, used only on subscribe part
+ * \param[in]       arg: User custom argument used in callback
+ * \param[in]       sub: Status set to `1` on subscribe or `0` on unsubscribe
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+sub_unsub(gsm_mqtt_sn_client_p client, gsm_mqtt_sn_topic_type_t topic_type, const char* topic,
+          uint16_t topic_id, gsm_mqtt_sn_qos_t qos, void* arg, uint8_t sub) {
+    gsmr_t res = gsmERR;
+    size_t len_topic;
+    uint16_t msg_id;
+    uint8_t* d;
+
+    len_topic = topic_type == GSM_MQTT_SN_TOPIC_PREDEFINED ? 2 : strlen(topic);
+    if (len_topic == 0) {
+        return gsmPARERR;
+    }
+
+    gsm_core_lock();
+    if (client->state == GSM_MQTT_SN_STATE_CONNECTED) {
+        if (client->tx_len > 0) {
+            res = gsmINPROG;
+        } else if ((d = request_prepare(client, sub ? MQTT_SN_MSG_TYPE_SUBSCRIBE : MQTT_SN_MSG_TYPE_UNSUBSCRIBE, 3 + len_topic)) != NULL) {
+            msg_id = create_msg_id(client);
+            d[0] = MQTT_SN_FLAG_TOPIC_TYPE(topic_type);
+            if (sub) {
+                d[0] |= MQTT_SN_FLAG_QOS(qos == GSM_MQTT_SN_QOS_AT_LEAST_ONCE ? 1 : 0);
+            }
+            write_u16(&d[1], msg_id);
+            if (topic_type == GSM_MQTT_SN_TOPIC_PREDEFINED) {
+                write_u16(&d[3], topic_id);
+            } else {
+                GSM_MEMCPY(&d[3], topic, len_topic);
+            }
+            request_send(client, sub ? MQTT_SN_MSG_TYPE_SUBACK : MQTT_SN_MSG_TYPE_UNSUBACK, msg_id, arg);
+            res = gsmOK;
+        } else {
+            res = gsmERRMEM;
+        }
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Subscribe to topic name
+ *
+ * Topic name may include wildcards. Names with `2` characters are subscribed as short topic names.
+ * Topic ID of non-wildcard topic name is reported with \ref GSM_MQTT_SN_EVT_SUBSCRIBE event
+ *
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       topic: Topic name to subscribe to
+ * \param[in]       qos: Maximal quality of service of received messages
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_sn_client_subscribe(gsm_mqtt_sn_client_p client, const char* topic, gsm_mqtt_sn_qos_t qos, void* arg) {
+    GSM_ASSERT("topic != NULL", topic != NULL);
+    return sub_unsub(client, strlen(topic) == 2 ? GSM_MQTT_SN_TOPIC_SHORT : GSM_MQTT_SN_TOPIC_NORMAL,
+                    topic, 0, qos, arg, 1);
+}
+
+/**
+ * \brief           Subscribe to predefined topic ID
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       topic_id: Predefined topic ID
+ * \param[in]       qos: Maximal quality of service of received messages
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_sn_client_subscribe_predefined(gsm_mqtt_sn_client_p client, uint16_t topic_id, gsm_mqtt_sn_qos_t qos, void* arg) {
+    return sub_unsub(client, GSM_MQTT_SN_TOPIC_PREDEFINED, NULL, topic_id, qos, arg, 1);
+}
+
+/**
+ * \brief           Unsubscribe from topic name
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       topic: Topic name to unsubscribe from
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_sn_client_unsubscribe(gsm_mqtt_sn_client_p client, const char* topic, void* arg) {
+    GSM_ASSERT("topic != NULL", topic != NULL);
+    return sub_unsub(client, strlen(topic) == 2 ? GSM_MQTT_SN_TOPIC_SHORT : GSM_MQTT_SN_TOPIC_NORMAL,
+                    topic, 0, GSM_MQTT_SN_QOS_AT_MOST_ONCE, arg, 0);
+}
+
+/**
+ * \brief           Publish a new message on topic ID
+ *
+ * Message with \ref GSM_MQTT_SN_QOS_AT_LEAST_ONCE is kept until gateway acknowledges it
+ * and \ref GSM_MQTT_SN_EVT_PUBLISH event is sent. Other messages are sent without event.
+ *
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       topic_type: Topic ID type
+ * \param[in]       topic_id: Topic ID. Use \ref GSM_MQTT_SN_SHORT_TOPIC_ID for short topic names
+ * \param[in]       payload: Message data
+ * \param[in]       len: Length of payload data
+ * \param[in]       qos: Quality of service. \ref GSM_MQTT_SN_QOS_NO_CONNECT is only possible
+ *                      with predefined and short topic IDs and does not require connection to gateway
+ * \param[in]       retain: Retain parameter value
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_mqtt_sn_client_publish(gsm_mqtt_sn_client_p client, gsm_mqtt_sn_topic_type_t topic_type, uint16_t topic_id,
+                           const void* payload, uint16_t len, gsm_mqtt_sn_qos_t qos, uint8_t retain, void* arg) {
+    gsmr_t res = gsmERR;
+    uint8_t hdr[9], flags, *d;
+    size_t hdr_len;
+    uint16_t msg_id;
+
+    GSM_ASSERT("qos != GSM_MQTT_SN_QOS_NO_CONNECT || topic_type != GSM_MQTT_SN_TOPIC_NORMAL",
+        qos != GSM_MQTT_SN_QOS_NO_CONNECT || topic_type != GSM_MQTT_SN_TOPIC_NORMAL);
+    if (payload == NULL) {
+        len = 0;
+    }
+    flags = MQTT_SN_FLAG_QOS(qos) | MQTT_SN_FLAG_TOPIC_TYPE(topic_type) | (retain ? MQTT_SN_FLAG_RETAIN : 0);
+
+    gsm_core_lock();
+    if (qos == GSM_MQTT_SN_QOS_AT_LEAST_ONCE) {
+        if (client->state != GSM_MQTT_SN_STATE_CONNECTED) {
+            res = gsmCLOSED;
+        } else if (client->tx_len > 0) {
+            res = gsmINPROG;
+        } else if ((d = request_prepare(client, MQTT_SN_MSG_TYPE_PUBLISH, 5 + len)) != NULL) {
+            msg_id = create_msg_id(client);
+            d[0] = flags;
+            write_u16(&d[1], topic_id);
+            write_u16(&d[3], msg_id);
+            if (len > 0) {
+                GSM_MEMCPY(&d[5], payload, len);
+            }
+            request_send(client, MQTT_SN_MSG_TYPE_PUBACK, msg_id, arg);
+            res = gsmOK;
+        } else {
+            res = gsmERRMEM;
+        }
+    } else if ((qos == GSM_MQTT_SN_QOS_NO_CONNECT && client->state != GSM_MQTT_SN_STATE_CLOSED
+                    && client->state != GSM_MQTT_SN_STATE_OPENING)
+                || client->state == GSM_MQTT_SN_STATE_CONNECTED) {
+        /* No reply expected, header and payload are written directly to connection */
+        hdr_len = write_hdr(hdr, MQTT_SN_MSG_TYPE_PUBLISH, 5 + len);
+        if ((hdr_len + 5 + len) > GSM_CFG_CONN_MAX_DATA_LEN) {
+            res = gsmERRMEM;                    /* Message must fit to single datagram */
+        } else {
+            hdr[hdr_len] = flags;
+            write_u16(&hdr[hdr_len + 1], topic_id);
+            write_u16(&hdr[hdr_len + 3], 0x0000);   /* Message ID is not used */
+            res = send_part(client, hdr, hdr_len + 5, len == 0);
+            if (res == gsmOK && len > 0) {
+                res = send_part(client, payload, len, 1);
+            }
+        }
+    } else {
+        res = gsmCLOSED;
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Set user argument on client
+ * \param[in]       client: MQTT-SN client handle
+ * \param[in]       arg: User argument
+ */
+void
+gsm_mqtt_sn_client_set_arg(gsm_mqtt_sn_client_p client, void* arg) {
+    gsm_core_lock();
+    client->arg = arg;
+    gsm_core_unlock();
+}
+
+/**
+ * \brief           Get user argument on client
+ * \param[in]       client: MQTT-SN client handle
+ * \return          User argument
+ */
+void *
+gsm_mqtt_sn_client_get_arg(gsm_mqtt_sn_client_p client) {
+    return client->arg;
+}
@@ -256,6 +256,36 @@ gsm_delay(uint32_t ms) {
     return 0;
 }
 
+/**
+ * \brief           Set baudrate of AT port
+ *
+ * Device is set to new baudrate with `AT+IPR` command, low-level driver is reconfigured
+ * with \ref gsm_ll_init and link is verified with `AT` probe.
+ * When device does not respond at new baudrate, it is probed at previous baudrate.
+ * When it responds there, previous baudrate is kept and command fails. When it does not respond
+ * at any of both, low-level driver stays at new baudrate, accepted by device, and command fails
+ *
+ * \param[in]       baud: New baudrate to use
+ * \param[in]       evt_fn: Callback function called when command is finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_set_at_baudrate(uint32_t baud,
+                    const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_ASSERT("baud > 0", baud > 0);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_UART;
+    GSM_MSG_VAR_REF(msg).msg.uart.baudrate = baud;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
+}
+
 /**
  * \brief           Set modem function mode
  * \note            Use this function to set modem to normal or low-power mode
@@ -278,6 +308,67 @@ gsm_set_func_mode(uint8_t mode,
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
 }
 
+#if GSM_CFG_BATCH || __DOXYGEN__
+
+/**
+ * \brief           Start collecting API calls into single batch
+ *
+ * Every API function called after this one is not sent to producer thread immediately,
+ * but added to batch and executed back to back when \ref gsm_batch_commit is called.
+ * Each step reports its own result through its event callback
+ *
+ * \note            Stack stays locked until \ref gsm_batch_commit is called.
+ *                  Only non-blocking calls are allowed in between, blocking calls return \ref gsmERRBLOCKING
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_batch_begin(void) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_MSG_VAR_ALLOC(msg, 0);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_BATCH;
+
+    gsm_core_lock();                            /* Released in commit */
+    if (gsm.batch != NULL) {
+        gsm_core_unlock();
+        GSM_MSG_VAR_FREE(msg);
+        return gsmERR;                          /* Batch already started */
+    }
+    gsm.batch = &GSM_MSG_VAR_REF(msg);
+    return gsmOK;
+}
+
+/**
+ * \brief           Send collected API calls to producer thread as single message
+ * \param[in]       evt_fn: Callback function called when all steps are finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise.
+ *                  When executed, result of first failed step is reported
+ */
+gsmr_t
+gsm_batch_commit(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    gsm_msg_t* msg;
+
+    gsm_core_lock();
+    if (gsm.batch == NULL) {
+        gsm_core_unlock();
+        return gsmERR;                          /* Batch not started */
+    }
+
+    msg = gsm.batch;
+    gsm.batch = NULL;
+    gsm_core_unlock();
+    gsm_core_unlock();                          /* Lock from begin */
+
+    msg->is_blocking = GSM_U8(blocking > 0);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+
+    return gsmi_send_msg_to_producer_mbox(msg, gsmi_initiate_cmd, 0);
+}
+
+#endif /* GSM_CFG_BATCH || __DOXYGEN__ */
+
 /**
  * \brief           Notify stack if device is present or not
  *
@@ -138,3 +138,36 @@ gsm_device_get_serial_number(char* serial, size_t len, const gsm_api_cmd_evt_fn
 
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
 }
+
+#if GSM_CFG_WARM_START || __DOXYGEN__
+
+/**
+ * \brief           Set user functions to load and save device profile for warm start
+ *
+ * Profile is loaded on every reset and compared against device serial number.
+ * When it matches, manufacturer, model and revision queries are skipped.
+ * Profile is saved after full identification of new or changed device
+ *
+ * \note            Call before \ref gsm_init or from \ref GSM_EVT_INIT_FINISH event
+ *                  to use profile on first reset. Core is locked only when stack is initialized,
+ *                  as system mutex does not exist before \ref gsm_init
+ * \param[in]       load_fn: Function to load profile. Set to `NULL` to disable warm start
+ * \param[in]       save_fn: Function to save profile. Set to `NULL` when not used
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_device_set_profile_fn(gsm_device_profile_load_fn load_fn, gsm_device_profile_save_fn save_fn) {
+    uint8_t locked = gsm.status.f.initialized;  /* Lock only when system is ready */
+
+    if (locked) {
+        gsm_core_lock();
+    }
+    gsm.profile.load_fn = load_fn;
+    gsm.profile.save_fn = save_fn;
+    if (locked) {
+        gsm_core_unlock();
+    }
+    return gsmOK;
+}
+
+#endif /* GSM_CFG_WARM_START || __DOXYGEN__ */
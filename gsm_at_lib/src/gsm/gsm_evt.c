@@ -141,6 +141,20 @@ gsm_evt_network_operator_get_current(gsm_evt_t* cc) {
     return cc->evt.operator_current.operator_current;
 }
 
+#if GSM_CFG_NETWORK_TRACKER || __DOXYGEN__
+
+/**
+ * \brief           Get new network state from event
+ * \param[in]       cc: Event data
+ * \return          Network state handle
+ */
+const gsm_network_state_t *
+gsm_evt_network_state_get_state(gsm_evt_t* cc) {
+    return cc->evt.network_state.state;
+}
+
+#endif /* GSM_CFG_NETWORK_TRACKER || __DOXYGEN__ */
+
 /**
  * \brief           Get operator scan operation status
  * \param[in]       cc: Event data
@@ -418,6 +432,26 @@ gsm_evt_sms_send_get_pos(gsm_evt_t* cc) {
     return cc->evt.sms_send.pos;
 }
 
+/**
+ * \brief           Get processed entry of SMS batch send operation
+ * \param[in]       cc: Event handle
+ * \return          Entry with send result and position in memory
+ */
+gsm_sms_batch_entry_t *
+gsm_evt_sms_send_batch_get_entry(gsm_evt_t* cc) {
+    return cc->evt.sms_send_batch.entry;
+}
+
+/**
+ * \brief           Get index of processed entry of SMS batch send operation
+ * \param[in]       cc: Event handle
+ * \return          Index of entry in batch array
+ */
+size_t
+gsm_evt_sms_send_batch_get_index(gsm_evt_t* cc) {
+    return cc->evt.sms_send_batch.index;
+}
+
 /**
  * \brief           Get SMS delete result status
  * \param[in]       cc: Event handle
@@ -448,6 +482,109 @@ gsm_evt_sms_delete_get_mem(gsm_evt_t* cc) {
     return cc->evt.sms_delete.mem;
 }
 
+#if GSM_CFG_SMS_CONCAT || __DOXYGEN__
+
+/**
+ * \brief           Get phone number of concatenated SMS sender
+ * \param[in]       cc: Event handle
+ * \return          Phone number
+ */
+const char *
+gsm_evt_sms_concat_recv_get_number(gsm_evt_t* cc) {
+    return cc->evt.sms_concat_recv.number;
+}
+
+/**
+ * \brief           Get data of concatenated SMS
+ * \param[in]       cc: Event handle
+ * \return          `NULL` terminated message data, UTF-8 encoded for text messages
+ */
+const char *
+gsm_evt_sms_concat_recv_get_data(gsm_evt_t* cc) {
+    return cc->evt.sms_concat_recv.data;
+}
+
+/**
+ * \brief           Get length of concatenated SMS data
+ * \param[in]       cc: Event handle
+ * \return          Length of data in units of bytes
+ */
+size_t
+gsm_evt_sms_concat_recv_get_length(gsm_evt_t* cc) {
+    return cc->evt.sms_concat_recv.len;
+}
+
+/**
+ * \brief           Get data coding scheme of concatenated SMS
+ * \param[in]       cc: Event handle
+ * \return          Data coding scheme
+ */
+gsm_sms_dcs_t
+gsm_evt_sms_concat_recv_get_dcs(gsm_evt_t* cc) {
+    return cc->evt.sms_concat_recv.dcs;
+}
+
+/**
+ * \brief           Get memory where concatenated SMS parts are stored
+ * \param[in]       cc: Event handle
+ * \return          SMS memory
+ */
+gsm_mem_t
+gsm_evt_sms_concat_recv_get_mem(gsm_evt_t* cc) {
+    return cc->evt.sms_concat_recv.mem;
+}
+
+/**
+ * \brief           Get number of parts of concatenated SMS
+ * \param[in]       cc: Event handle
+ * \return          Number of parts
+ */
+uint8_t
+gsm_evt_sms_concat_recv_get_parts(gsm_evt_t* cc) {
+    return cc->evt.sms_concat_recv.parts;
+}
+
+/**
+ * \brief           Get position in memory of concatenated SMS part
+ * \param[in]       cc: Event handle
+ * \param[in]       index: Part index, starting with `0`
+ * \return          Position in memory
+ */
+size_t
+gsm_evt_sms_concat_recv_get_pos(gsm_evt_t* cc, uint8_t index) {
+    return index < cc->evt.sms_concat_recv.parts ? cc->evt.sms_concat_recv.pos[index] : 0;
+}
+
+#endif /* GSM_CFG_SMS_CONCAT || __DOXYGEN__ */
+
+#if GSM_CFG_SMS_DIRECT || __DOXYGEN__
+
+/**
+ * \brief           Get SMS entry received with `+CMT`
+ * \param[in]       cc: Event handle
+ * \return          SMS entry, valid only during event callback
+ */
+gsm_sms_entry_t *
+gsm_evt_sms_deliver_get_entry(gsm_evt_t* cc) {
+    return cc->evt.sms_deliver.entry;
+}
+
+#endif /* GSM_CFG_SMS_DIRECT || __DOXYGEN__ */
+
+#if GSM_CFG_SMS_DRAIN || __DOXYGEN__
+
+/**
+ * \brief           Get SMS entry listed by storage drainer
+ * \param[in]       cc: Event handle
+ * \return          SMS entry, valid only during event callback
+ */
+gsm_sms_entry_t *
+gsm_evt_sms_drain_get_entry(gsm_evt_t* cc) {
+    return cc->evt.sms_drain.entry;
+}
+
+#endif /* GSM_CFG_SMS_DRAIN || __DOXYGEN__ */
+
 #endif /* GSM_CFG_SMS || __DOXYGEN__ */
 
 #if GSM_CFG_CALL || __DOXYGEN__
@@ -37,6 +37,7 @@
 #include "gsm/gsm_mem.h"
 #include "gsm/gsm_parser.h"
 #include "gsm/gsm_unicode.h"
+#include "gsm/gsm_timeout.h"
 #include "system/gsm_ll.h"
 
 #if !__DOXYGEN__
@@ -74,10 +75,39 @@ typedef struct {
 /* Send special characters */
 #define AT_PORT_SEND_CTRL_Z()               AT_PORT_SEND_STR("\x1A")
 #define AT_PORT_SEND_ESC()                  AT_PORT_SEND_STR("\x1B")
+
+/* Number of drained SMS positions deleted with single command line, keeps line within modem buffer */
+#define SMS_DRAIN_DEL_PER_CMD               10
 #endif /* !__DOXYGEN__ */
 
 static gsm_recv_t recv_buff;
+static uint32_t ready_start_time;
+static uint8_t probe_sent;                      /* Number of `AT` probes sent by active probe command */
+static uint8_t probe_settle;                    /* Set to `1` while waiting for late replies after successful probe */
+#if GSM_CFG_CMD_COALESCE
+
+/**
+ * \brief           Read-only commands which may be coalesced
+ */
+static const gsm_cmd_t
+coalesce_cmds[] = { GSM_CMD_CSQ_GET, GSM_CMD_COPS_GET, GSM_CMD_CIPSTATUS };
+
+static gsm_msg_t* coalesce_leader[GSM_ARRAYSIZE(coalesce_cmds)];
+#if GSM_CFG_CMD_COALESCE_CACHE_TTL > 0
+static uint32_t coalesce_time[GSM_ARRAYSIZE(coalesce_cmds)];
+static uint8_t coalesce_valid[GSM_ARRAYSIZE(coalesce_cmds)];
+#endif /* GSM_CFG_CMD_COALESCE_CACHE_TTL > 0 */
+#endif /* GSM_CFG_CMD_COALESCE */
+#if GSM_CFG_AT_PORT_AUTOBAUD
+
+/**
+ * \brief           Baudrates to try when device does not respond after reset
+ */
+static const uint32_t
+autobaud_rates[] = { 115200, 9600, 19200, 38400, 57600, 230400, 460800, 921600 };
+#endif /* GSM_CFG_AT_PORT_AUTOBAUD */
 static gsmr_t gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error);
+static void gsmi_ready_timeout(void* arg);
 
 /**
  * \brief           Memory mapping
@@ -385,6 +415,343 @@ gsmi_send_sms_stat(gsm_sms_status_t status, uint8_t q, uint8_t c) {
     gsmi_send_string(t, 0, q, c);
 }
 
+/**
+ * \brief           Prepare send parameters for current entry of batch send operation
+ * \param[in]       msg: Batch send message
+ */
+static void
+gsmi_sms_batch_load(gsm_msg_t* msg) {
+    gsm_sms_batch_entry_t* e = &msg->msg.sms_send.entries[msg->msg.sms_send.index];
+
+    msg->msg.sms_send.num = e->num;
+    msg->msg.sms_send.text = e->text;
+    msg->msg.sms_send.pos = 0;
+#if GSM_CFG_SMS_PDU
+    msg->msg.sms_send.len = strlen(e->text);
+    msg->msg.sms_send.dcs = gsm_sms_pdu_get_dcs(e->text, msg->msg.sms_send.len);
+    msg->msg.sms_send.parts = 1;
+    msg->msg.sms_send.part = 0;
+    msg->msg.sms_send.part_off = 0;
+    msg->msg.sms_send.part_len = msg->msg.sms_send.len;
+    msg->msg.sms_send.udh_len = 0;
+#if GSM_CFG_SMS_CONCAT
+    msg->msg.sms_send.parts = GSM_U8(gsm_sms_pdu_get_parts(e->text, msg->msg.sms_send.len, msg->msg.sms_send.dcs,
+        GSM_SMS_PDU_CONCAT_UDH_LEN(GSM_CFG_SMS_CONCAT_REF16)));
+    if (msg->msg.sms_send.parts > 1) {
+        msg->msg.sms_send.ref = ++gsm.m.sms.concat_ref;
+    }
+#endif /* GSM_CFG_SMS_CONCAT */
+#endif /* GSM_CFG_SMS_PDU */
+}
+
+/**
+ * \brief           Set result of current entry of batch send operation and report it to user
+ * \param[in]       msg: Batch send message
+ * \param[in]       res: Send result
+ */
+static void
+gsmi_sms_batch_entry_done(gsm_msg_t* msg, gsmr_t res) {
+    gsm_sms_batch_entry_t* e = &msg->msg.sms_send.entries[msg->msg.sms_send.index];
+
+    e->res = res;
+    e->pos = msg->msg.sms_send.pos;
+    if (res != gsmOK) {
+        ++msg->msg.sms_send.failed;
+    }
+    gsm.evt.evt.sms_send_batch.entry = e;
+    gsm.evt.evt.sms_send_batch.index = msg->msg.sms_send.index;
+    gsmi_send_cb(GSM_EVT_SMS_SEND_BATCH);
+}
+
+/**
+ * \brief           Finish entry of SMS list operation after its data have been received
+ *
+ * When list callback is used, entry is passed to callback
+ * and then reused for next message, array index is not advanced
+ *
+ * \param[in]       msg: Pointer to SMS list message
+ */
+static void
+gsmi_sms_list_entry_done(gsm_msg_t* msg) {
+    gsm_sms_entry_t* e = &msg->msg.sms_list.entries[msg->msg.sms_list.ei];
+
+    if (msg->msg.sms_list.fn != NULL) {
+        if (msg->msg.sms_list.number == NULL || !strcmp(e->number, msg->msg.sms_list.number)) {
+            ++msg->msg.sms_list.cnt;
+            msg->msg.sms_list.fn(e, msg->msg.sms_list.fn_arg);
+        }
+        GSM_MEMSET(e, 0x00, sizeof(*e));        /* Clean entry for next message */
+    } else {
+        msg->msg.sms_list.cnt = ++msg->msg.sms_list.ei; /* Go to next entry */
+    }
+    if (msg->msg.sms_list.er != NULL) {         /* Check and update user variable */
+        *msg->msg.sms_list.er = msg->msg.sms_list.cnt;
+    }
+}
+
+#if GSM_CFG_SMS_DRAIN || __DOXYGEN__
+
+/**
+ * \brief           Report entry listed by SMS storage drainer to application
+ * \param[in]       entry: Listed SMS entry
+ * \param[in]       arg: Unused
+ */
+void
+gsmi_sms_drain_entry(gsm_sms_entry_t* entry, void* arg) {
+    GSM_UNUSED(arg);
+    if (gsm.m.sms.drain_cnt == GSM_ARRAYSIZE(gsm.m.sms.drain_pos)) {
+        gsm.m.sms.drain_rerun = 1;              /* Message stays unread, report it on next drain */
+        return;
+    }
+    gsm.m.sms.drain_pos[gsm.m.sms.drain_cnt++] = entry->pos;    /* Delete it once list is done */
+    gsm.evt.evt.sms_drain.entry = entry;
+    gsmi_send_cb(GSM_EVT_SMS_DRAIN);
+}
+
+/**
+ * \brief           Start SMS storage drain in background
+ * \param[in]       force: Set to `1` to start regardless of receive storage usage
+ */
+static void
+gsmi_sms_drain_start(uint8_t force) {
+    const gsm_sms_mem_t* m = &gsm.m.sms.mem[2]; /* Receive storage */
+
+    if (!gsm.m.sms.enabled) {
+        return;
+    }
+    if (gsm.m.sms.drain_pending) {
+        gsm.m.sms.drain_rerun |= force;         /* Message may be stored after list, start again later */
+        return;
+    }
+    if (force || (m->total > 0 && m->used * 100 >= m->total * GSM_CFG_SMS_DRAIN_WATERMARK)) {
+        gsm.m.sms.drain_pending = gsm_sms_drain(NULL, NULL, 0) == gsmOK;
+    }
+}
+
+/**
+ * \brief           Mark SMS storage drain as finished and start another one, if requested meanwhile
+ */
+static void
+gsmi_sms_drain_finish(void) {
+    gsm.m.sms.drain_pending = 0;
+    if (gsm.m.sms.drain_rerun) {
+        gsm.m.sms.drain_rerun = 0;
+        gsmi_sms_drain_start(1);
+    }
+}
+
+#endif /* GSM_CFG_SMS_DRAIN || __DOXYGEN__ */
+
+#if GSM_CFG_SMS_PDU || __DOXYGEN__
+
+/**
+ * \brief           Send SMS status number, used in PDU mode
+ * \param[in]       status: SMS status
+ * \param[in]       c: Set to `1` to include comma before number
+ */
+static void
+gsmi_send_sms_stat_pdu(gsm_sms_status_t status, uint8_t c) {
+    uint32_t n;
+    switch (status) {
+        case GSM_SMS_STATUS_UNREAD: n = 0;      break;
+        case GSM_SMS_STATUS_READ:   n = 1;      break;
+        case GSM_SMS_STATUS_UNSENT: n = 2;      break;
+        case GSM_SMS_STATUS_SENT:   n = 3;      break;
+        case GSM_SMS_STATUS_ALL:
+        default:                    n = 4;      break;
+    }
+    gsmi_send_number(n, 0, c);
+}
+
+/**
+ * \brief           Send single PDU byte to AT port as `2` hex characters
+ * \param[in]       octet: Byte to send
+ */
+static void
+gsmi_send_sms_pdu_octet(uint8_t octet) {
+    char str[3];
+
+    gsm_u8_to_hex_str(octet, str, 2);
+    AT_PORT_SEND(str, 2);
+}
+
+#if GSM_CFG_SMS_CONCAT || __DOXYGEN__
+
+/**
+ * \brief           Free concatenated SMS reassembly slot and its parts
+ * \param[in]       c: Slot to free
+ */
+static void
+gsmi_sms_concat_free(gsm_sms_concat_t* c) {
+    for (size_t i = 0; i < GSM_ARRAYSIZE(c->data); ++i) {
+        if (c->data[i] != NULL) {
+            gsm_mem_free_s((void **)&c->data[i]);
+        }
+    }
+    GSM_MEMSET(c, 0x00, sizeof(*c));
+}
+
+/**
+ * \brief           Store part of concatenated SMS and report message when all parts are received
+ *
+ * Messages are identified by sender number and reference number.
+ * Incomplete messages are dropped after \ref GSM_CFG_SMS_CONCAT_TIMEOUT
+ * or when all slots are used and part of new message is received
+ *
+ * \param[in]       e: Decoded SMS entry with concatenation information
+ */
+static void
+gsmi_sms_concat_process(const gsm_sms_entry_t* e) {
+    gsm_sms_concat_t *c = NULL, *c_free = NULL, *c_old = NULL, *s;
+    uint32_t now = gsm_sys_now();
+    size_t len = 0;
+    char* data;
+
+    if (e->concat_total > GSM_CFG_SMS_CONCAT_MAX_PARTS) {
+        return;                                 /* Message is too long, part is left to application */
+    }
+
+    /* Drop expired messages and find slot for this part */
+    for (size_t i = 0; i < GSM_ARRAYSIZE(gsm.m.sms.concat); ++i) {
+        s = &gsm.m.sms.concat[i];
+        if (s->used && (now - s->time) > GSM_CFG_SMS_CONCAT_TIMEOUT) {
+            gsmi_sms_concat_free(s);
+        }
+        if (!s->used) {
+            if (c_free == NULL) {
+                c_free = s;
+            }
+        } else if (s->ref == e->concat_ref && s->total == e->concat_total && !strcmp(s->number, e->number)) {
+            c = s;
+        } else if (c_old == NULL || (now - s->time) > (now - c_old->time)) {
+            c_old = s;
+        }
+    }
+    if (c == NULL) {                            /* First part of new message */
+        c = c_free != NULL ? c_free : c_old;    /* Use free slot or drop oldest message */
+        gsmi_sms_concat_free(c);
+        c->used = 1;
+        GSM_MEMCPY(c->number, e->number, sizeof(c->number));
+        c->ref = e->concat_ref;
+        c->total = e->concat_total;
+        c->dcs = e->dcs;
+        c->mem = e->mem;
+    }
+    c->time = now;
+    if (c->data[e->concat_seq - 1] == NULL) {   /* Duplicated parts are ignored */
+        if ((c->data[e->concat_seq - 1] = gsm_mem_malloc(e->length + 1)) == NULL) {
+            return;
+        }
+        GSM_MEMCPY(c->data[e->concat_seq - 1], e->data, e->length);
+        c->len[e->concat_seq - 1] = e->length;
+        c->pos[e->concat_seq - 1] = e->pos;
+        ++c->received;
+    }
+    if (c->received < c->total) {
+        return;
+    }
+
+    /* All parts received, join data and report message */
+    for (size_t i = 0; i < c->total; ++i) {
+        len += c->len[i];
+    }
+    if ((data = gsm_mem_malloc(len + 1)) != NULL) {
+        len = 0;
+        for (size_t i = 0; i < c->total; ++i) {
+            GSM_MEMCPY(&data[len], c->data[i], c->len[i]);
+            len += c->len[i];
+        }
+        data[len] = 0;
+        gsm.evt.evt.sms_concat_recv.number = c->number;
+        gsm.evt.evt.sms_concat_recv.data = data;
+        gsm.evt.evt.sms_concat_recv.len = len;
+        gsm.evt.evt.sms_concat_recv.dcs = c->dcs;
+        gsm.evt.evt.sms_concat_recv.mem = c->mem;
+        gsm.evt.evt.sms_concat_recv.pos = c->pos;
+        gsm.evt.evt.sms_concat_recv.parts = c->total;
+        gsmi_send_cb(GSM_EVT_SMS_CONCAT_RECV);
+        gsm_mem_free(data);
+    }
+    gsmi_sms_concat_free(c);
+}
+
+#endif /* GSM_CFG_SMS_CONCAT || __DOXYGEN__ */
+
+/**
+ * \brief           Process received character of PDU line for +CMGR or +CMGL command
+ * \param[in]       ch: Received character
+ * \param[out]      e: SMS entry to decode PDU to or `NULL` to ignore PDU
+ * \return          `1` when PDU line is finished, `0` otherwise
+ */
+static uint8_t
+gsmi_sms_pdu_process(char ch, gsm_sms_entry_t* e) {
+    if (GSM_CHARISHEXNUM(ch)) {
+        if (gsm.m.sms.pdu_len < sizeof(gsm.m.sms.pdu)) {
+            if (gsm.m.sms.pdu_hex) {            /* Second hex character completes byte */
+                gsm.m.sms.pdu[gsm.m.sms.pdu_len++] |= GSM_U8(GSM_CHARHEXTONUM(ch));
+            } else {
+                gsm.m.sms.pdu[gsm.m.sms.pdu_len] = GSM_U8(GSM_CHARHEXTONUM(ch) << 4);
+            }
+        }
+        gsm.m.sms.pdu_hex = !gsm.m.sms.pdu_hex;
+    } else if (ch == '\n') {
+        if (e != NULL) {
+            if (gsm_sms_pdu_decode(gsm.m.sms.pdu, gsm.m.sms.pdu_len, e) != gsmOK) {
+                e->length = 0;
+                e->data[0] = 0;
+#if GSM_CFG_SMS_CONCAT
+            } else if (e->concat_total > 0) {
+                gsmi_sms_concat_process(e);     /* Collect part of concatenated message */
+#endif /* GSM_CFG_SMS_CONCAT */
+            }
+        }
+        gsm.m.sms.pdu_len = 0;
+        gsm.m.sms.pdu_hex = 0;
+        return 1;
+    }
+    return 0;
+}
+
+#endif /* GSM_CFG_SMS_PDU || __DOXYGEN__ */
+
+#if GSM_CFG_SMS_DIRECT || __DOXYGEN__
+
+/**
+ * \brief           Process received character of message data line of +CMT
+ * \param[in]       ch: Received character
+ */
+static void
+gsmi_sms_direct_process(char ch) {
+    gsm_sms_entry_t* e = &gsm.m.sms.direct;
+    uint8_t done = 0;
+
+#if GSM_CFG_SMS_PDU
+    if (!gsm.m.sms.direct_format) {
+        done = gsmi_sms_pdu_process(ch, e);
+    }
+#endif /* GSM_CFG_SMS_PDU */
+    if (gsm.m.sms.direct_format) {
+        if (ch == '\n') {
+            done = 1;
+        } else if (ch != '\r' && e->length < (sizeof(e->data) - 1)) {
+            e->data[e->length++] = ch;
+            e->data[e->length] = 0;
+        }
+    }
+    if (done) {
+        gsm.m.sms.direct_read = 0;
+#if GSM_CFG_SMS_CONCAT
+        if (!gsm.m.sms.direct_format && e->concat_total > 0) {
+            return;                             /* Parts are reported with GSM_EVT_SMS_CONCAT_RECV event */
+        }
+#endif /* GSM_CFG_SMS_CONCAT */
+        gsm.evt.evt.sms_deliver.entry = e;
+        gsmi_send_cb(GSM_EVT_SMS_DELIVER);
+    }
+}
+
+#endif /* GSM_CFG_SMS_DIRECT || __DOXYGEN__ */
+
 #endif /* GSM_CFG_SMS */
 
 #if GSM_CFG_CONN || __DOXYGEN__
@@ -447,10 +814,16 @@ gsmi_reset_everything(uint8_t forced) {
 
     /* Invalid GSM modules */
     GSM_MEMSET(&gsm.m, 0x00, sizeof(gsm.m));
+#if GSM_CFG_CMD_COALESCE && GSM_CFG_CMD_COALESCE_CACHE_TTL > 0
+    GSM_MEMSET(coalesce_valid, 0x00, sizeof(coalesce_valid));   /* Stored results are not valid anymore */
+#endif /* GSM_CFG_CMD_COALESCE && GSM_CFG_CMD_COALESCE_CACHE_TTL > 0 */
 
     /* Manually set states */
     gsm.m.sim.state = (gsm_sim_state_t)-1;
     gsm.m.model = GSM_DEVICE_MODEL_UNKNOWN;
+#if GSM_CFG_NETWORK_TRACKER
+    gsmi_network_tracker_update();              /* Registration and bearer are lost */
+#endif /* GSM_CFG_NETWORK_TRACKER */
 }
 
 /**
@@ -670,6 +1043,316 @@ gsmi_conn_closed_process(uint8_t conn_num, uint8_t forced) {
 
 #endif /* GSM_CFG_CONN || __DOXYGEN__ */
 
+/**
+ * \brief           Finish message and notify its caller
+ *
+ * Called from processing thread as soon as command is finished, so blocking caller
+ * is woken up directly, or from producer thread when command did not start or timeout occurred
+ *
+ * \note            Function must be called with core locked. Message must not be used after this call
+ * \param[in]       msg: Message to finish
+ */
+void
+gsmi_msg_complete(gsm_msg_t* msg) {
+    if (gsm.msg == msg) {
+        gsm.msg = NULL;                         /* Producer thread checks this to know message is finished */
+    }
+#if GSM_CFG_BATCH
+    if (msg->batch != NULL && msg->res != gsmOK && msg->batch->res == gsmOK) {
+        msg->batch->res = msg->res;             /* Batch reports first failed step */
+    }
+#endif /* GSM_CFG_BATCH */
+#if GSM_CFG_CMD_SUSPEND
+    /* Command was aborted to let other commands run, put it back to queue */
+    if (msg->suspended) {
+        msg->suspended = 0;
+        msg->suspend_req = 0;
+        ++msg->suspend_cnt;
+        msg->cmd = msg->cmd_def;
+        msg->i = 0;
+        msg->res = gsmOK;
+        if (gsm_sys_mbox_putnow(&gsm.mbox_producer, msg)) {
+            return;
+        }
+        msg->res = gsmERR;                      /* Queue is full, finish with error */
+    }
+#endif /* GSM_CFG_CMD_SUSPEND */
+#if GSM_CFG_CMD_COALESCE
+    gsmi_cmd_coalesce_done(msg);                /* Finish messages waiting for this result */
+#endif /* GSM_CFG_CMD_COALESCE */
+
+#if GSM_CFG_USE_API_FUNC_EVT
+    /* Send event function to user */
+    if (msg->evt_fn != NULL) {
+        msg->evt_fn(msg->res, msg->evt_arg);    /* Send event with user argument */
+    }
+#endif /* GSM_CFG_USE_API_FUNC_EVT */
+
+    /*
+     * In case message is blocking,
+     * release semaphore and notify finished with processing
+     * otherwise directly free memory of message structure
+     */
+    if (msg->is_blocking) {
+        gsm_sys_sem_release(&msg->sem);
+    } else {
+        GSM_MSG_VAR_FREE(msg);
+    }
+}
+
+/**
+ * \brief           Process finished sub command of active message
+ * \param[in]       is_ok: Set to `1` when command finished with OK
+ * \param[in]       is_error: Set to `1` when command finished with error
+ */
+static void
+gsmi_process_cmd_result(uint8_t is_ok, uint16_t is_error) {
+    gsmr_t res = gsmOK;
+    if (gsm.msg != NULL) {                      /* Do we have active message? */
+        res = gsmi_process_sub_cmd(gsm.msg, &is_ok, &is_error);
+        if (res != gsmCONT) {                   /* Shall we continue with next subcommand under this one? */
+            if (is_ok) {                        /* Check OK status */
+                res = gsm.msg->res = gsmOK;
+            } else {                            /* Or error status */
+                res = gsm.msg->res = res;       /* Set the error status */
+            }
+        } else {
+            ++gsm.msg->i;                       /* Number of continue calls */
+        }
+
+        /*
+         * When the command is finished,
+         * notify caller directly from this thread,
+         * then release synchronization semaphore
+         * to let producer thread start with next command
+         */
+        if (res != gsmCONT) {                   /* Do we have to continue to wait for command? */
+            gsmi_msg_complete(gsm.msg);         /* Finish message and wake up caller */
+            gsm_sys_sem_release(&gsm.sem_sync); /* Release semaphore */
+        }
+    }
+}
+
+/**
+ * \brief           Process readiness message from device
+ * \param[out]      is_ok: Pointer to OK status of active command, set when wait is finished
+ */
+static void
+gsmi_ready_received(uint8_t* is_ok) {
+    /*
+     * While probing, `AT` is sent again only after previous one timed out.
+     * Sending it now could leave more probes unanswered, which shifts replies of next commands
+     */
+    if (CMD_IS_CUR(GSM_CMD_READY_WAIT)) {
+        gsm_timeout_remove(gsmi_ready_timeout);
+        *is_ok = 1;                             /* Stop waiting */
+    }
+}
+
+/**
+ * \brief           Start new `AT` probe sequence
+ */
+static void
+gsmi_probe_start(void) {
+    ready_start_time = gsm_sys_now();
+    probe_sent = 0;
+    probe_settle = 0;
+}
+
+/**
+ * \brief           Wait for late replies of earlier `AT` probes after probe succeeded
+ *
+ * Probe is sent again when previous one timed out, but device may still answer it later.
+ * Command continues after one more probe interval, replies received meanwhile are discarded
+ *
+ * \return          `1` when command must wait, `0` when it may continue immediately
+ */
+static uint8_t
+gsmi_probe_settle(void) {
+    if (probe_sent <= 1) {
+        return 0;
+    }
+    probe_sent = 0;
+    gsm_timeout_remove(gsmi_ready_timeout);
+    probe_settle = gsm_timeout_add(GSM_CFG_READY_PROBE_INTERVAL, gsmi_ready_timeout, NULL) == gsmOK;
+    return probe_settle;
+}
+
+/**
+ * \brief           Timeout callback while waiting for device readiness
+ * \param[in]       arg: Custom argument, not used
+ */
+static void
+gsmi_ready_timeout(void* arg) {
+    GSM_UNUSED(arg);
+    if (gsm.msg == NULL) {
+        return;
+    }
+    if (probe_settle) {
+        probe_settle = 0;
+        gsmi_process_cmd_result(1, 0);          /* Late replies are over, continue */
+    } else if ((CMD_IS_CUR(GSM_CMD_READY_PROBE) && (gsm_sys_now() - ready_start_time) < GSM_CFG_READY_TIMEOUT)
+        || (CMD_IS_CUR(GSM_CMD_UART_PROBE) && (gsm_sys_now() - ready_start_time) < GSM_CFG_AT_PORT_BAUDRATE_PROBE_TIMEOUT)) {
+        gsm.msg->fn(gsm.msg);                   /* No response yet, probe again */
+#if GSM_CFG_AT_PORT_AUTOBAUD
+    } else if (CMD_IS_CUR(GSM_CMD_READY_PROBE)) {
+        gsmi_process_cmd_result(0, 1);          /* No response, search for baudrate */
+#endif /* GSM_CFG_AT_PORT_AUTOBAUD */
+    } else if (CMD_IS_CUR(GSM_CMD_UART_PROBE)) {
+        gsmi_process_cmd_result(0, 1);          /* No response at this baudrate */
+    } else if (CMD_IS_CUR(GSM_CMD_READY_PROBE) || CMD_IS_CUR(GSM_CMD_READY_WAIT)) {
+        gsmi_process_cmd_result(1, 0);          /* Continue as if device was ready */
+    }
+}
+
+/**
+ * \brief           Reconfigure AT port to new baudrate and restart probe
+ * \param[in]       baud: Baudrate to use
+ * \return          `1` on success, `0` when low-level driver rejected baudrate and previous one is kept
+ */
+static uint8_t
+gsmi_set_baudrate(uint32_t baud) {
+    uint32_t prev = gsm.ll.uart.baudrate;
+    uint8_t res = 1;
+
+    if (prev != baud) {
+        gsm.ll.uart.baudrate = baud;
+        if (gsm_ll_init(&gsm.ll) != gsmOK) {    /* Reconfigure low-level driver */
+            gsm.ll.uart.baudrate = prev;
+            gsm_ll_init(&gsm.ll);               /* Restore previous configuration */
+            res = 0;
+        }
+    }
+    gsmi_probe_start();
+    return res;
+}
+
+/**
+ * \brief           Send single `AT` probe and start timeout to wait for its reply
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+gsmi_probe_send(void) {
+    if (gsm_timeout_add(GSM_CFG_READY_PROBE_INTERVAL, gsmi_ready_timeout, NULL) != gsmOK) {
+        return gsmERRMEM;
+    }
+    probe_sent += probe_sent < 0xFF;
+    AT_PORT_SEND_BEGIN_AT();
+    AT_PORT_SEND_END_AT();
+    return gsmOK;
+}
+
+/**
+ * \brief           Get command to continue reset sequence after probe or baudrate detection
+ *
+ * Device is probed before `AT+CFUN=1,1` is sent, to detect its baudrate first.
+ * Reset command is sent only once, later probes continue with default commands
+ *
+ * \param[in]       msg: Pointer to reset message
+ * \return          Next command, member of \ref gsm_cmd_t enumeration
+ */
+static gsm_cmd_t
+gsmi_reset_cmd_next(gsm_msg_t* msg) {
+    if (!msg->msg.reset.probed) {
+        msg->msg.reset.probed = 1;
+        return GSM_CMD_RESET;                   /* Device responds, reset it now */
+    }
+    return GSM_CFG_AT_ECHO ? GSM_CMD_ATE1 : GSM_CMD_ATE0;
+}
+
+/**
+ * \brief           Get command to continue reset sequence when device responds
+ * \param[in]       msg: Pointer to reset message
+ * \return          Next command, member of \ref gsm_cmd_t enumeration
+ */
+static gsm_cmd_t
+gsmi_reset_cmd_after_probe(gsm_msg_t* msg) {
+#if GSM_CFG_AT_PORT_BAUDRATE_FAST
+    /* Switch to fast baudrate after reset, only once when device did not respond at it before */
+    if (msg->msg.reset.probed && gsm.ll.uart.baudrate != GSM_CFG_AT_PORT_BAUDRATE_FAST
+        && !msg->msg.reset.fallback) {
+        return GSM_CMD_UART;
+    }
+#endif /* GSM_CFG_AT_PORT_BAUDRATE_FAST */
+    return gsmi_reset_cmd_next(msg);
+}
+
+#if GSM_CFG_AT_PORT_AUTOBAUD
+
+/**
+ * \brief           Set next baudrate to try during baudrate detection
+ * \param[in]       msg: Pointer to reset message
+ * \return          `1` when new baudrate is set, `0` when all were tried and previous is restored
+ */
+static uint8_t
+gsmi_autobaud_next(gsm_msg_t* msg) {
+    while (msg->msg.reset.autobaud_idx < GSM_ARRAYSIZE(autobaud_rates)) {
+        uint32_t baud = autobaud_rates[msg->msg.reset.autobaud_idx++];
+        if (baud != msg->msg.reset.baudrate_prev    /* Previous one was already tried */
+            && gsmi_set_baudrate(baud)) {       /* Skip baudrates not supported by low-level driver */
+            return 1;
+        }
+    }
+    gsmi_set_baudrate(msg->msg.reset.baudrate_prev);
+    return 0;
+}
+
+#endif /* GSM_CFG_AT_PORT_AUTOBAUD */
+
+#if GSM_CFG_WARM_START
+
+/**
+ * \brief           Load stored profile and restore identity if it belongs to current device
+ * \note            Serial number must be already received from device
+ * \return          `1` when identity was restored, `0` otherwise
+ */
+static uint8_t
+gsmi_profile_restore(void) {
+    gsm_device_profile_t profile;
+
+    if (gsm.profile.load_fn == NULL || gsm.m.model_serial_number[0] == '\0') {
+        return 0;
+    }
+    GSM_MEMSET(&profile, 0x00, sizeof(profile));
+    if (!gsm.profile.load_fn(&profile) || profile.version != GSM_DEVICE_PROFILE_VERSION) {
+        return 0;
+    }
+    profile.model_serial_number[sizeof(profile.model_serial_number) - 1] = 0;
+    if (strcmp(profile.model_serial_number, gsm.m.model_serial_number)) {
+        return 0;                               /* Different device */
+    }
+    GSM_MEMCPY(gsm.m.model_manufacturer, profile.model_manufacturer, sizeof(gsm.m.model_manufacturer));
+    GSM_MEMCPY(gsm.m.model_number, profile.model_number, sizeof(gsm.m.model_number));
+    GSM_MEMCPY(gsm.m.model_revision, profile.model_revision, sizeof(gsm.m.model_revision));
+    gsm.m.model_manufacturer[sizeof(gsm.m.model_manufacturer) - 1] = 0;
+    gsm.m.model_number[sizeof(gsm.m.model_number) - 1] = 0;
+    gsm.m.model_revision[sizeof(gsm.m.model_revision) - 1] = 0;
+    gsm.m.model = profile.model;
+    return 1;
+}
+
+/**
+ * \brief           Save identity of current device to user storage
+ */
+static void
+gsmi_profile_store(void) {
+    gsm_device_profile_t profile;
+
+    if (gsm.profile.save_fn == NULL || gsm.m.model_serial_number[0] == '\0') {
+        return;
+    }
+    GSM_MEMSET(&profile, 0x00, sizeof(profile));
+    profile.version = GSM_DEVICE_PROFILE_VERSION;
+    GSM_MEMCPY(profile.model_manufacturer, gsm.m.model_manufacturer, sizeof(profile.model_manufacturer));
+    GSM_MEMCPY(profile.model_number, gsm.m.model_number, sizeof(profile.model_number));
+    GSM_MEMCPY(profile.model_serial_number, gsm.m.model_serial_number, sizeof(profile.model_serial_number));
+    GSM_MEMCPY(profile.model_revision, gsm.m.model_revision, sizeof(profile.model_revision));
+    profile.model = gsm.m.model;
+    gsm.profile.save_fn(&profile);
+}
+
+#endif /* GSM_CFG_WARM_START */
+
 /**
  * \brief           Process received string from GSM
  * \param[in]       rcv: Pointer to \ref gsm_recv_t structure with input string
@@ -701,6 +1384,12 @@ gsmi_parse_received(gsm_recv_t* rcv) {
         }
     }
 
+    /* Reply to earlier `AT` probe, received after probe already succeeded */
+    if (probe_settle && (is_ok || is_error) && gsm.msg != NULL
+        && (CMD_IS_CUR(GSM_CMD_READY_PROBE) || CMD_IS_CUR(GSM_CMD_UART_PROBE))) {
+        return;
+    }
+
     /* Scan received strings which start with '+' */
     if (rcv->data[0] == '+') {
         if (!strncmp(rcv->data, "+CSQ", 4)) {
@@ -709,6 +1398,9 @@ gsmi_parse_received(gsm_recv_t* rcv) {
         } else if (!strncmp(rcv->data, "+PDP: DEACT", 11)) {
             /* PDP has been deactivated */
             gsm_network_check_status(NULL, NULL, 0);/* Update status */
+        } else if (CMD_IS_CUR(GSM_CMD_CGATT_GET) && !strncmp(rcv->data, "+CGATT", 6)) {
+            const char* tmp = &rcv->data[8];
+            gsm.msg->msg.network_attach.gprs_attached = GSM_U8(gsmi_parse_number(&tmp));
 #endif /* GSM_CFG_NETWORK */
 #if GSM_CFG_CONN
         } else if (!strncmp(rcv->data, "+RECEIVE", 8)) {
@@ -716,8 +1408,15 @@ gsmi_parse_received(gsm_recv_t* rcv) {
 #endif /* GSM_CFG_CONN */
         } else if (!strncmp(rcv->data, "+CREG", 5)) {   /* Check for +CREG indication */
             gsmi_parse_creg(rcv->data, GSM_U8(CMD_IS_CUR(GSM_CMD_CREG_GET)));  /* Parse +CREG response */
+#if GSM_CFG_NETWORK_TRACKER
+        } else if (!strncmp(rcv->data, "+CGREG", 6)) {  /* Check for +CGREG indication */
+            gsmi_parse_cgreg(rcv->data, GSM_U8(CMD_IS_CUR(GSM_CMD_CGREG_GET)));/* Parse +CGREG response */
+#endif /* GSM_CFG_NETWORK_TRACKER */
         } else if (!strncmp(rcv->data, "+CPIN", 5)) {   /* Check for +CPIN indication for SIM */
             gsmi_parse_cpin(rcv->data, 1 /* !CMD_IS_DEF(GSM_CMD_CPIN_SET) */);  /* Parse +CPIN response */
+            if (gsm.m.sim.state == GSM_SIM_STATE_READY) {
+                gsmi_ready_received(&is_ok);
+            }
         } else if (CMD_IS_CUR(GSM_CMD_COPS_GET) && !strncmp(rcv->data, "+COPS", 5)) {
             gsmi_parse_cops(rcv->data);         /* Parse current +COPS */
 #if GSM_CFG_SMS
@@ -737,12 +1436,25 @@ gsmi_parse_received(gsm_recv_t* rcv) {
             }
         } else if (!strncmp(rcv->data, "+CMTI", 5)) {
             gsmi_parse_cmti(rcv->data, 1);      /* Parse +CMTI response with received SMS */
+#if GSM_CFG_SMS_DRAIN
+            gsmi_sms_drain_start(1);
+#endif /* GSM_CFG_SMS_DRAIN */
+#if GSM_CFG_SMS_DIRECT
+        } else if (!strncmp(rcv->data, "+CMT:", 5)) {
+            gsm.m.sms.direct_read = gsmi_parse_cmt(rcv->data);  /* Message data follows in next line */
+#endif /* GSM_CFG_SMS_DIRECT */
         } else if (CMD_IS_CUR(GSM_CMD_CPMS_GET_OPT) && !strncmp(rcv->data, "+CPMS", 5)) {
             gsmi_parse_cpms(rcv->data, 0);      /* Parse +CPMS with SMS memories info */
         } else if (CMD_IS_CUR(GSM_CMD_CPMS_GET) && !strncmp(rcv->data, "+CPMS", 5)) {
             gsmi_parse_cpms(rcv->data, 1);      /* Parse +CPMS with SMS memories info */
+#if GSM_CFG_SMS_DRAIN
+            gsmi_sms_drain_start(0);            /* Check receive storage usage */
+#endif /* GSM_CFG_SMS_DRAIN */
         } else if (CMD_IS_CUR(GSM_CMD_CPMS_SET) && !strncmp(rcv->data, "+CPMS", 5)) {
             gsmi_parse_cpms(rcv->data, 2);      /* Parse +CPMS with SMS memories info */
+#if GSM_CFG_SMS_DRAIN
+            gsmi_sms_drain_start(0);            /* Check receive storage usage */
+#endif /* GSM_CFG_SMS_DRAIN */
 #endif /* GSM_CFG_SMS */
 #if GSM_CFG_CALL
         } else if (!strncmp(rcv->data, "+CLCC", 5)) {
@@ -792,6 +1504,7 @@ gsmi_parse_received(gsm_recv_t* rcv) {
         } else if (rcv->data[0] == 'C' && !strncmp(rcv->data, "Call Ready" CRLF, 10 + CRLF_LEN)) {
             gsm.m.call.ready = 1;
             gsmi_send_cb(GSM_EVT_CALL_READY);   /* Send CALL ready event */
+            gsmi_ready_received(&is_ok);
         } else if (rcv->data[0] == 'R' && !strncmp(rcv->data, "RING" CRLF, 4 + CRLF_LEN)) {
             gsmi_send_cb(GSM_EVT_CALL_RING);    /* Send call ring */
         } else if (rcv->data[0] == 'N' && !strncmp(rcv->data, "NO CARRIER" CRLF, 10 + CRLF_LEN)) {
@@ -803,7 +1516,10 @@ gsmi_parse_received(gsm_recv_t* rcv) {
         } else if (rcv->data[0] == 'S' && !strncmp(rcv->data, "SMS Ready" CRLF, 9 + CRLF_LEN)) {
             gsm.m.sms.ready = 1;                /* SMS ready flag */
             gsmi_send_cb(GSM_EVT_SMS_READY);    /* Send SMS ready event */
+            gsmi_ready_received(&is_ok);
 #endif /* GSM_CFG_SMS */
+        } else if (rcv->data[0] == 'R' && !strncmp(rcv->data, "RDY" CRLF, 3 + CRLF_LEN)) {
+            gsmi_ready_received(&is_ok);        /* Device started after reset */
         } else if ((CMD_IS_CUR(GSM_CMD_CGMI_GET) || CMD_IS_CUR(GSM_CMD_CGMM_GET) || CMD_IS_CUR(GSM_CMD_CGSN_GET) || CMD_IS_CUR(GSM_CMD_CGMR_GET))
                     && !is_ok && !is_error && strncmp(rcv->data, "AT+", 3)) {
             const char* tmp = rcv->data;
@@ -952,28 +1668,7 @@ gsmi_parse_received(gsm_recv_t* rcv) {
      * and proceed with next command
      */
     if (is_ok || is_error) {
-        gsmr_t res = gsmOK;
-        if (gsm.msg != NULL) {                  /* Do we have active message? */
-            res = gsmi_process_sub_cmd(gsm.msg, &is_ok, &is_error);
-            if (res != gsmCONT) {               /* Shall we continue with next subcommand under this one? */
-                if (is_ok) {                    /* Check OK status */
-                    res = gsm.msg->res = gsmOK;
-                } else {                        /* Or error status */
-                    res = gsm.msg->res = res;   /* Set the error status */
-                }
-            } else {
-                ++gsm.msg->i;                   /* Number of continue calls */
-            }
-
-            /*
-             * When the command is finished,
-             * release synchronization semaphore
-             * from user thread and start with next command
-             */
-            if (res != gsmCONT) {                   /* Do we have to continue to wait for command? */
-                gsm_sys_sem_release(&gsm.sem_sync); /* Release semaphore */
-            }
-        }
+        gsmi_process_cmd_result(is_ok, is_error);
     }
 }
 
@@ -1133,6 +1828,23 @@ gsmi_process(const void* data, size_t data_len) {
                 gsmi_parse_cops_scan(ch, 0);    /* Parse character by character */
             }
 #if GSM_CFG_SMS
+#if GSM_CFG_SMS_DIRECT
+        } else if (gsm.m.sms.direct_read) {     /* Message data of +CMT */
+            gsmi_sms_direct_process(ch);
+#endif /* GSM_CFG_SMS_DIRECT */
+#if GSM_CFG_SMS_PDU
+        } else if (CMD_IS_CUR(GSM_CMD_CMGR) && gsm.msg->msg.sms_read.read && !gsm.msg->msg.sms_read.format) {
+            if (gsmi_sms_pdu_process(ch, gsm.msg->msg.sms_read.read == 2 ? gsm.msg->msg.sms_read.entry : NULL)) {
+                gsm.msg->msg.sms_read.read = 0;
+            }
+        } else if (CMD_IS_CUR(GSM_CMD_CMGL) && gsm.msg->msg.sms_list.read && !gsm.msg->msg.sms_list.format) {
+            if (gsmi_sms_pdu_process(ch, gsm.msg->msg.sms_list.read == 2 ? &gsm.msg->msg.sms_list.entries[gsm.msg->msg.sms_list.ei] : NULL)) {
+                if (gsm.msg->msg.sms_list.read == 2) {
+                    gsmi_sms_list_entry_done(gsm.msg);
+                }
+                gsm.msg->msg.sms_list.read = 0;
+            }
+#endif /* GSM_CFG_SMS_PDU */
         } else if (CMD_IS_CUR(GSM_CMD_CMGR) && gsm.msg->msg.sms_read.read) {
             gsm_sms_entry_t* e = gsm.msg->msg.sms_read.entry;
             if (gsm.msg->msg.sms_read.read == 2) {  /* Read only if set to 2 */
@@ -1159,10 +1871,7 @@ gsmi_process(const void* data, size_t data_len) {
             }
             if (ch == '\n' && ch_prev1 == '\r') {
                 if (gsm.msg->msg.sms_list.read == 2) {
-                    ++gsm.msg->msg.sms_list.ei; /* Go to next entry */
-                    if (gsm.msg->msg.sms_list.er != NULL) { /* Check and update user variable */
-                        *gsm.msg->msg.sms_list.er = gsm.msg->msg.sms_list.ei;
-                    }
+                    gsmi_sms_list_entry_done(gsm.msg);
                 }
                 gsm.msg->msg.sms_list.read = 0;
             }
@@ -1264,7 +1973,17 @@ gsmi_process(const void* data, size_t data_len) {
 #endif /* GSM_CFG_CONN */
 #if GSM_CFG_SMS
                         } else if (CMD_IS_CUR(GSM_CMD_CMGS)) {  /* Send SMS? */
+#if GSM_CFG_SMS_PDU
+                            if (!gsm.msg->msg.sms_send.format) {    /* Encode PDU directly to AT port */
+                                gsmi_sms_pdu_send(gsm.msg->msg.sms_send.num, &gsm.msg->msg.sms_send.text[gsm.msg->msg.sms_send.part_off],
+                                    gsm.msg->msg.sms_send.part_len, gsm.msg->msg.sms_send.dcs,
+                                    gsm.msg->msg.sms_send.udh, gsm.msg->msg.sms_send.udh_len, gsmi_send_sms_pdu_octet);
+                            } else {
+                                AT_PORT_SEND(gsm.msg->msg.sms_send.text, strlen(gsm.msg->msg.sms_send.text));
+                            }
+#else /* GSM_CFG_SMS_PDU */
                             AT_PORT_SEND(gsm.msg->msg.sms_send.text, strlen(gsm.msg->msg.sms_send.text));
+#endif /* !GSM_CFG_SMS_PDU */
                             AT_PORT_SEND_CTRL_Z();
                             AT_PORT_SEND_FLUSH();
 #endif /* GSM_CFG_SMS */
@@ -1292,16 +2011,223 @@ gsmi_process(const void* data, size_t data_len) {
                     for (uint8_t i = 0; i < unicode.t; ++i) {
                         RECV_ADD(unicode.ch[i]);/* Add character to receive array */
                     }
-                }
-            } else if (res != gsmINPROG) {      /* Not in progress? */
-                RECV_RESET();                   /* Invalid character in sequence */
+                }
+            } else if (res != gsmINPROG) {      /* Not in progress? */
+                RECV_RESET();                   /* Invalid character in sequence */
+            }
+        }
+
+        ch_prev2 = ch_prev1;                    /* Save previous character as previous previous */
+        ch_prev1 = ch;                          /* Set current as previous */
+    }
+    return gsmOK;
+}
+
+#if GSM_CFG_SMS || __DOXYGEN__
+
+/**
+ * \brief           Get SMS message format required by current command
+ * \param[in]       msg: Pointer to current message
+ * \return          `1` for text mode, `0` for PDU mode
+ */
+static uint8_t
+gsmi_sms_get_format(gsm_msg_t* msg) {
+    switch (msg->cmd_def) {
+        case GSM_CMD_CMGS:
+        case GSM_CMD_SMS_SEND_BATCH: return !!msg->msg.sms_send.format;
+        case GSM_CMD_CMGR: return !!msg->msg.sms_read.format;
+        case GSM_CMD_SMS_ENABLE: return !GSM_CFG_SMS_PDU;   /* Default format of API */
+        case GSM_CMD_CMGL:
+        case GSM_CMD_SMS_DRAIN: return !!msg->msg.sms_list.format;
+        default: return 1;                      /* Used for all other operations like delete all messages, etc */
+    }
+}
+
+/**
+ * \brief           Get SMS operation memory required by current command
+ * \param[in]       msg: Pointer to current message
+ * \return          Member of \ref gsm_mem_t enumeration
+ */
+static gsm_mem_t
+gsmi_sms_get_mem(gsm_msg_t* msg) {
+    gsm_mem_t mem;
+    switch (msg->cmd_def) {
+        case GSM_CMD_CMGR: mem = msg->msg.sms_read.mem; break;
+        case GSM_CMD_CMGD: mem = msg->msg.sms_delete.mem; break;
+        case GSM_CMD_CMGL: mem = msg->msg.sms_list.mem; break;
+        case GSM_CMD_SMS_DRAIN: return gsm.m.sms.mem[2].current;   /* Receive storage */
+        default: mem = GSM_MEM_CURRENT; break;
+    }
+    return mem == GSM_MEM_CURRENT ? gsm.m.sms.mem[0].current : mem;
+}
+
+#endif /* GSM_CFG_SMS || __DOXYGEN__ */
+
+#if GSM_CFG_NETWORK || __DOXYGEN__
+
+/**
+ * \brief           Calculate hash of APN settings of network attach command
+ * \param[in]       msg: Pointer to current message
+ * \return          Hash value
+ */
+static uint32_t
+gsmi_network_apn_hash(gsm_msg_t* msg) {
+    const char* strs[] = { msg->msg.network_attach.apn, msg->msg.network_attach.user, msg->msg.network_attach.pass };
+    uint32_t h = 5381;
+
+    for (size_t i = 0; i < GSM_ARRAYSIZE(strs); ++i) {
+        for (const char* s = strs[i]; s != NULL && *s != '\0'; ++s) {
+            h = ((h << 5) + h) + (uint8_t)*s;
+        }
+        h = ((h << 5) + h);                     /* Separator between strings */
+    }
+    return h;
+}
+
+#endif /* GSM_CFG_NETWORK || __DOXYGEN__ */
+
+#if GSM_CFG_PHONEBOOK || __DOXYGEN__
+
+/**
+ * \brief           Get phonebook memory required by current command
+ * \param[in]       msg: Pointer to current message
+ * \return          Member of \ref gsm_mem_t enumeration
+ */
+static gsm_mem_t
+gsmi_pb_get_mem(gsm_msg_t* msg) {
+    gsm_mem_t mem;
+    switch (msg->cmd_def) {
+        case GSM_CMD_CPBW_SET: mem = msg->msg.pb_write.mem; break;
+        case GSM_CMD_CPBR: mem = msg->msg.pb_list.mem; break;
+        case GSM_CMD_CPBF: mem = msg->msg.pb_search.mem; break;
+#if GSM_CFG_PHONEBOOK_CACHE
+        case GSM_CMD_PB_CACHE_LOAD: mem = msg->msg.pb_list.mem; break;
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
+        default: mem = GSM_MEM_CURRENT; break;
+    }
+    return mem == GSM_MEM_CURRENT ? gsm.m.pb.mem.current : mem;
+}
+
+#endif /* GSM_CFG_PHONEBOOK || __DOXYGEN__ */
+
+/**
+ * \brief           Update cached modem mode state after command finished
+ * \param[in]       msg: Pointer to current message
+ * \param[in]       is_ok: Set to `1` when command finished with OK
+ */
+static void
+gsmi_cmd_state_update(gsm_msg_t* msg, uint8_t is_ok) {
+    switch (msg->cmd) {
+#if GSM_CFG_SMS
+        case GSM_CMD_CMGF: {
+            gsm.m.sms.format = gsmi_sms_get_format(msg);
+            gsm.m.sms.format_valid = is_ok;
+            break;
+        }
+        case GSM_CMD_CPMS_GET: {
+            gsm.m.sms.mem_valid = is_ok;        /* All memories were parsed from response */
+            break;
+        }
+        case GSM_CMD_CPMS_SET: {
+            if (!is_ok) {
+                gsm.m.sms.mem_valid = 0;
+            } else if (msg->cmd_def == GSM_CMD_CPMS_SET) {
+                for (size_t i = 0; i < GSM_ARRAYSIZE(gsm.m.sms.mem); ++i) {
+                    if (msg->msg.sms_memory.mem[i] != GSM_MEM_CURRENT) {
+                        gsm.m.sms.mem[i].current = msg->msg.sms_memory.mem[i];
+                    }
+                }
+            } else {
+                gsm.m.sms.mem[0].current = gsmi_sms_get_mem(msg);
+            }
+            break;
+        }
+#endif /* GSM_CFG_SMS */
+#if GSM_CFG_PHONEBOOK
+        case GSM_CMD_CPBS_GET: {
+            gsm.m.pb.mem_valid = is_ok;
+            break;
+        }
+        case GSM_CMD_CPBS_SET: {
+            if (is_ok) {
+                gsm.m.pb.mem.current = gsmi_pb_get_mem(msg);
+            }
+            gsm.m.pb.mem_valid = is_ok;
+            break;
+        }
+#endif /* GSM_CFG_PHONEBOOK */
+        default:
+            GSM_UNUSED(is_ok);
+            break;
+    }
+}
+
+/**
+ * \brief           Check if current command would only set modem to state it is already in
+ * \note            Only preparation commands of longer sequences are considered
+ * \param[in]       msg: Pointer to current message
+ * \return          `1` if command may be skipped, `0` otherwise
+ */
+static uint8_t
+gsmi_cmd_is_redundant(gsm_msg_t* msg) {
+    switch (msg->cmd) {
+#if GSM_CFG_SMS
+        case GSM_CMD_CMGF: {
+            switch (msg->cmd_def) {
+                case GSM_CMD_CMGS:
+                case GSM_CMD_SMS_SEND_BATCH:
+                case GSM_CMD_CMGR:
+                case GSM_CMD_CMGL:
+                case GSM_CMD_CMGDA:
+                case GSM_CMD_SMS_DRAIN:
+                    return gsm.m.sms.format_valid && gsm.m.sms.format == gsmi_sms_get_format(msg);
+                default: break;
+            }
+            break;
+        }
+        case GSM_CMD_CPMS_GET:
+        case GSM_CMD_CPMS_SET: {
+            switch (msg->cmd_def) {
+                case GSM_CMD_CMGR:
+                case GSM_CMD_CMGD:
+                case GSM_CMD_CMGL:
+                case GSM_CMD_SMS_DRAIN:
+#if GSM_CFG_SMS_DRAIN
+                    if (msg->cmd == GSM_CMD_CPMS_GET) {
+                        return 0;               /* Always query to refresh storage usage for drain watermark */
+                    }
+#endif /* GSM_CFG_SMS_DRAIN */
+                    return gsm.m.sms.mem_valid
+                        && (msg->cmd == GSM_CMD_CPMS_GET || gsm.m.sms.mem[0].current == gsmi_sms_get_mem(msg));
+                case GSM_CMD_CPMS_SET:
+                    return gsm.m.sms.mem_valid && msg->cmd == GSM_CMD_CPMS_GET;
+                default: break;
             }
+            break;
         }
-
-        ch_prev2 = ch_prev1;                    /* Save previous character as previous previous */
-        ch_prev1 = ch;                          /* Set current as previous */
+#endif /* GSM_CFG_SMS */
+#if GSM_CFG_PHONEBOOK
+        case GSM_CMD_CPBS_GET:
+        case GSM_CMD_CPBS_SET: {
+            switch (msg->cmd_def) {
+                case GSM_CMD_CPBW_SET:
+                case GSM_CMD_CPBR:
+                case GSM_CMD_CPBF:
+                    return gsm.m.pb.mem_valid
+                        && (msg->cmd == GSM_CMD_CPBS_GET || gsm.m.pb.mem.current == gsmi_pb_get_mem(msg));
+#if GSM_CFG_PHONEBOOK_CACHE
+                case GSM_CMD_PB_CACHE_LOAD:     /* Always query memory to get fresh used/total values */
+                    return gsm.m.pb.mem_valid && msg->cmd == GSM_CMD_CPBS_SET
+                        && gsm.m.pb.mem.current == gsmi_pb_get_mem(msg);
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
+                default: break;
+            }
+            break;
+        }
+#endif /* GSM_CFG_PHONEBOOK */
+        default: break;
     }
-    return gsmOK;
+    return 0;
 }
 
 /* Temporary macros, only available for inside gsmi_process_sub_cmd function */
@@ -1327,21 +2253,115 @@ gsmi_process(const void* data, size_t data_len) {
 static gsmr_t
 gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
     gsm_cmd_t n_cmd = GSM_CMD_IDLE;
+
+    gsmi_cmd_state_update(msg, *is_ok);         /* Track modem mode state */
+#if GSM_CFG_CMD_SUSPEND
+    /* Modem may finish aborted command with OK and truncated result, repeat it in any case */
+    if (msg->suspend_req && msg->cmd == msg->cmd_def) {
+        msg->suspended = 1;                     /* Aborted by us, producer thread repeats it */
+        msg->cmd = GSM_CMD_IDLE;
+        return gsmERR;
+    }
+#endif /* GSM_CFG_CMD_SUSPEND */
     if (CMD_IS_DEF(GSM_CMD_RESET)) {
         switch (CMD_GET_CUR()) {                /* Check current command */
             case GSM_CMD_RESET: {
                 gsmi_reset_everything(1);       /* Reset everything */
-                SET_NEW_CMD(GSM_CFG_AT_ECHO ? GSM_CMD_ATE1 : GSM_CMD_ATE0); /* Set ECHO mode */
-                gsm_delay(5000);                /* Delay for some time before we can continue after reset */
+                gsmi_probe_start();
+                SET_NEW_CMD(GSM_CMD_READY_PROBE);   /* Wait for device to start */
+                break;
+            }
+            case GSM_CMD_READY_PROBE: {
+                gsm_timeout_remove(gsmi_ready_timeout);
+                if (*is_ok && gsmi_probe_settle()) {
+                    return gsmCONT;             /* Wait for replies of earlier probes first */
+                }
+#if GSM_CFG_AT_PORT_AUTOBAUD
+                if (!*is_ok) {                  /* No response at current baudrate */
+                    msg->msg.reset.baudrate_prev = gsm.ll.uart.baudrate;
+                    msg->msg.reset.autobaud = 1;
+                    msg->msg.reset.autobaud_idx = 0;
+                    if (gsmi_autobaud_next(msg)) {
+                        SET_NEW_CMD(GSM_CMD_UART_PROBE);
+                        break;
+                    }
+                }
+#endif /* GSM_CFG_AT_PORT_AUTOBAUD */
+                SET_NEW_CMD(gsmi_reset_cmd_after_probe(msg));   /* Set ECHO mode or switch baudrate */
+                break;
+            }
+            case GSM_CMD_UART: {
+                if (*is_ok) {                   /* Device accepted new baudrate */
+                    msg->msg.reset.autobaud = 0;
+                    msg->msg.reset.baudrate_prev = gsm.ll.uart.baudrate;
+                    if (!gsmi_set_baudrate(GSM_CFG_AT_PORT_BAUDRATE_FAST)) {
+                        msg->msg.reset.fallback = 1;    /* Host stays at previous baudrate, check device there */
+                    }
+                    SET_NEW_CMD(GSM_CMD_UART_PROBE);
+                } else {
+                    SET_NEW_CMD(GSM_CFG_AT_ECHO ? GSM_CMD_ATE1 : GSM_CMD_ATE0); /* Stay at current baudrate */
+                }
+                break;
+            }
+            case GSM_CMD_UART_PROBE: {
+                gsm_timeout_remove(gsmi_ready_timeout);
+                if (*is_ok) {
+                    if (gsmi_probe_settle()) {
+                        return gsmCONT;         /* Wait for replies of earlier probes first */
+                    }
+                    SET_NEW_CMD(gsmi_reset_cmd_after_probe(msg));
+#if GSM_CFG_AT_PORT_AUTOBAUD
+                } else if (msg->msg.reset.autobaud) {
+                    if (gsmi_autobaud_next(msg)) {
+                        SET_NEW_CMD(GSM_CMD_UART_PROBE);    /* Try next baudrate */
+                    } else {
+                        SET_NEW_CMD(gsmi_reset_cmd_next(msg));
+                    }
+#endif /* GSM_CFG_AT_PORT_AUTOBAUD */
+                } else if (!msg->msg.reset.fallback) {
+                    /* Device accepted new baudrate but does not respond, it may not have switched */
+                    msg->msg.reset.fallback = 1;
+                    gsmi_set_baudrate(msg->msg.reset.baudrate_prev);
+                    SET_NEW_CMD(GSM_CMD_UART_PROBE);
+                } else {
+#if GSM_CFG_AT_PORT_AUTOBAUD
+                    /* Device does not respond at any of both baudrates, search for it */
+                    msg->msg.reset.baudrate_prev = gsm.ll.uart.baudrate;
+                    msg->msg.reset.autobaud = 1;
+                    msg->msg.reset.autobaud_idx = 0;
+                    if (gsmi_autobaud_next(msg)) {
+                        SET_NEW_CMD(GSM_CMD_UART_PROBE);
+                        break;
+                    }
+#else /* GSM_CFG_AT_PORT_AUTOBAUD */
+                    gsmi_set_baudrate(GSM_CFG_AT_PORT_BAUDRATE_FAST);   /* Device accepted it last */
+#endif /* !GSM_CFG_AT_PORT_AUTOBAUD */
+                    SET_NEW_CMD(GSM_CFG_AT_ECHO ? GSM_CMD_ATE1 : GSM_CMD_ATE0);
+                }
                 break;
             }
             case GSM_CMD_ATE0:
             case GSM_CMD_ATE1:      SET_NEW_CMD(GSM_CMD_CFUN_SET); break;   /* Set full functionality */
             case GSM_CMD_CFUN_SET:  SET_NEW_CMD(GSM_CMD_CMEE_SET); break;   /* Set detailed error reporting */
+#if GSM_CFG_WARM_START
+            case GSM_CMD_CMEE_SET:  SET_NEW_CMD(GSM_CMD_CGSN_GET); break;   /* Get product serial number to check profile */
+            case GSM_CMD_CGSN_GET: {
+                if (gsmi_profile_restore()) {   /* Same device as last time? */
+                    gsmi_send_cb(GSM_EVT_DEVICE_IDENTIFIED);
+                    SET_NEW_CMD(GSM_CMD_CREG_SET);  /* Enable unsolicited code for CREG */
+                } else {
+                    SET_NEW_CMD(GSM_CMD_CGMI_GET);  /* Get manufacturer */
+                }
+                break;
+            }
+            case GSM_CMD_CGMI_GET:  SET_NEW_CMD(GSM_CMD_CGMM_GET); break;   /* Get model */
+            case GSM_CMD_CGMM_GET:  SET_NEW_CMD(GSM_CMD_CGMR_GET); break;   /* Get product revision */
+#else /* GSM_CFG_WARM_START */
             case GSM_CMD_CMEE_SET:  SET_NEW_CMD(GSM_CMD_CGMI_GET); break;   /* Get manufacturer */
             case GSM_CMD_CGMI_GET:  SET_NEW_CMD(GSM_CMD_CGMM_GET); break;   /* Get model */
             case GSM_CMD_CGMM_GET:  SET_NEW_CMD(GSM_CMD_CGSN_GET); break;   /* Get product serial number */
             case GSM_CMD_CGSN_GET:  SET_NEW_CMD(GSM_CMD_CGMR_GET); break;   /* Get product revision */
+#endif /* !GSM_CFG_WARM_START */
             case GSM_CMD_CGMR_GET: {
                 /*
                  * At this point we have modem info.
@@ -1349,11 +2369,21 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
                  * to select between device drivers
                  */
                 gsmi_send_cb(GSM_EVT_DEVICE_IDENTIFIED);
+#if GSM_CFG_WARM_START
+                gsmi_profile_store();           /* Keep identity for next reset */
+#endif /* GSM_CFG_WARM_START */
 
                 SET_NEW_CMD(GSM_CMD_CREG_SET);      /* Enable unsolicited code for CREG */
                 break;
             }
+#if GSM_CFG_NETWORK_TRACKER
+            case GSM_CMD_CREG_SET: SET_NEW_CMD(GSM_CMD_CREG_GET); break;/* Get initial registration */
+            case GSM_CMD_CREG_GET: SET_NEW_CMD(GSM_CMD_CGREG_SET); break;   /* Enable unsolicited code for CGREG */
+            case GSM_CMD_CGREG_SET: SET_NEW_CMD(GSM_CMD_CGREG_GET); break;  /* Get initial GPRS registration */
+            case GSM_CMD_CGREG_GET: SET_NEW_CMD(GSM_CMD_CLCC_SET); break;   /* Set call state */
+#else /* GSM_CFG_NETWORK_TRACKER */
             case GSM_CMD_CREG_SET: SET_NEW_CMD(GSM_CMD_CLCC_SET); break;/* Set call state */
+#endif /* !GSM_CFG_NETWORK_TRACKER */
             case GSM_CMD_CLCC_SET: SET_NEW_CMD(GSM_CMD_CPIN_GET); break;/* Get SIM state */
             case GSM_CMD_CPIN_GET: break;
             default: break;
@@ -1363,8 +2393,34 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
         if (n_cmd == GSM_CMD_IDLE) {
             RESET_SEND_EVT(msg, gsmOK);
         }
+    } else if (CMD_IS_DEF(GSM_CMD_UART)) {
+        if (CMD_IS_CUR(GSM_CMD_UART) && *is_ok) {  /* Device accepted new baudrate */
+            msg->msg.uart.baudrate_prev = gsm.ll.uart.baudrate;
+            if (!gsmi_set_baudrate(msg->msg.uart.baudrate)) {
+                msg->msg.uart.fallback = 1;     /* Host stays at previous baudrate, check device there */
+            }
+            SET_NEW_CMD(GSM_CMD_UART_PROBE);
+        } else if (CMD_IS_CUR(GSM_CMD_UART_PROBE)) {
+            gsm_timeout_remove(gsmi_ready_timeout);
+            if (*is_ok) {
+                if (gsmi_probe_settle()) {
+                    return gsmCONT;             /* Wait for replies of earlier probes first */
+                }
+                *is_ok = !msg->msg.uart.fallback;   /* Device responds, but at previous baudrate */
+            } else if (!msg->msg.uart.fallback) {
+                /* Device accepted new baudrate but does not respond, it may not have switched */
+                msg->msg.uart.fallback = 1;
+                gsmi_set_baudrate(msg->msg.uart.baudrate_prev);
+                SET_NEW_CMD(GSM_CMD_UART_PROBE);
+            } else {
+                gsmi_set_baudrate(msg->msg.uart.baudrate);  /* Device accepted it last */
+            }
+        }
     } else if (CMD_IS_DEF(GSM_CMD_COPS_GET)) {
         if (CMD_IS_CUR(GSM_CMD_COPS_GET)) {
+            if (*is_ok && msg->msg.cops_get.curr != NULL && msg->msg.cops_get.curr != &gsm.m.network.curr_operator) {
+                GSM_MEMCPY(msg->msg.cops_get.curr, &gsm.m.network.curr_operator, sizeof(*msg->msg.cops_get.curr));
+            }
             gsm.evt.evt.operator_current.operator_current = &gsm.m.network.curr_operator;
             gsmi_send_cb(GSM_EVT_NETWORK_OPERATOR_CURRENT);
         }
@@ -1379,11 +2435,12 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
                     /* Sometimes SIM is not ready just after PIN entered */
                     if (msg->msg.sim_info.cnum_tries < 5) {
                         ++msg->msg.sim_info.cnum_tries;
-                        SET_NEW_CMD(GSM_CMD_CNUM);
-                        gsm_delay(1000);
+                        SET_NEW_CMD(GSM_CMD_READY_WAIT);    /* Wait for device to report ready */
                     }
                 }
+                break;
             }
+            case GSM_CMD_READY_WAIT: SET_NEW_CMD(GSM_CMD_CNUM); break;  /* Try again */
             default: break;
         }
     } else if (CMD_IS_DEF(GSM_CMD_CPIN_SET)) {  /* Set PIN code */
@@ -1398,8 +2455,8 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
                 break;
             }
             case GSM_CMD_CPIN_SET: {            /* Set CPIN */
-                if (*is_ok) {
-                    gsm_delay(5000);            /* Make delay to make sure SIM is ready */
+                if (*is_ok && gsm.m.sim.state != GSM_SIM_STATE_READY) {
+                    SET_NEW_CMD(GSM_CMD_READY_WAIT);    /* Wait for +CPIN: READY */
                 }
                 break;
             }
@@ -1410,7 +2467,13 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
     } else if (CMD_IS_DEF(GSM_CMD_SMS_ENABLE)) {
         switch (CMD_GET_CUR()) {
             case GSM_CMD_CPMS_GET_OPT: SET_NEW_CMD(GSM_CMD_CPMS_GET); break;
+#if GSM_CFG_SMS_DIRECT
+            case GSM_CMD_CPMS_GET: SET_NEW_CMD(GSM_CMD_CMGF); break;   /* Set known format for +CMT data */
+            case GSM_CMD_CMGF: SET_NEW_CMD(GSM_CMD_CNMI); break;   /* Deliver new messages directly */
+            case GSM_CMD_CNMI: break;
+#else /* GSM_CFG_SMS_DIRECT */
             case GSM_CMD_CPMS_GET: break;
+#endif /* !GSM_CFG_SMS_DIRECT */
             default: break;
         }
         if (!*is_ok || n_cmd == GSM_CMD_IDLE) { /* Stop execution on any command */
@@ -1418,16 +2481,50 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
             gsm.m.sms.enabled = n_cmd == GSM_CMD_IDLE;  /* Set enabled status */
             gsm.evt.evt.sms_enable.status = gsm.m.sms.enabled ? gsmOK : gsmERR;
             gsmi_send_cb(GSM_EVT_SMS_ENABLE);   /* Send to user */
+#if GSM_CFG_SMS_DRAIN
+            gsmi_sms_drain_start(0);            /* Storage may be full already */
+#endif /* GSM_CFG_SMS_DRAIN */
         }
     } else if (CMD_IS_DEF(GSM_CMD_CMGS)) {      /* Send SMS default command */
         if (CMD_IS_CUR(GSM_CMD_CMGF) && *is_ok) {   /* Set message format current command */
             SET_NEW_CMD(GSM_CMD_CMGS);          /* Now send actual message */
+#if GSM_CFG_SMS_CONCAT
+        } else if (CMD_IS_CUR(GSM_CMD_CMGS) && *is_ok && !gsm.msg->msg.sms_send.format
+                    && (gsm.msg->msg.sms_send.part + 1) < gsm.msg->msg.sms_send.parts) {
+            gsm.msg->msg.sms_send.part_off += gsm.msg->msg.sms_send.part_len;
+            ++gsm.msg->msg.sms_send.part;
+            SET_NEW_CMD(GSM_CMD_CMGS);          /* Send next part of concatenated message */
+#endif /* GSM_CFG_SMS_CONCAT */
         }
 
         /* Send event on finish */
         if (n_cmd == GSM_CMD_IDLE) {
             SMS_SEND_SEND_EVT(gsm.msg, *is_ok ? gsmOK : gsmERR);
         }
+    } else if (CMD_IS_DEF(GSM_CMD_SMS_SEND_BATCH)) {/* Send multiple SMS messages */
+        if (CMD_IS_CUR(GSM_CMD_CMGF) && *is_ok) {   /* Format is set once for all messages */
+            SET_NEW_CMD(GSM_CMD_CMMS);          /* Keep relay link open between messages */
+        } else if (CMD_IS_CUR(GSM_CMD_CMMS) && msg->msg.sms_send.index == 0) {
+            gsmi_sms_batch_load(msg);           /* Result is ignored, not all networks support it */
+            SET_NEW_CMD(GSM_CMD_CMGS);
+        } else if (CMD_IS_CUR(GSM_CMD_CMMS)) {  /* Link release after last message */
+            *is_ok = msg->msg.sms_send.failed == 0;
+#if GSM_CFG_SMS_CONCAT
+        } else if (CMD_IS_CUR(GSM_CMD_CMGS) && *is_ok && !msg->msg.sms_send.format
+                    && (msg->msg.sms_send.part + 1) < msg->msg.sms_send.parts) {
+            msg->msg.sms_send.part_off += msg->msg.sms_send.part_len;
+            ++msg->msg.sms_send.part;
+            SET_NEW_CMD(GSM_CMD_CMGS);          /* Send next part of concatenated message */
+#endif /* GSM_CFG_SMS_CONCAT */
+        } else if (CMD_IS_CUR(GSM_CMD_CMGS)) {
+            gsmi_sms_batch_entry_done(msg, *is_ok ? gsmOK : gsmERR);
+            if (++msg->msg.sms_send.index < msg->msg.sms_send.count) {
+                gsmi_sms_batch_load(msg);
+                SET_NEW_CMD(GSM_CMD_CMGS);      /* Failed message does not stop batch */
+            } else {
+                SET_NEW_CMD(GSM_CMD_CMMS);
+            }
+        }
     } else if (CMD_IS_DEF(GSM_CMD_CMGR)) {      /* Read SMS message */
         if (CMD_IS_CUR(GSM_CMD_CPMS_GET) && *is_ok) {
             SET_NEW_CMD(GSM_CMD_CPMS_SET);      /* Set memory */
@@ -1475,6 +2572,28 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
         if (CMD_IS_CUR(GSM_CMD_CPMS_GET) && *is_ok) {
             SET_NEW_CMD(GSM_CMD_CPMS_SET);      /* Now set the command */
         }
+#if GSM_CFG_SMS_DRAIN
+    } else if (CMD_IS_DEF(GSM_CMD_SMS_DRAIN)) { /* Drain receive storage */
+        if (CMD_IS_CUR(GSM_CMD_CPMS_GET) && *is_ok) {
+            SET_NEW_CMD(GSM_CMD_CPMS_SET);      /* Select receive storage for operations */
+        } else if (CMD_IS_CUR(GSM_CMD_CPMS_SET) && *is_ok) {
+            SET_NEW_CMD(GSM_CMD_CMGF);
+        } else if (CMD_IS_CUR(GSM_CMD_CMGF) && *is_ok) {
+            gsm.m.sms.drain_cnt = 0;
+            gsm.m.sms.drain_del = 0;
+            SET_NEW_CMD(GSM_CMD_CMGL);          /* List unread messages */
+        } else if ((CMD_IS_CUR(GSM_CMD_CMGL) || CMD_IS_CUR(GSM_CMD_CMGD)) && *is_ok) {
+            if (CMD_IS_CUR(GSM_CMD_CMGD)) {
+                gsm.m.sms.drain_del = GSM_MIN(gsm.m.sms.drain_del + SMS_DRAIN_DEL_PER_CMD, gsm.m.sms.drain_cnt);
+            }
+            if (gsm.m.sms.drain_del < gsm.m.sms.drain_cnt) {
+                SET_NEW_CMD(GSM_CMD_CMGD);      /* Delete next group of reported messages */
+            }
+        }
+        if (n_cmd == GSM_CMD_IDLE) {
+            gsmi_sms_drain_finish();
+        }
+#endif /* GSM_CFG_SMS_DRAIN */
 #endif /* GSM_CFG_SMS */
 #if GSM_CFG_CALL
     } else if (CMD_IS_DEF(GSM_CMD_CALL_ENABLE)) {
@@ -1492,6 +2611,11 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
             SET_NEW_CMD(GSM_CMD_CPBS_SET);      /* Set current memory */
         } else if (CMD_IS_CUR(GSM_CMD_CPBS_SET) && *is_ok) {
             SET_NEW_CMD(GSM_CMD_CPBW_SET);      /* Write entry to phonebook */
+#if GSM_CFG_PHONEBOOK_CACHE
+        } else if (CMD_IS_CUR(GSM_CMD_CPBW_SET) && *is_ok) {
+            gsmi_pb_cache_write(gsm.m.pb.mem.current, msg->msg.pb_write.pos, msg->msg.pb_write.name,
+                msg->msg.pb_write.num, msg->msg.pb_write.type, msg->msg.pb_write.del);
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
         }
     } else if (CMD_IS_DEF(GSM_CMD_CPBR)) {
         if (CMD_IS_CUR(GSM_CMD_CPBS_GET) && *is_ok) {/* Get current memory */
@@ -1518,28 +2642,84 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
             gsm.evt.evt.pb_search.res = *is_ok ? gsmOK : gsmERR;
             gsmi_send_cb(GSM_EVT_PB_SEARCH);
         }
+#if GSM_CFG_PHONEBOOK_CACHE
+    } else if (CMD_IS_DEF(GSM_CMD_PB_CACHE_LOAD)) {
+        if (CMD_IS_CUR(GSM_CMD_CPBS_SET) && *is_ok) {
+            SET_NEW_CMD(GSM_CMD_CPBS_GET);      /* Get used and total entries */
+        } else if (CMD_IS_CUR(GSM_CMD_CPBS_GET) && *is_ok) {
+            SET_NEW_CMD(GSM_CMD_CPBR);          /* Read all entries */
+        } else if (CMD_IS_CUR(GSM_CMD_CPBR) && *is_ok) {
+            gsmi_pb_cache_loaded(msg->msg.pb_list.ei);
+        }
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
 #endif /* GSM_CFG_PHONEBOOK */
 #if GSM_CFG_NETWORK
     } if (CMD_IS_DEF(GSM_CMD_NETWORK_ATTACH)) {
-        switch (msg->i) {
-            case 0: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CGACT_SET_0); break;
-            case 1: SET_NEW_CMD(GSM_CMD_CGACT_SET_1); break;
+        /*
+         * Attach starts with state query and continues from the first missing step.
+         * Full sequence, including deliberate detach, is only used
+         * when state is unknown, bearer was lost or APN settings changed
+         */
+        switch (CMD_GET_CUR()) {
+#if GSM_CFG_CONN
+            case GSM_CMD_CIPSTATUS: {
+                uint8_t same_apn;
+                if (msg->i > 0) {               /* Final status check */
+                    break;
+                }
+                same_apn = gsm.m.network.apn_valid && gsm.m.network.apn_hash == gsmi_network_apn_hash(msg);
+                if (!*is_ok) {
+                    SET_NEW_CMD(GSM_CMD_CGACT_SET_0);
+                } else if (same_apn && gsm.m.network.ip_state == GSM_IP_STATE_READY) {
+                    if (gsm.m.network.ip_addr.ip[0] == 0) {
+                        SET_NEW_CMD(GSM_CMD_CIFSR); /* Only IP address is missing */
+                    }
+                } else if (same_apn && gsm.m.network.ip_state == GSM_IP_STATE_GPRSACT) {
+                    SET_NEW_CMD(GSM_CMD_CIFSR);
+                } else if (same_apn && gsm.m.network.ip_state == GSM_IP_STATE_START) {
+                    SET_NEW_CMD(GSM_CMD_CIICR);
+                } else if (gsm.m.network.ip_state == GSM_IP_STATE_INITIAL) {
+                    SET_NEW_CMD(GSM_CMD_CGATT_GET); /* Stack is clean, check GPRS attach */
+                } else {
+                    SET_NEW_CMD(GSM_CMD_CGACT_SET_0);
+                }
+                break;
+            }
+#endif /* GSM_CFG_CONN */
+            case GSM_CMD_CGATT_GET: {
+                if (*is_ok && msg->msg.network_attach.gprs_attached) {
+#if GSM_CFG_CONN
+                    SET_NEW_CMD(GSM_CMD_CIPMUX_SET);/* Already in IP INITIAL, skip teardown */
+#else /* GSM_CFG_CONN */
+                    SET_NEW_CMD(GSM_CMD_CIPSHUT);   /* Skip detach part */
+#endif /* !GSM_CFG_CONN */
+                } else {
+                    SET_NEW_CMD(GSM_CMD_CGACT_SET_0);
+                }
+                break;
+            }
+            case GSM_CMD_CGACT_SET_0: SET_NEW_CMD(GSM_CMD_CGACT_SET_1); break;
 #if GSM_CFG_NETWORK_IGNORE_CGACT_RESULT
-            case 2: SET_NEW_CMD(GSM_CMD_CGATT_SET_0); break;
+            case GSM_CMD_CGACT_SET_1: SET_NEW_CMD(GSM_CMD_CGATT_SET_0); break;
 #else /* GSM_CFG_NETWORK_IGNORE_CGACT_RESULT */
-            case 2: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CGATT_SET_0); break;
+            case GSM_CMD_CGACT_SET_1: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CGATT_SET_0); break;
 #endif /* !GSM_CFG_NETWORK_IGNORE_CGACT_RESULT */
-            case 3: SET_NEW_CMD(GSM_CMD_CGATT_SET_1); break;
-            case 4: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CIPSHUT); break;
-            case 5: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CIPMUX_SET); break;
-            case 6: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CIPRXGET_SET); break;
-            case 7: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CSTT_SET); break;
-            case 8: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CIICR); break;
-            case 9: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CIFSR); break;
-            case 10: SET_NEW_CMD(GSM_CMD_CIPSTATUS); break;
+            case GSM_CMD_CGATT_SET_0: SET_NEW_CMD(GSM_CMD_CGATT_SET_1); break;
+            case GSM_CMD_CGATT_SET_1: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CIPSHUT); break;
+            case GSM_CMD_CIPSHUT: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CIPMUX_SET); break;
+            case GSM_CMD_CIPMUX_SET: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CIPRXGET_SET); break;
+            case GSM_CMD_CIPRXGET_SET: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CSTT_SET); break;
+            case GSM_CMD_CSTT_SET: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CIICR); break;
+            case GSM_CMD_CIICR: SET_NEW_CMD_CHECK_ERROR(GSM_CMD_CIFSR); break;
+            case GSM_CMD_CIFSR: SET_NEW_CMD(GSM_CMD_CIPSTATUS); break;
             default: break;
         }
+        if (n_cmd == GSM_CMD_IDLE && *is_ok) {  /* Remember settings of active bearer */
+            gsm.m.network.apn_hash = gsmi_network_apn_hash(msg);
+            gsm.m.network.apn_valid = 1;
+        }
     } else if (CMD_IS_DEF(GSM_CMD_NETWORK_DETACH)) {
+        gsm.m.network.apn_valid = 0;
         switch (msg->i) {
             case 0: SET_NEW_CMD(GSM_CMD_CGATT_SET_0); break;
             case 1: SET_NEW_CMD(GSM_CMD_CGACT_SET_0); break;
@@ -1646,8 +2826,25 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
  */
 gsmr_t
 gsmi_initiate_cmd(gsm_msg_t* msg) {
+    /* Skip command when modem is already in requested state and continue with next one */
+    if (gsmi_cmd_is_redundant(msg)) {
+        uint8_t is_ok = 1;
+        uint16_t is_error = 0;
+        gsmr_t res;
+
+        res = gsmi_process_sub_cmd(msg, &is_ok, &is_error);
+        return res == gsmCONT ? gsmOK : res;
+    }
+
     switch (CMD_GET_CUR()) {                    /* Check current message we want to send over AT */
         case GSM_CMD_RESET: {                   /* Reset modem with AT commands */
+            if (msg->msg.reset.probed) {        /* Device was probed, send manual AT command */
+                AT_PORT_SEND_BEGIN_AT();
+                AT_PORT_SEND_CONST_STR("+CFUN=1,1");
+                AT_PORT_SEND_END_AT();
+                break;
+            }
+
             /* Try with hardware reset */
             if (gsm.ll.reset_fn != NULL && gsm.ll.reset_fn(1)) {
                 gsm_delay(2);
@@ -1655,12 +2852,34 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
                 gsm_delay(500);
             }
 
-            /* Send manual AT command */
+            /*
+             * Probe device first, `AT+CFUN=1,1` is not answered
+             * when device uses different baudrate and would wait for command timeout
+             */
+            gsmi_probe_start();
+            msg->cmd = GSM_CMD_READY_PROBE;
+            return gsmi_probe_send();
+        }
+        case GSM_CMD_READY_PROBE: {             /* Probe if device is alive */
+            return gsmi_probe_send();
+        }
+        case GSM_CMD_UART: {                    /* Set AT port baudrate */
             AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CFUN=1,1");
+            AT_PORT_SEND_CONST_STR("+IPR=");
+            gsmi_send_number(CMD_IS_DEF(GSM_CMD_UART) ? msg->msg.uart.baudrate : GSM_U32(GSM_CFG_AT_PORT_BAUDRATE_FAST), 0, 0);
             AT_PORT_SEND_END_AT();
             break;
         }
+        case GSM_CMD_UART_PROBE: {              /* Probe if device responds at new baudrate */
+            return gsmi_probe_send();
+        }
+        case GSM_CMD_READY_WAIT: {              /* Wait for readiness message */
+            if (gsm_timeout_add(msg->cmd_def == GSM_CMD_SIM_PROCESS_BASIC_CMDS ? 1000 : GSM_CFG_READY_TIMEOUT,
+                    gsmi_ready_timeout, NULL) != gsmOK) {
+                return gsmERRMEM;
+            }
+            break;
+        }
         case GSM_CMD_RESET_DEVICE_FIRST_CMD: {  /* First command for device driver specific reset */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_END_AT();
@@ -1715,7 +2934,11 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
         }
         case GSM_CMD_CREG_SET: {                /* Enable +CREG message */
             AT_PORT_SEND_BEGIN_AT();
+#if GSM_CFG_NETWORK_TRACKER
+            AT_PORT_SEND_CONST_STR("+CREG=2");  /* Include location info */
+#else /* GSM_CFG_NETWORK_TRACKER */
             AT_PORT_SEND_CONST_STR("+CREG=1");
+#endif /* !GSM_CFG_NETWORK_TRACKER */
             AT_PORT_SEND_END_AT();
             break;
         }
@@ -1725,6 +2948,20 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
+#if GSM_CFG_NETWORK_TRACKER
+        case GSM_CMD_CGREG_SET: {               /* Enable +CGREG message with location info */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CGREG=2");
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_CGREG_GET: {               /* Get GPRS network registration status */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CGREG?");
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+#endif /* GSM_CFG_NETWORK_TRACKER */
         case GSM_CMD_CFUN_SET: {
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CFUN=");
@@ -1808,6 +3045,11 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
             break;
         }
         case GSM_CMD_COPS_GET_OPT: {            /* Get list of available operators */
+            msg->msg.cops_scan.read = 0;        /* Start from beginning, command may be repeated */
+            msg->msg.cops_scan.opsi = 0;
+            if (msg->msg.cops_scan.opf != NULL) {
+                *msg->msg.cops_scan.opf = 0;
+            }
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+COPS=?");
             AT_PORT_SEND_END_AT();
@@ -1921,23 +3163,38 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
         case GSM_CMD_CMGF: {                    /* Select SMS message format */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CMGF=");
-            if (CMD_IS_DEF(GSM_CMD_CMGS)) {
-                gsmi_send_number(GSM_U32(!!msg->msg.sms_send.format), 0, 0);
-            } else if (CMD_IS_DEF(GSM_CMD_CMGR)) {
-                gsmi_send_number(GSM_U32(!!msg->msg.sms_read.format), 0, 0);
-            } else if (CMD_IS_DEF(GSM_CMD_CMGL)) {
-                gsmi_send_number(GSM_U32(!!msg->msg.sms_list.format), 0, 0);
-            } else {
-                /* Used for all other operations like delete all messages, etc */
-                AT_PORT_SEND_CONST_STR("1");
-            }
+            gsmi_send_number(GSM_U32(gsmi_sms_get_format(msg)), 0, 0);
             AT_PORT_SEND_END_AT();
             break;
         }
         case GSM_CMD_CMGS: {                    /* Send SMS */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CMGS=");
+#if GSM_CFG_SMS_PDU
+            if (!msg->msg.sms_send.format) {    /* Length of TPDU, without service center address */
+#if GSM_CFG_SMS_CONCAT
+                if (msg->msg.sms_send.parts > 1) {  /* Prepare header and data of current part */
+                    msg->msg.sms_send.udh_len = gsm_sms_pdu_concat_udh(msg->msg.sms_send.udh, msg->msg.sms_send.ref,
+                        msg->msg.sms_send.parts, GSM_U8(msg->msg.sms_send.part + 1), GSM_CFG_SMS_CONCAT_REF16);
+                    msg->msg.sms_send.part_len = gsm_sms_pdu_get_part_len(&msg->msg.sms_send.text[msg->msg.sms_send.part_off],
+                        msg->msg.sms_send.len - msg->msg.sms_send.part_off, msg->msg.sms_send.dcs, msg->msg.sms_send.udh_len);
+                }
+#endif /* GSM_CFG_SMS_CONCAT */
+                gsmi_send_number(GSM_U32(gsm_sms_pdu_encode(msg->msg.sms_send.num, &msg->msg.sms_send.text[msg->msg.sms_send.part_off],
+                    msg->msg.sms_send.part_len, msg->msg.sms_send.dcs, msg->msg.sms_send.udh, msg->msg.sms_send.udh_len, NULL, 0) - 1), 0, 0);
+            } else {
+                gsmi_send_string(msg->msg.sms_send.num, 0, 1, 0);
+            }
+#else /* GSM_CFG_SMS_PDU */
             gsmi_send_string(msg->msg.sms_send.num, 0, 1, 0);
+#endif /* !GSM_CFG_SMS_PDU */
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_CMMS: {                    /* More messages to send */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CMMS=");
+            gsmi_send_number(msg->msg.sms_send.index < msg->msg.sms_send.count ? 2 : 0, 0, 0);
             AT_PORT_SEND_END_AT();
             break;
         }
@@ -1952,7 +3209,21 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
         case GSM_CMD_CMGD: {                    /* Delete SMS message */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CMGD=");
-            gsmi_send_number(GSM_U32(msg->msg.sms_delete.pos), 0, 0);
+#if GSM_CFG_SMS_DRAIN
+            if (CMD_IS_DEF(GSM_CMD_SMS_DRAIN)) {
+                /* Reported messages only, concatenated to single command line with one final result */
+                for (size_t i = gsm.m.sms.drain_del;
+                    i < gsm.m.sms.drain_cnt && i < gsm.m.sms.drain_del + SMS_DRAIN_DEL_PER_CMD; ++i) {
+                    if (i > gsm.m.sms.drain_del) {
+                        AT_PORT_SEND_CONST_STR(";+CMGD=");
+                    }
+                    gsmi_send_number(GSM_U32(gsm.m.sms.drain_pos[i]), 0, 0);
+                }
+            } else
+#endif /* GSM_CFG_SMS_DRAIN */
+            {
+                gsmi_send_number(GSM_U32(msg->msg.sms_delete.pos), 0, 0);
+            }
             AT_PORT_SEND_END_AT();
             break;
         }
@@ -1975,11 +3246,33 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
         case GSM_CMD_CMGL: {                    /* Delete SMS message */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CMGL=");
+#if GSM_CFG_SMS_PDU
+            if (!msg->msg.sms_list.format) {
+                gsmi_send_sms_stat_pdu(msg->msg.sms_list.status, 0);
+            } else {
+                gsmi_send_sms_stat(msg->msg.sms_list.status, 1, 0);
+            }
+#else /* GSM_CFG_SMS_PDU */
             gsmi_send_sms_stat(msg->msg.sms_list.status, 1, 0);
+#endif /* !GSM_CFG_SMS_PDU */
             gsmi_send_number(GSM_U32(!msg->msg.sms_list.update), 0, 1);
             AT_PORT_SEND_END_AT();
             break;
         }
+#if GSM_CFG_SMS_DIRECT
+        case GSM_CMD_CNMI: {                    /* Set new message indications */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CNMI=2,2");
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_CNMA: {                    /* Acknowledge new message */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CNMA");
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+#endif /* GSM_CFG_SMS_DIRECT */
         case GSM_CMD_CPMS_GET_OPT: {            /* Get available SMS storages */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CPMS=?");
@@ -1995,12 +3288,9 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
         case GSM_CMD_CPMS_SET: {                /* Set active SMS storage(s) */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CPMS=");
-            if (CMD_IS_DEF(GSM_CMD_CMGR)) { /* Read SMS original command? */
-                gsmi_send_dev_memory(msg->msg.sms_read.mem == GSM_MEM_CURRENT ? gsm.m.sms.mem[0].current : msg->msg.sms_read.mem, 1, 0);
-            } else if(CMD_IS_DEF(GSM_CMD_CMGD)) {   /* Delete SMS original command? */
-                gsmi_send_dev_memory(msg->msg.sms_delete.mem == GSM_MEM_CURRENT ? gsm.m.sms.mem[0].current : msg->msg.sms_delete.mem, 1, 0);
-            } else if(CMD_IS_DEF(GSM_CMD_CMGL)) {   /* List SMS original command? */
-                gsmi_send_dev_memory(msg->msg.sms_list.mem == GSM_MEM_CURRENT ? gsm.m.sms.mem[0].current : msg->msg.sms_list.mem, 1, 0);
+            if (CMD_IS_DEF(GSM_CMD_CMGR) || CMD_IS_DEF(GSM_CMD_CMGD) || CMD_IS_DEF(GSM_CMD_CMGL)
+                || CMD_IS_DEF(GSM_CMD_SMS_DRAIN)) { /* Read, delete, list or drain SMS original command? */
+                gsmi_send_dev_memory(gsmi_sms_get_mem(msg), 1, 0);
             } else if (CMD_IS_DEF(GSM_CMD_CPMS_SET)) {  /* Do we want to set memory for read/delete,sent/write,receive? */
                 for (size_t i = 0; i < 3; ++i) {/* Write 3 memories */
                     gsmi_send_dev_memory(msg->msg.sms_memory.mem[i] == GSM_MEM_CURRENT ? gsm.m.sms.mem[i].current : msg->msg.sms_memory.mem[i], 1, !!i);
@@ -2046,20 +3336,19 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
             break;
         }
         case GSM_CMD_CPBS_SET: {                /* Get current memory info */
-            gsm_mem_t mem;
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CPBS=");
-            switch (CMD_GET_DEF()) {
-                case GSM_CMD_CPBW_SET: mem = msg->msg.pb_write.mem; break;
-                case GSM_CMD_CPBR: mem = msg->msg.pb_list.mem; break;
-                case GSM_CMD_CPBF: mem = msg->msg.pb_search.mem; break;
-                default: break;
-            }
-            gsmi_send_dev_memory(mem == GSM_MEM_CURRENT ? gsm.m.pb.mem.current : mem, 1, 0);
+            gsmi_send_dev_memory(gsmi_pb_get_mem(msg), 1, 0);
             AT_PORT_SEND_END_AT();
             break;
         }
         case GSM_CMD_CPBW_SET: {                /* Write/Delete new/old entry */
+#if GSM_CFG_PHONEBOOK_CACHE
+            if (msg->msg.pb_write.pos == 0 && !msg->msg.pb_write.del) {
+                /* Use explicit free position to keep mirror in sync */
+                msg->msg.pb_write.pos = gsmi_pb_cache_get_free_pos(gsm.m.pb.mem.current);
+            }
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CPBW=");
             if (msg->msg.pb_write.pos > 0) {    /* Write number if more than 0 */
@@ -2077,7 +3366,15 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CPBR=");
             gsmi_send_number(GSM_U32(msg->msg.pb_list.start_index), 0, 0);
-            gsmi_send_number(GSM_U32(msg->msg.pb_list.etr), 0, 1);
+#if GSM_CFG_PHONEBOOK_CACHE
+            if (msg->cmd_def == GSM_CMD_PB_CACHE_LOAD) {
+                gsm.m.pb.cache.valid = 0;       /* Mirror is invalid until read finishes */
+                gsmi_send_number(GSM_U32(gsm.m.pb.mem.total > 0 ? gsm.m.pb.mem.total : msg->msg.pb_list.etr), 0, 1);
+            } else
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
+            {
+                gsmi_send_number(GSM_U32(msg->msg.pb_list.etr), 0, 1);
+            }
             AT_PORT_SEND_END_AT();
             break;
         }
@@ -2116,6 +3413,12 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
+        case GSM_CMD_CGATT_GET: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CGATT?");
+            AT_PORT_SEND_END_AT();
+            break;
+        }
         case GSM_CMD_CIPMUX_SET: {
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CIPMUX=1");
@@ -2171,6 +3474,202 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
     return gsmOK;                               /* Valid command */
 }
 
+#if GSM_CFG_CMD_SUSPEND
+
+/**
+ * \brief           Check if command may be suspended while other commands are executed
+ * \param[in]       cmd: Command to check
+ * \return          `1` if suspendable, `0` otherwise
+ */
+static uint8_t
+gsmi_cmd_is_suspendable(gsm_cmd_t cmd) {
+    return cmd == GSM_CMD_COPS_GET_OPT;
+}
+
+/**
+ * \brief           Abort active command on device if it is suspendable
+ *
+ * Any character sent to device aborts long running command.
+ * Command is repeated regardless of final result code device responds with
+ */
+static void
+gsmi_cmd_suspend_active(void) {
+    gsm_core_lock();
+    if (gsm.msg != NULL && gsmi_cmd_is_suspendable(gsm.msg->cmd_def)
+#if GSM_CFG_BATCH
+        && gsm.msg->batch == NULL               /* Batch steps must finish in place */
+#endif /* GSM_CFG_BATCH */
+        && !gsm.msg->suspend_req && gsm.msg->suspend_cnt < GSM_CFG_CMD_SUSPEND_MAX) {
+        gsm.msg->suspend_req = 1;
+        AT_PORT_SEND_ESC();
+        AT_PORT_SEND_FLUSH();
+    }
+    gsm_core_unlock();
+}
+
+#endif /* GSM_CFG_CMD_SUSPEND */
+
+#if GSM_CFG_CMD_COALESCE
+
+/**
+ * \brief           Get index of command in coalescing table
+ * \param[in]       cmd: Command to check
+ * \return          Index in table or \ref GSM_SIZET_MAX if command may not be coalesced
+ */
+static size_t
+gsmi_cmd_coalesce_idx(gsm_cmd_t cmd) {
+    for (size_t i = 0; i < GSM_ARRAYSIZE(coalesce_cmds); ++i) {
+        if (coalesce_cmds[i] == cmd) {
+            return i;
+        }
+    }
+    return GSM_SIZET_MAX;
+}
+
+/**
+ * \brief           Finish message with result of another message of the same command
+ * \note            Message must not be used after this call
+ * \param[in]       msg: Message to finish
+ * \param[in]       res: Result of command
+ */
+static void
+gsmi_cmd_coalesce_finish(gsm_msg_t* msg, gsmr_t res) {
+    if (res == gsmOK) {                         /* Copy result to user variables */
+        if (msg->cmd_def == GSM_CMD_CSQ_GET && msg->msg.csq.rssi != NULL) {
+            *msg->msg.csq.rssi = gsm.m.rssi;
+        } else if (msg->cmd_def == GSM_CMD_COPS_GET && msg->msg.cops_get.curr != NULL
+                    && msg->msg.cops_get.curr != &gsm.m.network.curr_operator) {
+            GSM_MEMCPY(msg->msg.cops_get.curr, &gsm.m.network.curr_operator, sizeof(*msg->msg.cops_get.curr));
+        }
+    }
+    msg->res = res;
+#if GSM_CFG_USE_API_FUNC_EVT
+    if (msg->evt_fn != NULL) {
+        msg->evt_fn(msg->res, msg->evt_arg);    /* Send event with user argument */
+    }
+#endif /* GSM_CFG_USE_API_FUNC_EVT */
+    if (msg->is_blocking) {
+        gsm_sys_sem_release(&msg->sem);
+    } else {
+        GSM_MSG_VAR_FREE(msg);
+    }
+}
+
+/**
+ * \brief           Try to answer message from stored result or join identical pending command
+ * \note            When function returns `1`, non-blocking message must not be used anymore
+ * \param[in]       msg: New message
+ * \return          `1` if message must not be sent to queue, `0` otherwise
+ */
+static uint8_t
+gsmi_cmd_coalesce(gsm_msg_t* msg) {
+    size_t idx = gsmi_cmd_coalesce_idx(msg->cmd_def);
+    uint8_t res = 0;
+
+    if (idx == GSM_SIZET_MAX) {
+        return 0;
+    }
+    gsm_core_lock();
+#if GSM_CFG_CMD_COALESCE_CACHE_TTL > 0
+    if (coalesce_valid[idx]
+        && (gsm_sys_now() - coalesce_time[idx]) < GSM_CFG_CMD_COALESCE_CACHE_TTL) {
+        gsmi_cmd_coalesce_finish(msg, gsmOK);   /* Last result is fresh enough */
+        res = 1;
+    } else
+#endif /* GSM_CFG_CMD_COALESCE_CACHE_TTL > 0 */
+    if (coalesce_leader[idx] != NULL) {         /* Same command is already pending */
+        msg->coalesce_next = coalesce_leader[idx]->coalesce_next;
+        coalesce_leader[idx]->coalesce_next = msg;
+        res = 1;
+    } else {
+        coalesce_leader[idx] = msg;             /* Others will wait for this one */
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Finish all messages waiting for result of finished command
+ * \note            Function must be called with core locked, before message is released
+ * \param[in]       msg: Finished message
+ */
+void
+gsmi_cmd_coalesce_done(gsm_msg_t* msg) {
+    size_t idx = gsmi_cmd_coalesce_idx(msg->cmd_def);
+    gsm_msg_t* m;
+
+    if (idx == GSM_SIZET_MAX || coalesce_leader[idx] != msg) {
+        return;
+    }
+    coalesce_leader[idx] = NULL;
+#if GSM_CFG_CMD_COALESCE_CACHE_TTL > 0
+    if (msg->res == gsmOK) {
+        coalesce_valid[idx] = 1;
+        coalesce_time[idx] = gsm_sys_now();
+    }
+#endif /* GSM_CFG_CMD_COALESCE_CACHE_TTL > 0 */
+    while ((m = msg->coalesce_next) != NULL) {
+        msg->coalesce_next = m->coalesce_next;
+        gsmi_cmd_coalesce_finish(m, msg->res);
+    }
+}
+
+#endif /* GSM_CFG_CMD_COALESCE */
+
+#if GSM_CFG_BATCH
+
+/**
+ * \brief           Add message to batch currently being collected
+ * \param[in]       msg: New message
+ * \return          \ref gsmOK if message was added to batch,
+ *                  \ref gsmCONT if there is no batch and message shall be sent immediately,
+ *                  member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+gsmi_batch_add(gsm_msg_t* msg) {
+    gsmr_t res = gsmCONT;
+
+    gsm_core_lock();
+    if (gsm.batch == NULL || gsm.batch == msg) {
+        /* No batch, send message immediately */
+    } else if (msg->is_blocking) {
+        res = gsmERR;                           /* Steps are executed after caller returns */
+    } else {
+        msg->batch = gsm.batch;
+        if (gsm.batch->msg.batch.last != NULL) {
+            gsm.batch->msg.batch.last->batch_next = msg;
+        } else {
+            gsm.batch->msg.batch.first = msg;
+        }
+        gsm.batch->msg.batch.last = msg;
+        res = gsmOK;
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Finish all steps of batch which will not be executed
+ * \param[in]       batch: Batch message
+ * \param[in]       res: Result to report for every step
+ */
+static void
+gsmi_batch_discard(gsm_msg_t* batch, gsmr_t res) {
+    gsm_msg_t* m;
+
+    gsm_core_lock();
+    while ((m = batch->msg.batch.first) != NULL) {
+        batch->msg.batch.first = m->batch_next;
+        m->batch = NULL;
+        m->res = res;
+        gsmi_msg_complete(m);
+    }
+    batch->msg.batch.last = NULL;
+    gsm_core_unlock();
+}
+
+#endif /* GSM_CFG_BATCH */
+
 /**
  * \brief           Send message from API function to producer queue for further processing
  * \param[in]       msg: New message to process
@@ -2181,6 +3680,10 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
 gsmr_t
 gsmi_send_msg_to_producer_mbox(gsm_msg_t* msg, gsmr_t (*process_fn)(gsm_msg_t *), uint32_t max_block_time) {
     gsmr_t res = msg->res = gsmOK;
+    uint8_t coalesced = 0;
+#if GSM_CFG_CMD_SUSPEND
+    uint8_t suspend_active = !gsmi_cmd_is_suspendable(msg->cmd_def);
+#endif /* GSM_CFG_CMD_SUSPEND */
 
     /* Check here if stack is even enabled or shall we disable new command entry? */
     gsm_core_lock();
@@ -2194,12 +3697,22 @@ gsmi_send_msg_to_producer_mbox(gsm_msg_t* msg, gsmr_t (*process_fn)(gsm_msg_t *)
     }
     gsm_core_unlock();
     if (res != gsmOK) {
+#if GSM_CFG_BATCH
+        if (msg->cmd_def == GSM_CMD_BATCH) {
+            gsmi_batch_discard(msg, res);
+        }
+#endif /* GSM_CFG_BATCH */
         GSM_MSG_VAR_FREE(msg);                  /* Free memory and return */
         return res;
     }
 
     if (msg->is_blocking) {                     /* In case message is blocking */
         if (!gsm_sys_sem_create(&msg->sem, 0)) {/* Create semaphore and lock it immediately */
+#if GSM_CFG_BATCH
+            if (msg->cmd_def == GSM_CMD_BATCH) {
+                gsmi_batch_discard(msg, gsmERRMEM);
+            }
+#endif /* GSM_CFG_BATCH */
             GSM_MSG_VAR_FREE(msg);              /* Release memory and return */
             return gsmERRMEM;
         }
@@ -2209,14 +3722,50 @@ gsmi_send_msg_to_producer_mbox(gsm_msg_t* msg, gsmr_t (*process_fn)(gsm_msg_t *)
     }
     msg->block_time = max_block_time;           /* Set blocking status if necessary */
     msg->fn = process_fn;                       /* Save processing function to be called as callback */
-    if (msg->is_blocking) {
+#if GSM_CFG_BATCH
+    if ((res = gsmi_batch_add(msg)) != gsmCONT) {
+        if (res != gsmOK) {
+            GSM_MSG_VAR_FREE(msg);              /* Rejected by batch */
+        }
+        return res;                             /* Executed on batch commit */
+    }
+    res = gsmOK;
+#endif /* GSM_CFG_BATCH */
+#if GSM_CFG_CMD_COALESCE
+    if (!msg->is_blocking) {
+        if (gsmi_cmd_coalesce(msg)) {
+            return gsmOK;                       /* Message is finished or owned by pending command */
+        }
+    } else {
+        coalesced = gsmi_cmd_coalesce(msg);
+    }
+#endif /* GSM_CFG_CMD_COALESCE */
+    if (coalesced) {
+        /* Wait for result of pending command */
+    } else if (msg->is_blocking) {
         gsm_sys_mbox_put(&gsm.mbox_producer, msg);  /* Write message to producer queue and wait forever */
     } else {
         if (!gsm_sys_mbox_putnow(&gsm.mbox_producer, msg)) {    /* Write message to producer queue immediately */
+#if GSM_CFG_CMD_COALESCE
+            gsm_core_lock();
+            msg->res = gsmERRMEM;
+            gsmi_cmd_coalesce_done(msg);        /* Finish messages which joined in the meantime */
+            gsm_core_unlock();
+#endif /* GSM_CFG_CMD_COALESCE */
+#if GSM_CFG_BATCH
+            if (msg->cmd_def == GSM_CMD_BATCH) {
+                gsmi_batch_discard(msg, gsmERRMEM);
+            }
+#endif /* GSM_CFG_BATCH */
             GSM_MSG_VAR_FREE(msg);              /* Release message */
             return gsmERRMEM;
         }
     }
+#if GSM_CFG_CMD_SUSPEND
+    if (suspend_active && !coalesced) {         /* Let new message run before long command */
+        gsmi_cmd_suspend_active();
+    }
+#endif /* GSM_CFG_CMD_SUSPEND */
     if (res == gsmOK && msg->is_blocking) {     /* In case we have blocking request */
         uint32_t time;
         time = gsm_sys_sem_wait(&msg->sem, 0);  /* Wait forever for semaphore */
@@ -2243,6 +3792,8 @@ gsmi_send_msg_to_producer_mbox(gsm_msg_t* msg, gsmr_t (*process_fn)(gsm_msg_t *)
  */
 void
 gsmi_process_events_for_timeout_or_error(gsm_msg_t* msg, gsmr_t err) {
+    gsmi_cmd_state_update(msg, 0);              /* Command may or may not be applied by modem */
+
     switch (msg->cmd_def) {
         case GSM_CMD_RESET: {
             /* Reset command error */
@@ -2283,6 +3834,14 @@ gsmi_process_events_for_timeout_or_error(gsm_msg_t* msg, gsmr_t err) {
             break;
         }
 
+        case GSM_CMD_SMS_SEND_BATCH: {
+            /* Report entry in progress, remaining entries keep error result */
+            if (msg->msg.sms_send.index < msg->msg.sms_send.count) {
+                gsmi_sms_batch_entry_done(msg, err);
+            }
+            break;
+        }
+
         case GSM_CMD_CMGR: {
             /* Read error event */
             SMS_SEND_READ_EVT(msg, err);
@@ -2300,6 +3859,13 @@ gsmi_process_events_for_timeout_or_error(gsm_msg_t* msg, gsmr_t err) {
             SMS_SEND_DELETE_EVT(msg, err);
             break;
         }
+
+#if GSM_CFG_SMS_DRAIN
+        case GSM_CMD_SMS_DRAIN: {
+            gsmi_sms_drain_finish();            /* Allow next drain */
+            break;
+        }
+#endif /* GSM_CFG_SMS_DRAIN */
 #endif /* GSM_CFG_SMS */
 
         default: break;
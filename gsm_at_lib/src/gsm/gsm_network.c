@@ -34,11 +34,175 @@
 #include "gsm/gsm_private.h"
 #include "gsm/gsm_network.h"
 #include "gsm/gsm_mem.h"
+#include "gsm/gsm_timeout.h"
 
 #if GSM_CFG_NETWORK || __DOXYGEN__
 
+#if GSM_CFG_NETWORK_TRACKER || __DOXYGEN__
+
+static void prv_reattach_timeout(void* arg);
+
+/**
+ * \brief           Check if registration status means device is registered
+ * \param[in]       status: Registration status
+ * \return          `1` if registered, `0` otherwise
+ */
+static uint8_t
+prv_is_registered(gsm_network_reg_status_t status) {
+    return status == GSM_NETWORK_REG_STATUS_CONNECTED || status == GSM_NETWORK_REG_STATUS_CONNECTED_ROAMING;
+}
+
+/**
+ * \brief           Schedule next automatic re-attach attempt
+ *
+ * Backoff doubles with every call, up to \ref GSM_CFG_NETWORK_TRACKER_BACKOFF_MAX.
+ * Actual delay is random between half and full backoff,
+ * to prevent devices in same cell from retrying at the same time
+ */
+static void
+prv_reattach_schedule(void) {
+    gsm_network_tracker_t* t = &gsm.network_tracker;
+    uint32_t delay;
+
+    if (t->scheduled || t->busy) {
+        return;
+    }
+    if (t->backoff == 0) {
+        t->backoff = GSM_CFG_NETWORK_TRACKER_BACKOFF_MIN;
+    } else {
+        t->backoff = GSM_MIN(t->backoff * 2, GSM_CFG_NETWORK_TRACKER_BACKOFF_MAX);
+    }
+
+    /* Xorshift pseudo random generator */
+    if (t->seed == 0) {
+        t->seed = gsm_sys_now() | 0x01;
+    }
+    t->seed ^= t->seed << 13;
+    t->seed ^= t->seed >> 17;
+    t->seed ^= t->seed << 5;
+    delay = t->backoff / 2 + t->seed % (t->backoff / 2 + 1);
+
+    if (gsm_timeout_add(delay, prv_reattach_timeout, NULL) == gsmOK) {
+        t->scheduled = 1;
+    }
+}
+
+/**
+ * \brief           Automatic re-attach command finished callback
+ * \param[in]       res: Command result
+ * \param[in]       arg: Custom argument, not used
+ */
+static void
+prv_reattach_evt_fn(gsmr_t res, void* arg) {
+    gsm_network_tracker_t* t = &gsm.network_tracker;
+
+    GSM_UNUSED(arg);
+    t->busy = 0;
+    if (t->want_attached && (res != gsmOK || !gsm.m.network.is_attached)) {
+        prv_reattach_schedule();                /* Try again later */
+    }
+}
+
+/**
+ * \brief           Automatic re-attach timeout callback
+ * \param[in]       arg: Custom argument, not used
+ */
+static void
+prv_reattach_timeout(void* arg) {
+    gsm_network_tracker_t* t = &gsm.network_tracker;
+
+    GSM_UNUSED(arg);
+    t->scheduled = 0;
+    if (!t->want_attached || gsm.m.network.is_attached) {
+        return;
+    }
+    /* Not registered, wait for registration to schedule again */
+    if (!prv_is_registered(gsm.m.network.status) && !prv_is_registered(gsm.m.network.gprs_status)) {
+        return;
+    }
+    ++t->state.reattach_cnt;
+    t->busy = 1;
+    if (gsm_network_attach(t->apn, t->user, t->pass, prv_reattach_evt_fn, NULL, 0) != gsmOK) {
+        t->busy = 0;
+        prv_reattach_schedule();
+    }
+}
+
+/**
+ * \brief           Update tracked network state from current modem state
+ *
+ * Function publishes \ref GSM_EVT_NETWORK_STATE event on change,
+ * updates outage counters and schedules automatic re-attach when needed
+ */
+void
+gsmi_network_tracker_update(void) {
+    gsm_network_tracker_t* t = &gsm.network_tracker;
+    gsm_network_state_t* s = &t->state;
+    uint32_t now;
+
+    if (s->reg_status == gsm.m.network.status && s->gprs_status == gsm.m.network.gprs_status
+        && s->lac == gsm.m.network.lac && s->ci == gsm.m.network.ci
+        && s->is_attached == gsm.m.network.is_attached) {
+        return;
+    }
+
+    now = gsm_sys_now();
+    s->reg_status = gsm.m.network.status;
+    s->gprs_status = gsm.m.network.gprs_status;
+    s->lac = gsm.m.network.lac;
+    s->ci = gsm.m.network.ci;
+    s->is_attached = gsm.m.network.is_attached;
+    s->last_change = now;
+
+    if (s->is_attached && (prv_is_registered(s->reg_status) || prv_is_registered(s->gprs_status))) {
+        if (s->in_outage) {                     /* Outage finished */
+            s->outage_last = now - s->outage_start;
+            s->outage_total += s->outage_last;
+            s->in_outage = 0;
+        }
+        s->is_up = 1;
+        t->backoff = 0;
+    } else {
+        if (s->is_up) {                         /* Outage started */
+            s->outage_start = now;
+            ++s->outage_cnt;
+            s->in_outage = 1;
+        }
+        s->is_up = 0;
+        if (t->want_attached && !s->is_attached
+            && (prv_is_registered(s->reg_status) || prv_is_registered(s->gprs_status))) {
+            prv_reattach_schedule();
+        }
+    }
+
+    gsm.evt.evt.network_state.state = s;
+    gsmi_send_cb(GSM_EVT_NETWORK_STATE);
+}
+
+/**
+ * \brief           Copy tracked network registration and bearer state
+ * \param[out]      state: Pointer to output state variable
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_network_get_state(gsm_network_state_t* state) {
+    GSM_ASSERT("state != NULL", state != NULL);
+
+    gsm_core_lock();
+    GSM_MEMCPY(state, &gsm.network_tracker.state, sizeof(*state));
+    gsm_core_unlock();
+    return gsmOK;
+}
+
+#endif /* GSM_CFG_NETWORK_TRACKER || __DOXYGEN__ */
+
 /**
  * \brief           Attach to network and active PDP context
+ *
+ * When \ref GSM_CFG_NETWORK_TRACKER is enabled, library re-attaches automatically
+ * with the same credentials after PDP context is lost, until \ref gsm_network_detach is called.
+ * In this case, input strings must stay valid until then
+ *
  * \param[in]       apn: APN name
  * \param[in]       user: User name to attach. Set to `NULL` if not used
  * \param[in]       pass: User password to attach. Set to `NULL` if not used
@@ -57,11 +221,22 @@ gsm_network_attach(const char* apn, const char* user, const char* pass,
     GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_NETWORK_ATTACH;
 #if GSM_CFG_CONN
     GSM_MSG_VAR_REF(msg).cmd = GSM_CMD_CIPSTATUS;
-#endif /* GSM_CFG_CONN */
+#else /* GSM_CFG_CONN */
+    GSM_MSG_VAR_REF(msg).cmd = GSM_CMD_CGATT_GET;
+#endif /* !GSM_CFG_CONN */
     GSM_MSG_VAR_REF(msg).msg.network_attach.apn = apn;
     GSM_MSG_VAR_REF(msg).msg.network_attach.user = user;
     GSM_MSG_VAR_REF(msg).msg.network_attach.pass = pass;
 
+#if GSM_CFG_NETWORK_TRACKER
+    gsm_core_lock();
+    gsm.network_tracker.want_attached = 1;
+    gsm.network_tracker.apn = apn;
+    gsm.network_tracker.user = user;
+    gsm.network_tracker.pass = pass;
+    gsm_core_unlock();
+#endif /* GSM_CFG_NETWORK_TRACKER */
+
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 200000);
 }
 
@@ -83,6 +258,17 @@ gsm_network_detach(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const u
     /* GSM_MSG_VAR_REF(msg).cmd = GSM_CMD_CIPSTATUS; */
 #endif /* GSM_CFG_CONN */
 
+#if GSM_CFG_NETWORK_TRACKER
+    gsm_core_lock();
+    gsm.network_tracker.want_attached = 0;      /* Stop automatic re-attach */
+    if (gsm.network_tracker.scheduled) {
+        gsm_timeout_remove(prv_reattach_timeout);
+        gsm.network_tracker.scheduled = 0;
+    }
+    gsm.network_tracker.backoff = 0;
+    gsm_core_unlock();
+#endif /* GSM_CFG_NETWORK_TRACKER */
+
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
 }
 
@@ -316,6 +316,12 @@ gsmi_parse_creg(const char* str, uint8_t skip_first) {
         gsmi_parse_number(&str);
     }
     gsm.m.network.status = (gsm_network_reg_status_t)gsmi_parse_number(&str);
+#if GSM_CFG_NETWORK_TRACKER
+    if (*str == ',') {                          /* Location info is available with +CREG=2 */
+        gsm.m.network.lac = gsmi_parse_hexnumber(&str);
+        gsm.m.network.ci = gsmi_parse_hexnumber(&str);
+    }
+#endif /* GSM_CFG_NETWORK_TRACKER */
 
     /*
      * In case we are connected to network,
@@ -334,10 +340,48 @@ gsmi_parse_creg(const char* str, uint8_t skip_first) {
 
     /* Send callback event */
     gsmi_send_cb(GSM_EVT_NETWORK_REG_CHANGED);
+#if GSM_CFG_NETWORK_TRACKER
+    gsmi_network_tracker_update();
+#endif /* GSM_CFG_NETWORK_TRACKER */
+
+    return 1;
+}
+
+#if GSM_CFG_NETWORK_TRACKER || __DOXYGEN__
+
+/**
+ * \brief           Parse received +CGREG message
+ * \param[in]       str: Input string to parse from
+ * \param[in]       skip_first: Set to `1` to skip first number
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsmi_parse_cgreg(const char* str, uint8_t skip_first) {
+    if (*str == '+') {
+        str += 8;
+    }
+
+    if (skip_first) {
+        gsmi_parse_number(&str);
+    }
+    gsm.m.network.gprs_status = (gsm_network_reg_status_t)gsmi_parse_number(&str);
+    if (*str == ',') {                          /* Location info is available with +CGREG=2 */
+        gsm.m.network.lac = gsmi_parse_hexnumber(&str);
+        gsm.m.network.ci = gsmi_parse_hexnumber(&str);
+    }
 
+    /* Lost packet domain while attached, check PDP context */
+    if (gsm.m.network.gprs_status != GSM_NETWORK_REG_STATUS_CONNECTED
+        && gsm.m.network.gprs_status != GSM_NETWORK_REG_STATUS_CONNECTED_ROAMING
+        && gsm.m.network.is_attached) {
+        gsm_network_check_status(NULL, NULL, 0);
+    }
+    gsmi_network_tracker_update();
     return 1;
 }
 
+#endif /* GSM_CFG_NETWORK_TRACKER || __DOXYGEN__ */
+
 /**
  * \brief           Parse received +CSQ signal value
  * \param[in]       str: Input string
@@ -583,6 +627,15 @@ gsmi_parse_clcc(const char* str, uint8_t send_evt) {
     gsmi_parse_string(&str, gsm.m.call.number, sizeof(gsm.m.call.number), 1);
     gsm.m.call.addr_type = gsmi_parse_number(&str);
     gsmi_parse_string(&str, gsm.m.call.name, sizeof(gsm.m.call.name), 1);
+#if GSM_CFG_PHONEBOOK_CACHE
+    if (gsm.m.call.name[0] == '\0') {         /* Resolve caller name locally */
+        const gsm_pb_entry_t* e = gsmi_pb_cache_find_number(gsm.m.call.number);
+        if (e != NULL) {
+            GSM_MEMCPY(gsm.m.call.name, e->name, GSM_MIN(sizeof(gsm.m.call.name), sizeof(e->name)));
+            gsm.m.call.name[sizeof(gsm.m.call.name) - 1] = '\0';
+        }
+    }
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
 
     if (send_evt) {
         gsm.evt.evt.call_changed.call = &gsm.m.call;
@@ -625,6 +678,34 @@ gsmi_parse_sms_status(const char** src, gsm_sms_status_t* stat) {
     return 0;
 }
 
+#if GSM_CFG_SMS_PDU || __DOXYGEN__
+
+/**
+ * \brief           Parse SMS status and alpha identifier of +CMGR or +CMGL statement in PDU mode
+ *
+ * Function also prepares buffer for PDU, received in next line
+ *
+ * \param[in,out]   src: Pointer to pointer to string to parse
+ * \param[out]      e: SMS entry to fill
+ */
+static void
+gsmi_parse_sms_pdu_hdr(const char** src, gsm_sms_entry_t* e) {
+    switch (gsmi_parse_number(src)) {
+        case 0: e->status = GSM_SMS_STATUS_UNREAD; break;
+        case 1: e->status = GSM_SMS_STATUS_READ; break;
+        case 2: e->status = GSM_SMS_STATUS_UNSENT; break;
+        case 3: e->status = GSM_SMS_STATUS_SENT; break;
+        default: break;
+    }
+    if ((*src)[0] == ',' && (*src)[1] == '"') { /* Alpha identifier is optional */
+        gsmi_parse_string(src, e->name, sizeof(e->name), 1);
+    }
+    gsm.m.sms.pdu_len = 0;
+    gsm.m.sms.pdu_hex = 0;
+}
+
+#endif /* GSM_CFG_SMS_PDU || __DOXYGEN__ */
+
 /**
  * \brief           Parse received +CMGS with last sent SMS memory info
  * \param[in]       str: Input string
@@ -658,6 +739,12 @@ gsmi_parse_cmgr(const char* str) {
 
     e = gsm.msg->msg.sms_read.entry;
     e->length = 0;
+#if GSM_CFG_SMS_PDU
+    if (!gsm.msg->msg.sms_read.format) {
+        gsmi_parse_sms_pdu_hdr(&str, e);
+        return 1;
+    }
+#endif /* GSM_CFG_SMS_PDU */
     gsmi_parse_sms_status(&str, &e->status);
     gsmi_parse_string(&str, e->number, sizeof(e->number), 1);
     gsmi_parse_string(&str, e->name, sizeof(e->name), 1);
@@ -676,7 +763,7 @@ uint8_t
 gsmi_parse_cmgl(const char* str) {
     gsm_sms_entry_t* e;
 
-    if (!CMD_IS_DEF(GSM_CMD_CMGL) ||
+    if ((!CMD_IS_DEF(GSM_CMD_CMGL) && !CMD_IS_DEF(GSM_CMD_SMS_DRAIN)) ||
         gsm.msg->msg.sms_list.ei >= gsm.msg->msg.sms_list.etr) {
         return 0;
     }
@@ -687,8 +774,14 @@ gsmi_parse_cmgl(const char* str) {
 
     e = &gsm.msg->msg.sms_list.entries[gsm.msg->msg.sms_list.ei];
     e->length = 0;
-    e->mem = gsm.msg->msg.sms_list.mem;         /* Manually set memory */
+    e->mem = gsm.m.sms.mem[0].current;          /* Manually set memory, selected before list */
     e->pos = GSM_SZ(gsmi_parse_number(&str));   /* Scan position */
+#if GSM_CFG_SMS_PDU
+    if (!gsm.msg->msg.sms_list.format) {
+        gsmi_parse_sms_pdu_hdr(&str, e);
+        return 1;
+    }
+#endif /* GSM_CFG_SMS_PDU */
     gsmi_parse_sms_status(&str, &e->status);
     gsmi_parse_string(&str, e->number, sizeof(e->number), 1);
     gsmi_parse_string(&str, e->name, sizeof(e->name), 1);
@@ -718,6 +811,46 @@ gsmi_parse_cmti(const char* str, uint8_t send_evt) {
     return 1;
 }
 
+#if GSM_CFG_SMS_DIRECT || __DOXYGEN__
+
+/**
+ * \brief           Parse received +CMT header of directly delivered SMS
+ *
+ * Message data follows in next line, as text or PDU,
+ * depending on message format currently set on device
+ *
+ * \param[in]       str: Input string
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsmi_parse_cmt(const char* str) {
+    gsm_sms_entry_t* e = &gsm.m.sms.direct;
+    if (*str == '+') {
+        str += 6;
+    }
+
+    GSM_MEMSET(e, 0x00, sizeof(*e));
+    e->mem = GSM_MEM_UNKNOWN;                   /* Message is not stored */
+    e->status = GSM_SMS_STATUS_UNREAD;
+    gsm.m.sms.direct_format = gsm.m.sms.format_valid ? gsm.m.sms.format : !GSM_CFG_SMS_PDU;
+#if GSM_CFG_SMS_PDU
+    if (!gsm.m.sms.direct_format) {             /* +CMT: [<alpha>],<length> */
+        if (*str == '"') {
+            gsmi_parse_string(&str, e->name, sizeof(e->name), 1);
+        }
+        gsm.m.sms.pdu_len = 0;
+        gsm.m.sms.pdu_hex = 0;
+        return 1;
+    }
+#endif /* GSM_CFG_SMS_PDU */
+    gsmi_parse_string(&str, e->number, sizeof(e->number), 1);   /* +CMT: <oa>,[<alpha>],<scts> */
+    gsmi_parse_string(&str, e->name, sizeof(e->name), 1);
+    gsmi_parse_datetime(&str, &e->datetime);
+    return 1;
+}
+
+#endif /* GSM_CFG_SMS_DIRECT || __DOXYGEN__ */
+
 /**
  * \brief           Parse +CPMS statement
  * \param[in]       str: Input string
@@ -802,8 +935,11 @@ uint8_t
 gsmi_parse_cpbr(const char* str) {
     gsm_pb_entry_t* e;
 
-    if (!CMD_IS_DEF(GSM_CMD_CPBR) ||
-        gsm.msg->msg.pb_list.ei >= gsm.msg->msg.pb_list.etr) {
+    if (!(CMD_IS_DEF(GSM_CMD_CPBR)
+#if GSM_CFG_PHONEBOOK_CACHE
+        || CMD_IS_DEF(GSM_CMD_PB_CACHE_LOAD)
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
+        ) || gsm.msg->msg.pb_list.ei >= gsm.msg->msg.pb_list.etr) {
         return 0;
     }
 
@@ -879,12 +1015,21 @@ gsmi_parse_cipstatus_conn(const char* str, uint8_t is_conn_line, uint8_t* contin
     } else {
         /* Check if PDP context is deactivated or not */
         tmp_pdp_state = 1;
+        gsm.m.network.ip_state = GSM_IP_STATE_READY;
         if (!strncmp(&str[7], "IP INITIAL", 10)) {
             *continueScan = 0;                  /* Stop command execution at this point (no OK,ERROR received after this line) */
             tmp_pdp_state = 0;
+            gsm.m.network.ip_state = GSM_IP_STATE_INITIAL;
         } else if (!strncmp(&str[7], "PDP DEACT", 9)) {
             /* Deactivated */
             tmp_pdp_state = 0;
+            gsm.m.network.ip_state = GSM_IP_STATE_PDP_DEACT;
+        } else if (!strncmp(&str[7], "IP START", 8)) {
+            gsm.m.network.ip_state = GSM_IP_STATE_START;
+        } else if (!strncmp(&str[7], "IP CONFIG", 9)) {
+            gsm.m.network.ip_state = GSM_IP_STATE_CONFIG;
+        } else if (!strncmp(&str[7], "IP GPRSACT", 10)) {
+            gsm.m.network.ip_state = GSM_IP_STATE_GPRSACT;
         }
 
         /* Check if we have to update status for application */
@@ -893,6 +1038,9 @@ gsmi_parse_cipstatus_conn(const char* str, uint8_t is_conn_line, uint8_t* contin
 
             /* Notify upper layer */
             gsmi_send_cb(gsm.m.network.is_attached ? GSM_EVT_NETWORK_ATTACHED : GSM_EVT_NETWORK_DETACHED);
+#if GSM_CFG_NETWORK_TRACKER
+            gsmi_network_tracker_update();
+#endif /* GSM_CFG_NETWORK_TRACKER */
         }
 
         return 1;
@@ -39,8 +39,14 @@
 
 #if !__DOXYGEN__
 #define CHECK_ENABLED()                 if (!(check_enabled() == gsmOK)) { return gsmERRNOTENABLED; }
+#define PB_CACHE_NUM_MATCH              8   /* Number of trailing digits used to match phone numbers */
 #endif /* !__DOXYGEN__ */
 
+#if GSM_CFG_PHONEBOOK_CACHE
+static uint8_t  prv_cache_read(gsm_mem_t mem, size_t pos, gsm_pb_entry_t* entry);
+static uint8_t  prv_cache_search(gsm_mem_t mem, const char* search, gsm_pb_entry_t* entries, size_t etr, size_t* er);
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
+
 /**
  * \brief           Check if phonebook is enabled
  * \return          \ref gsmOK on success, member of \ref gsmr_t otherwise
@@ -150,6 +156,8 @@ gsm_pb_add(gsm_mem_t mem, const char* name, const char* num, gsm_number_type_t t
 
 /**
  * \brief           Read single phonebook entry
+ * \note            When complete mirror of memory is loaded with \ref gsm_pb_cache_load
+ *                  and contains entry, it is read from mirror without communication with device
  * \param[in]       mem: Memory to use to save entry. Use \ref GSM_MEM_CURRENT to use current memory
  * \param[in]       pos: Entry position in memory to read
  * \param[out]      entry: Pointer to entry variable to save data
@@ -161,6 +169,17 @@ gsm_pb_add(gsm_mem_t mem, const char* name, const char* num, gsm_number_type_t t
 gsmr_t
 gsm_pb_read(gsm_mem_t mem, size_t pos, gsm_pb_entry_t* entry,
                 const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+#if GSM_CFG_PHONEBOOK_CACHE
+    GSM_ASSERT("entry != NULL", entry != NULL);
+    CHECK_ENABLED();                            /* Check if enabled */
+
+    if (prv_cache_read(mem, pos, entry)) {
+        if (evt_fn != NULL) {
+            evt_fn(gsmOK, evt_arg);
+        }
+        return gsmOK;
+    }
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
     return gsm_pb_list(mem, pos, entry, 1, NULL, evt_fn, evt_arg, blocking);
 }
 
@@ -287,6 +306,8 @@ gsm_pb_list(gsm_mem_t mem, size_t start_index, gsm_pb_entry_t* entries, size_t e
 /**
  * \brief           Search for entires with specific name from specific memory
  * \note            Search works by entry name only. Phone number search is not available
+ * \note            When complete mirror of memory is loaded with \ref gsm_pb_cache_load,
+ *                  entries with name starting with `search` are found in mirror without communication with device
  * \param[in]       mem: Memory to use to save entry. Use \ref GSM_MEM_CURRENT to use current memory
  * \param[in]       search: String to search for
  * \param[out]      entries: Pointer to array to save entries
@@ -308,6 +329,15 @@ gsm_pb_search(gsm_mem_t mem, const char* search, gsm_pb_entry_t* entries, size_t
     CHECK_ENABLED();                            /* Check if enabled */
     GSM_ASSERT("check_mem() == mem", check_mem(mem, 1) == gsmOK);
 
+#if GSM_CFG_PHONEBOOK_CACHE
+    if (prv_cache_search(mem, search, entries, etr, er)) {
+        if (evt_fn != NULL) {
+            evt_fn(gsmOK, evt_arg);
+        }
+        return gsmOK;
+    }
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
+
     GSM_MSG_VAR_ALLOC(msg, blocking);
     GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
 
@@ -331,4 +361,397 @@ gsm_pb_search(gsm_mem_t mem, const char* search, gsm_pb_entry_t* entries, size_t
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
 }
 
+#if GSM_CFG_PHONEBOOK_CACHE || __DOXYGEN__
+
+/**
+ * \brief           Get matching key of phone number
+ *
+ * Key consists of last `PB_CACHE_NUM_MATCH` digits of number, all other characters are ignored.
+ * This allows `+38640123456` and `040123456` to match each other
+ *
+ * \param[in]       num: Phone number
+ * \param[out]      key: Output key of at least `PB_CACHE_NUM_MATCH + 1` bytes
+ */
+static void
+prv_num_key(const char* num, char* key) {
+    size_t digits = 0, cnt = 0;
+
+    for (const char* s = num; *s != '\0'; ++s) {
+        if (*s >= '0' && *s <= '9') {
+            ++digits;
+        }
+    }
+    for (; *num != '\0'; ++num) {
+        if (*num >= '0' && *num <= '9') {
+            if (digits-- <= PB_CACHE_NUM_MATCH) {
+                key[cnt++] = *num;
+            }
+        }
+    }
+    key[cnt] = '\0';
+}
+
+/**
+ * \brief           Get hash bucket for phone number key
+ * \param[in]       key: Key from \ref prv_num_key
+ * \return          Bucket index
+ */
+static size_t
+prv_num_bucket(const char* key) {
+    uint32_t h = 5381;
+
+    for (; *key != '\0'; ++key) {
+        h = ((h << 5) + h) + (uint8_t)*key;
+    }
+    return (size_t)(h % GSM_CFG_PHONEBOOK_CACHE_SIZE);
+}
+
+/**
+ * \brief           Compare name with prefix, case insensitive
+ * \param[in]       name: Entry name
+ * \param[in]       prefix: Prefix to compare. Set `len` to `SIZE_MAX` for full compare
+ * \param[in]       len: Number of characters to compare
+ * \return          Negative, `0` or positive value, like `strncmp`
+ */
+static int
+prv_name_cmp(const char* name, const char* prefix, size_t len) {
+    for (; len > 0; --len, ++name, ++prefix) {
+        int a = (uint8_t)*name, b = (uint8_t)*prefix;
+        if (a >= 'A' && a <= 'Z') {
+            a += 'a' - 'A';
+        }
+        if (b >= 'A' && b <= 'Z') {
+            b += 'a' - 'A';
+        }
+        if (a != b || a == 0) {
+            return a - b;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Rebuild number hash and sorted name index of phonebook mirror
+ */
+static void
+prv_cache_rebuild(void) {
+    gsm_pb_cache_t* c = &gsm.m.pb.cache;
+    char key[PB_CACHE_NUM_MATCH + 1];
+    size_t b, j;
+
+    GSM_MEMSET(c->hash, 0x00, sizeof(c->hash));
+    for (size_t i = 0; i < c->count; ++i) {
+        prv_num_key(c->entries[i].number, key);
+        b = prv_num_bucket(key);
+        c->next[i] = c->hash[b];
+        c->hash[b] = (uint16_t)(i + 1);
+
+        /* Insertion sort by name, mirror is small */
+        for (j = i; j > 0
+            && prv_name_cmp(c->entries[c->name_idx[j - 1]].name, c->entries[i].name, SIZE_MAX) > 0; --j) {
+            c->name_idx[j] = c->name_idx[j - 1];
+        }
+        c->name_idx[j] = (uint16_t)i;
+    }
+}
+
+/**
+ * \brief           Find entries by name prefix in phonebook mirror
+ * \note            Function must be called with core locked
+ * \param[in]       prefix: Name prefix to search for
+ * \param[out]      entries: Pointer to array to save entries
+ * \param[in]       etr: Number of entries to read
+ * \return          Number of entries found
+ */
+static size_t
+prv_cache_find_name(const char* prefix, gsm_pb_entry_t* entries, size_t etr) {
+    gsm_pb_cache_t* c = &gsm.m.pb.cache;
+    size_t lo = 0, hi = c->count, mid, len = strlen(prefix), cnt = 0;
+
+    while (lo < hi) {                           /* Find first entry not lower than prefix */
+        mid = (lo + hi) / 2;
+        if (prv_name_cmp(c->entries[c->name_idx[mid]].name, prefix, len) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    for (; lo < c->count && cnt < etr
+        && !prv_name_cmp(c->entries[c->name_idx[lo]].name, prefix, len); ++lo, ++cnt) {
+        entries[cnt] = c->entries[c->name_idx[lo]];
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Check if phonebook mirror holds all entries of memory
+ * \note            Function must be called with core locked
+ * \param[in]       mem: Memory to check. Use \ref GSM_MEM_CURRENT to use current memory
+ * \return          `1` if mirror may be used instead of device, `0` otherwise
+ */
+static uint8_t
+prv_cache_is_complete(gsm_mem_t mem) {
+    gsm_pb_cache_t* c = &gsm.m.pb.cache;
+
+    if (mem == GSM_MEM_CURRENT) {
+        mem = gsm.m.pb.mem.current;
+    }
+    return c->valid && c->complete && c->mem == mem;
+}
+
+/**
+ * \brief           Read single entry from complete phonebook mirror
+ * \param[in]       mem: Memory to read from
+ * \param[in]       pos: Entry position in memory
+ * \param[out]      entry: Pointer to entry variable to save data
+ * \return          `1` if entry was read from mirror, `0` when device must be asked
+ */
+static uint8_t
+prv_cache_read(gsm_mem_t mem, size_t pos, gsm_pb_entry_t* entry) {
+    gsm_pb_cache_t* c = &gsm.m.pb.cache;
+    uint8_t res = 0;
+
+    gsm_core_lock();
+    if (prv_cache_is_complete(mem)) {
+        for (size_t i = 0; i < c->count; ++i) {
+            if (c->entries[i].pos == pos) {
+                *entry = c->entries[i];
+                res = 1;
+                break;
+            }
+        }
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Search entries by name in complete phonebook mirror
+ * \param[in]       mem: Memory to search in
+ * \param[in]       search: Name prefix to search for
+ * \param[out]      entries: Pointer to array to save entries
+ * \param[in]       etr: Number of entries to read
+ * \param[out]      er: Pointer to output variable to save entries found
+ * \return          `1` if search was done in mirror, `0` when device must be asked
+ */
+static uint8_t
+prv_cache_search(gsm_mem_t mem, const char* search, gsm_pb_entry_t* entries, size_t etr, size_t* er) {
+    size_t cnt = 0;
+    uint8_t res;
+
+    gsm_core_lock();
+    if ((res = prv_cache_is_complete(mem)) != 0) {
+        GSM_MEMSET(entries, 0x00, sizeof(*entries) * etr);
+        cnt = prv_cache_find_name(search, entries, etr);
+    }
+    gsm_core_unlock();
+    if (res && er != NULL) {
+        *er = cnt;
+    }
+    return res;
+}
+
+/**
+ * \brief           Process finished read of phonebook mirror
+ * \note            Entries are already written to mirror by \ref gsmi_parse_cpbr
+ * \param[in]       count: Number of entries read
+ */
+void
+gsmi_pb_cache_loaded(size_t count) {
+    gsm_pb_cache_t* c = &gsm.m.pb.cache;
+
+    c->mem = gsm.m.pb.mem.current;
+    c->count = GSM_MIN(count, GSM_ARRAYSIZE(c->entries));
+    for (size_t i = 0; i < c->count; ++i) {
+        c->entries[i].mem = c->mem;
+    }
+    c->complete = c->count >= gsm.m.pb.mem.used;
+    c->valid = 1;
+    prv_cache_rebuild();
+}
+
+/**
+ * \brief           Apply successful write or delete to phonebook mirror
+ * \param[in]       mem: Memory entry was written to
+ * \param[in]       pos: Entry position. `0` when device selected position itself
+ * \param[in]       name: Entry name
+ * \param[in]       num: Entry number
+ * \param[in]       type: Entry number type
+ * \param[in]       del: Set to `1` if entry was deleted
+ */
+void
+gsmi_pb_cache_write(gsm_mem_t mem, size_t pos, const char* name, const char* num, gsm_number_type_t type, uint8_t del) {
+    gsm_pb_cache_t* c = &gsm.m.pb.cache;
+    size_t i;
+
+    if (!c->valid || c->mem != mem) {
+        return;
+    }
+    if (pos == 0) {                             /* Unknown position, mirror misses one entry */
+        c->complete = 0;
+        return;
+    }
+    for (i = 0; i < c->count && c->entries[i].pos != pos; ++i) {}
+    if (del) {
+        if (i < c->count) {
+            c->entries[i] = c->entries[--c->count];
+        }
+    } else {
+        if (i == c->count) {
+            if (c->count == GSM_ARRAYSIZE(c->entries)) {
+                c->complete = 0;                /* Mirror full */
+                return;
+            }
+            ++c->count;
+        }
+        GSM_MEMSET(&c->entries[i], 0x00, sizeof(c->entries[i]));
+        c->entries[i].mem = mem;
+        c->entries[i].pos = pos;
+        c->entries[i].type = type;
+        GSM_MEMCPY(c->entries[i].name, name, GSM_MIN(strlen(name), sizeof(c->entries[i].name) - 1));
+        GSM_MEMCPY(c->entries[i].number, num, GSM_MIN(strlen(num), sizeof(c->entries[i].number) - 1));
+    }
+    prv_cache_rebuild();
+}
+
+/**
+ * \brief           Get first free position in memory, based on phonebook mirror
+ * \param[in]       mem: Memory to check
+ * \return          Free position or `0` if mirror cannot tell
+ */
+size_t
+gsmi_pb_cache_get_free_pos(gsm_mem_t mem) {
+    gsm_pb_cache_t* c = &gsm.m.pb.cache;
+    size_t i;
+
+    if (!c->valid || !c->complete || c->mem != mem
+        || c->count >= GSM_ARRAYSIZE(c->entries)) {
+        return 0;
+    }
+    for (size_t pos = 1; pos <= gsm.m.pb.mem.total; ++pos) {
+        for (i = 0; i < c->count && c->entries[i].pos != pos; ++i) {}
+        if (i == c->count) {
+            return pos;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Find entry in phonebook mirror by phone number
+ * \param[in]       num: Phone number to search for
+ * \return          Pointer to entry or `NULL` if not found
+ */
+const gsm_pb_entry_t*
+gsmi_pb_cache_find_number(const char* num) {
+    gsm_pb_cache_t* c = &gsm.m.pb.cache;
+    char key[PB_CACHE_NUM_MATCH + 1], ekey[PB_CACHE_NUM_MATCH + 1];
+
+    if (!c->valid || num == NULL) {
+        return NULL;
+    }
+    prv_num_key(num, key);
+    if (key[0] == '\0') {
+        return NULL;
+    }
+    for (uint16_t i = c->hash[prv_num_bucket(key)]; i > 0; i = c->next[i - 1]) {
+        prv_num_key(c->entries[i - 1].number, ekey);
+        if (!strcmp(key, ekey)) {
+            return &c->entries[i - 1];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Load phonebook memory to RAM mirror
+ *
+ * All entries are read with single `AT+CPBR` command.
+ * Afterwards, \ref gsm_pb_cache_find_number and \ref gsm_pb_cache_find_name
+ * work without communication with device
+ *
+ * \param[in]       mem: Memory to mirror. Use \ref GSM_MEM_CURRENT to use current memory
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t otherwise
+ */
+gsmr_t
+gsm_pb_cache_load(gsm_mem_t mem, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    CHECK_ENABLED();                            /* Check if enabled */
+    GSM_ASSERT("check_mem() == gsmOK", check_mem(mem, 1) == gsmOK);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_PB_CACHE_LOAD;
+    if (mem == GSM_MEM_CURRENT) {
+        GSM_MSG_VAR_REF(msg).cmd = GSM_CMD_CPBS_GET;    /* Get memory info only */
+    } else {
+        GSM_MSG_VAR_REF(msg).cmd = GSM_CMD_CPBS_SET;    /* First set memory */
+    }
+
+    GSM_MSG_VAR_REF(msg).msg.pb_list.mem = mem;
+    GSM_MSG_VAR_REF(msg).msg.pb_list.start_index = 1;
+    GSM_MSG_VAR_REF(msg).msg.pb_list.entries = gsm.m.pb.cache.entries;
+    GSM_MSG_VAR_REF(msg).msg.pb_list.etr = GSM_CFG_PHONEBOOK_CACHE_SIZE;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
+}
+
+/**
+ * \brief           Find entry by phone number in phonebook mirror
+ * \note            Last `8` digits of numbers are compared, other characters are ignored
+ * \param[in]       num: Phone number to search for
+ * \param[out]      entry: Pointer to entry variable to save data
+ * \return          \ref gsmOK if found, \ref gsmERR if not found or mirror is not loaded
+ */
+gsmr_t
+gsm_pb_cache_find_number(const char* num, gsm_pb_entry_t* entry) {
+    const gsm_pb_entry_t* e;
+    gsmr_t res = gsmERR;
+
+    GSM_ASSERT("num != NULL", num != NULL);
+    GSM_ASSERT("entry != NULL", entry != NULL);
+
+    gsm_core_lock();
+    if ((e = gsmi_pb_cache_find_number(num)) != NULL) {
+        *entry = *e;
+        res = gsmOK;
+    }
+    gsm_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Find entries by name prefix in phonebook mirror
+ * \note            Compare is case insensitive. Entries are returned sorted by name
+ * \param[in]       prefix: Name prefix to search for. Use empty string to list all entries
+ * \param[out]      entries: Pointer to array to save entries
+ * \param[in]       etr: Number of entries to read
+ * \param[out]      er: Pointer to output variable to save entries found
+ * \return          \ref gsmOK if at least one entry found, \ref gsmERR otherwise
+ */
+gsmr_t
+gsm_pb_cache_find_name(const char* prefix, gsm_pb_entry_t* entries, size_t etr, size_t* er) {
+    size_t cnt = 0;
+
+    GSM_ASSERT("prefix != NULL", prefix != NULL);
+    GSM_ASSERT("entries != NULL", entries != NULL);
+    GSM_ASSERT("etr > 0", etr > 0);
+
+    gsm_core_lock();
+    if (gsm.m.pb.cache.valid) {
+        cnt = prv_cache_find_name(prefix, entries, etr);
+    }
+    gsm_core_unlock();
+    if (er != NULL) {
+        *er = cnt;
+    }
+    return cnt > 0 ? gsmOK : gsmERR;
+}
+
+#endif /* GSM_CFG_PHONEBOOK_CACHE || __DOXYGEN__ */
+
 #endif /* GSM_CFG_PHONEBOOK || __DOXYGEN__ */
@@ -41,6 +41,12 @@
 #define GSM_SMS_SEND_IDX                1   /*!< Send index for memory array */
 #define GSM_SMS_RECEIVE_IDX             2   /*!< Receive index for memory array */
 
+#if GSM_CFG_SMS_PDU
+#define GSM_SMS_FORMAT                  0   /*!< Messages are sent, read and listed in PDU mode */
+#else /* GSM_CFG_SMS_PDU */
+#define GSM_SMS_FORMAT                  1   /*!< Messages are sent, read and listed in text mode */
+#endif /* !GSM_CFG_SMS_PDU */
+
 #if !__DOXYGEN__
 #define CHECK_ENABLED()                 if (!(check_enabled() == gsmOK)) { return gsmERRNOTENABLED; }
 #define CHECK_READY()                   if (!(check_ready() == gsmOK)) { return gsmERR; }
@@ -90,6 +96,33 @@ check_sms_mem(gsm_mem_t mem, uint8_t can_curr) {
     return res;
 }
 
+#if GSM_CFG_SMS_PDU || __DOXYGEN__
+
+/**
+ * \brief           Get number of messages needed to send data in PDU mode
+ * \param[in]       num: Phone number
+ * \param[in]       data: UTF-8 text or binary data
+ * \param[in]       len: Length of data in units of bytes
+ * \param[in]       dcs: Data coding scheme
+ * \return          Number of messages or `0` if data cannot be sent
+ */
+static size_t
+get_pdu_parts(const char* num, const void* data, size_t len, gsm_sms_dcs_t dcs) {
+#if GSM_CFG_SMS_CONCAT
+    size_t parts;
+
+    if (gsm_sms_pdu_encode(num, data, 0, dcs, NULL, 0, NULL, 0) == 0) {
+        return 0;                               /* Invalid phone number */
+    }
+    parts = gsm_sms_pdu_get_parts(data, len, dcs, GSM_SMS_PDU_CONCAT_UDH_LEN(GSM_CFG_SMS_CONCAT_REF16));
+    return parts <= GSM_CFG_SMS_CONCAT_MAX_PARTS ? parts : 0;
+#else /* GSM_CFG_SMS_CONCAT */
+    return gsm_sms_pdu_encode(num, data, len, dcs, NULL, 0, NULL, 0) > 0;
+#endif /* !GSM_CFG_SMS_CONCAT */
+}
+
+#endif /* GSM_CFG_SMS_PDU || __DOXYGEN__ */
+
 /**
  * \brief           Enable SMS functionality
  * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
@@ -130,6 +163,11 @@ gsm_sms_disable(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint
 
 /**
  * \brief           Send SMS text to phone number
+ *
+ * When \ref GSM_CFG_SMS_PDU is enabled, UTF-8 text is sent with GSM 03.38 alphabet when possible
+ * (maximal `160` characters) or as UCS2 otherwise (maximal `70` characters).
+ * With \ref GSM_CFG_SMS_CONCAT enabled, longer text is split to up to \ref GSM_CFG_SMS_CONCAT_MAX_PARTS messages
+ *
  * \param[in]       num: String number
  * \param[in]       text: Text to send. Maximal `160` characters
  * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
@@ -140,6 +178,11 @@ gsm_sms_disable(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint
 gsmr_t
 gsm_sms_send(const char* num, const char* text,
                 const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+#if GSM_CFG_SMS_PDU
+    GSM_ASSERT("text != NULL && text[0] > 0", text != NULL && text[0] > 0);
+
+    return gsm_sms_send_data(num, text, strlen(text), gsm_sms_pdu_get_dcs(text, strlen(text)), evt_fn, evt_arg, blocking);
+#else /* GSM_CFG_SMS_PDU */
     GSM_MSG_VAR_DEFINE(msg);
 
     GSM_ASSERT("num != NULL && num[0] > 0", num != NULL && num[0] > 0);
@@ -156,6 +199,113 @@ gsm_sms_send(const char* num, const char* text,
     GSM_MSG_VAR_REF(msg).msg.sms_send.format = 1;   /* Send as plain text */
 
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
+#endif /* !GSM_CFG_SMS_PDU */
+}
+
+#if GSM_CFG_SMS_PDU || __DOXYGEN__
+
+/**
+ * \brief           Send SMS data to phone number in PDU mode
+ * \note            \ref GSM_CFG_SMS_PDU must be enabled to use this function
+ * \param[in]       num: String number
+ * \param[in]       data: UTF-8 text for \ref GSM_SMS_DCS_GSM7 and \ref GSM_SMS_DCS_UCS2 or binary data for \ref GSM_SMS_DCS_8BIT.
+ *                      Memory must stay valid until command is executed
+ * \param[in]       len: Length of data in units of bytes. Encoded data must fit single message,
+ *                      `160` characters with GSM alphabet or `140` bytes otherwise.
+ *                      With \ref GSM_CFG_SMS_CONCAT enabled, data are split to up to \ref GSM_CFG_SMS_CONCAT_MAX_PARTS messages,
+ *                      each with `153` GSM characters, `67` UCS2 characters or `134` bytes
+ *                      (one less with \ref GSM_CFG_SMS_CONCAT_REF16)
+ * \param[in]       dcs: Data coding scheme
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t otherwise
+ */
+gsmr_t
+gsm_sms_send_data(const char* num, const void* data, size_t len, gsm_sms_dcs_t dcs,
+                    const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+    size_t parts;
+
+    GSM_ASSERT("num != NULL && num[0] > 0", num != NULL && num[0] > 0);
+    GSM_ASSERT("data != NULL && len > 0", data != NULL && len > 0);
+    parts = get_pdu_parts(num, data, len, dcs);
+    GSM_ASSERT("parts > 0", parts > 0);
+    CHECK_ENABLED();                            /* Check if enabled */
+    CHECK_READY();                              /* Check if ready */
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_CMGS;
+    GSM_MSG_VAR_REF(msg).cmd = GSM_CMD_CMGF;
+    GSM_MSG_VAR_REF(msg).msg.sms_send.num = num;
+    GSM_MSG_VAR_REF(msg).msg.sms_send.text = data;
+    GSM_MSG_VAR_REF(msg).msg.sms_send.len = len;
+    GSM_MSG_VAR_REF(msg).msg.sms_send.dcs = dcs;
+    GSM_MSG_VAR_REF(msg).msg.sms_send.parts = GSM_U8(parts);
+    GSM_MSG_VAR_REF(msg).msg.sms_send.part_len = len;   /* Single message by default */
+    GSM_MSG_VAR_REF(msg).msg.sms_send.format = 0;   /* Send as PDU */
+#if GSM_CFG_SMS_CONCAT
+    if (parts > 1) {
+        gsm_core_lock();
+        GSM_MSG_VAR_REF(msg).msg.sms_send.ref = ++gsm.m.sms.concat_ref;
+        gsm_core_unlock();
+    }
+#endif /* GSM_CFG_SMS_CONCAT */
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
+}
+
+#endif /* GSM_CFG_SMS_PDU || __DOXYGEN__ */
+
+/**
+ * \brief           Send SMS text to multiple phone numbers with single command
+ *
+ * Message format is set only once and `AT+CMMS=2` command keeps relay link
+ * to network open between messages, to avoid link setup for every message.
+ *
+ * Result of every entry is written to entry structure and reported with
+ * \ref GSM_EVT_SMS_SEND_BATCH event. Failed entry does not stop batch operation
+ *
+ * \param[in,out]   entries: Array of entries to send. Entries with numbers and texts must stay valid
+ *                      until command is finished. Each text follows the same rules as for \ref gsm_sms_send
+ * \param[in]       count: Number of entries in array
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK when all messages have been sent, member of \ref gsmr_t otherwise
+ */
+gsmr_t
+gsm_sms_send_batch(gsm_sms_batch_entry_t* entries, size_t count,
+                    const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_ASSERT("entries != NULL", entries != NULL);
+    GSM_ASSERT("count > 0", count > 0);
+    for (size_t i = 0; i < count; ++i) {
+        GSM_ASSERT("num != NULL && num[0] > 0", entries[i].num != NULL && entries[i].num[0] > 0);
+        GSM_ASSERT("text != NULL && text[0] > 0", entries[i].text != NULL && entries[i].text[0] > 0);
+#if GSM_CFG_SMS_PDU
+        GSM_ASSERT("get_pdu_parts() > 0", get_pdu_parts(entries[i].num, entries[i].text, strlen(entries[i].text),
+            gsm_sms_pdu_get_dcs(entries[i].text, strlen(entries[i].text))) > 0);
+#else /* GSM_CFG_SMS_PDU */
+        GSM_ASSERT("strlen(text) <= 160", strlen(entries[i].text) <= 160);
+#endif /* !GSM_CFG_SMS_PDU */
+        entries[i].res = gsmERR;
+        entries[i].pos = 0;
+    }
+    CHECK_ENABLED();                            /* Check if enabled */
+    CHECK_READY();                              /* Check if ready */
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_SMS_SEND_BATCH;
+    GSM_MSG_VAR_REF(msg).cmd = GSM_CMD_CMGF;
+    GSM_MSG_VAR_REF(msg).msg.sms_send.entries = entries;
+    GSM_MSG_VAR_REF(msg).msg.sms_send.count = count;
+    GSM_MSG_VAR_REF(msg).msg.sms_send.format = GSM_SMS_FORMAT;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000 * GSM_U32(count));
 }
 
 /**
@@ -196,7 +346,7 @@ gsm_sms_read(gsm_mem_t mem, size_t pos, gsm_sms_entry_t* entry, uint8_t update,
     GSM_MSG_VAR_REF(msg).msg.sms_read.pos = pos;
     GSM_MSG_VAR_REF(msg).msg.sms_read.entry = entry;
     GSM_MSG_VAR_REF(msg).msg.sms_read.update = update;
-    GSM_MSG_VAR_REF(msg).msg.sms_read.format = 1;   /* Send as plain text */
+    GSM_MSG_VAR_REF(msg).msg.sms_read.format = GSM_SMS_FORMAT;
 
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
 }
@@ -302,11 +452,108 @@ gsm_sms_list(gsm_mem_t mem, gsm_sms_status_t stat, gsm_sms_entry_t* entries, siz
     GSM_MSG_VAR_REF(msg).msg.sms_list.etr = etr;
     GSM_MSG_VAR_REF(msg).msg.sms_list.er = er;
     GSM_MSG_VAR_REF(msg).msg.sms_list.update = update;
-    GSM_MSG_VAR_REF(msg).msg.sms_list.format = 1;   /* Send as plain text */
+    GSM_MSG_VAR_REF(msg).msg.sms_list.format = GSM_SMS_FORMAT;
 
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
 }
 
+/**
+ * \brief           List SMS from SMS memory and pass every entry to callback function
+ *
+ * Single entry is used for all messages, so memory usage does not depend on number of messages in storage.
+ * Callback is called from processing thread, it must not call blocking API functions
+ *
+ * \param[in]       mem: Memory to read entries from. Use \ref GSM_MEM_CURRENT to read from current memory
+ * \param[in]       stat: SMS status to read, either `read`, `unread`, `sent`, `unsent` or `all`
+ * \param[in]       number: Phone number to filter entries. Set to `NULL` to pass all entries to callback
+ * \param[in]       entry: Pointer to entry used to parse every message
+ * \param[in]       fn: Callback function called for every listed entry
+ * \param[in]       fn_arg: Custom argument for entry callback function
+ * \param[out]      er: Pointer to output variable to save number of entries passed to callback
+ * \param[in]       update: Flag indicates update. Set to `1` to change `UNREAD` messages to `READ` or `0` to leave as is
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t otherwise
+ */
+gsmr_t
+gsm_sms_list_cb(gsm_mem_t mem, gsm_sms_status_t stat, const char* number, gsm_sms_entry_t* entry,
+                gsm_sms_list_fn fn, void* fn_arg, size_t* er, uint8_t update,
+                const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_ASSERT("entry != NULL", entry != NULL);
+    GSM_ASSERT("fn != NULL", fn != NULL);
+    CHECK_ENABLED();                            /* Check if enabled */
+    CHECK_READY();                              /* Check if ready */
+    GSM_ASSERT("check_sms_mem() == gsmOK", check_sms_mem(mem, 1) == gsmOK);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+
+    if (er != NULL) {
+        *er = 0;
+    }
+    GSM_MEMSET(entry, 0x00, sizeof(*entry));    /* Reset data structure */
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_CMGL;
+    if (mem == GSM_MEM_CURRENT) {
+        GSM_MSG_VAR_REF(msg).cmd = GSM_CMD_CPMS_GET;    /* First get memory */
+    } else {
+        GSM_MSG_VAR_REF(msg).cmd = GSM_CMD_CPMS_SET;    /* First set memory */
+    }
+    GSM_MSG_VAR_REF(msg).msg.sms_list.mem = mem;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.status = stat;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.entries = entry;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.etr = 1;  /* Entry is reused for every message */
+    GSM_MSG_VAR_REF(msg).msg.sms_list.er = er;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.fn = fn;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.fn_arg = fn_arg;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.number = number;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.update = update;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.format = GSM_SMS_FORMAT;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
+}
+
+#if GSM_CFG_SMS_DRAIN || __DOXYGEN__
+
+/**
+ * \brief           Drain SMS receive storage
+ *
+ * Unread messages are listed from receive storage and reported one by one with \ref GSM_EVT_SMS_DRAIN event.
+ * Once listed, reported messages are deleted from storage by their position.
+ * Messages read by other means are never deleted by drain
+ *
+ * \note            Drain is started automatically on new message or when storage usage reaches \ref GSM_CFG_SMS_DRAIN_WATERMARK
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t otherwise
+ */
+gsmr_t
+gsm_sms_drain(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    CHECK_ENABLED();                            /* Check if enabled */
+    CHECK_READY();                              /* Check if ready */
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_SMS_DRAIN;
+    GSM_MSG_VAR_REF(msg).cmd = GSM_CMD_CPMS_GET;    /* Receive storage is selected on execution */
+    GSM_MSG_VAR_REF(msg).msg.sms_list.mem = GSM_MEM_CURRENT;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.status = GSM_SMS_STATUS_UNREAD;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.entries = &gsm.m.sms.drain;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.etr = 1;  /* Entry is reused for every message */
+    GSM_MSG_VAR_REF(msg).msg.sms_list.fn = gsmi_sms_drain_entry;
+    GSM_MSG_VAR_REF(msg).msg.sms_list.update = 0;   /* Messages not reported stay unread for next drain */
+    GSM_MSG_VAR_REF(msg).msg.sms_list.format = GSM_SMS_FORMAT;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 120000);
+}
+
+#endif /* GSM_CFG_SMS_DRAIN || __DOXYGEN__ */
+
 /**
  * \brief           Set preferred storage for SMS
  * \param[in]       mem1: Preferred memory for read/delete SMS operations. Use \ref GSM_MEM_CURRENT to keep it as is
@@ -343,4 +590,30 @@ gsm_sms_set_preferred_storage(gsm_mem_t mem1, gsm_mem_t mem2, gsm_mem_t mem3,
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
 }
 
+#if GSM_CFG_SMS_DIRECT || __DOXYGEN__
+
+/**
+ * \brief           Acknowledge SMS received with \ref GSM_EVT_SMS_DELIVER event
+ * \note            Required only when device is set to phase 2+ message service with `AT+CSMS=1`,
+ *                  otherwise network acknowledges message on its own
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t otherwise
+ */
+gsmr_t
+gsm_sms_ack(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    CHECK_ENABLED();                            /* Check if enabled */
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_CNMA;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
+}
+
+#endif /* GSM_CFG_SMS_DIRECT || __DOXYGEN__ */
+
 #endif /* GSM_CFG_SMS || __DOXYGEN__ */
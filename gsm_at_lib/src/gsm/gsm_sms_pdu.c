@@ -0,0 +1,953 @@
+/**
+ * \file            gsm_sms_pdu.c
+ * \brief           SMS PDU codec
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include "gsm/gsm_private.h"
+#include "gsm/gsm_sms_pdu.h"
+#include "gsm/gsm_unicode.h"
+
+#if (GSM_CFG_SMS && GSM_CFG_SMS_PDU) || __DOXYGEN__
+
+#define GSM7_ESC                        0x1B    /*!< Escape to extension table */
+#define GSM7_EXT                        0x80    /*!< Flag in reverse table, character is in extension table */
+#define GSM7_NONE                       0xFF    /*!< Value in reverse table, character is not in alphabet */
+
+#define PDU_FO_MTI_DELIVER              0x00    /*!< Message type indicator for SMS-DELIVER */
+#define PDU_FO_MTI_SUBMIT               0x01    /*!< Message type indicator for SMS-SUBMIT */
+#define PDU_FO_UDHI                     0x40    /*!< User data header indicator */
+
+#define PDU_IEI_CONCAT8                 0x00    /*!< Concatenated message information element, 8-bit reference */
+#define PDU_IEI_CONCAT16                0x08    /*!< Concatenated message information element, 16-bit reference */
+
+#define PDU_TOA_UNKNOWN                 0x81    /*!< Type of address, unknown numbering plan */
+#define PDU_TOA_INTERNATIONAL           0x91    /*!< Type of address, international number */
+#define PDU_TOA_TON_MASK                0x70    /*!< Type of number bits in type of address */
+#define PDU_TOA_TON_INTERNATIONAL       0x10    /*!< Type of number international */
+#define PDU_TOA_TON_ALPHANUMERIC        0x50    /*!< Type of number alphanumeric, GSM 7-bit encoded */
+
+/**
+ * \brief           GSM 03.38 default alphabet, indexed by septet value
+ *
+ * Escape character is set to `0`, it is never decoded directly
+ */
+static const uint16_t
+gsm7_default[128] = {
+    0x0040, 0x00A3, 0x0024, 0x00A5, 0x00E8, 0x00E9, 0x00F9, 0x00EC, 0x00F2, 0x00C7, 0x000A, 0x00D8, 0x00F8, 0x000D, 0x00C5, 0x00E5,
+    0x0394, 0x005F, 0x03A6, 0x0393, 0x039B, 0x03A9, 0x03A0, 0x03A8, 0x03A3, 0x0398, 0x039E, 0x0000, 0x00C6, 0x00E6, 0x00DF, 0x00C9,
+    0x0020, 0x0021, 0x0022, 0x0023, 0x00A4, 0x0025, 0x0026, 0x0027, 0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037, 0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,
+    0x00A1, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047, 0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,
+    0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057, 0x0058, 0x0059, 0x005A, 0x00C4, 0x00D6, 0x00D1, 0x00DC, 0x00A7,
+    0x00BF, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067, 0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+    0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077, 0x0078, 0x0079, 0x007A, 0x00E4, 0x00F6, 0x00F1, 0x00FC, 0x00E0,
+};
+
+/**
+ * \brief           GSM 03.38 extension table
+ */
+static const struct {
+    uint8_t septet;                             /*!< Septet value following escape character */
+    uint16_t cp;                                /*!< Unicode code point */
+} gsm7_ext[] = {
+    {0x0A, 0x000C}, {0x14, 0x005E}, {0x28, 0x007B}, {0x29, 0x007D}, {0x2F, 0x005C},
+    {0x3C, 0x005B}, {0x3D, 0x007E}, {0x3E, 0x005D}, {0x40, 0x007C}, {0x65, 0x20AC},
+};
+
+/**
+ * \brief           Reverse table for ASCII characters to GSM 03.38 septets
+ *
+ * Values with \ref GSM7_EXT bit set are in extension table,
+ * \ref GSM7_NONE is used for characters not in alphabet
+ */
+static const uint8_t
+gsm7_from_ascii[128] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x0A, 0xFF, 0x8A, 0x0D, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x20, 0x21, 0x22, 0x23, 0x02, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
+    0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F,
+    0x00, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F,
+    0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0xBC, 0xAF, 0xBE, 0x94, 0x11,
+    0xFF, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F,
+    0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0xA8, 0xC0, 0xA9, 0xBD, 0xFF,
+};
+
+/**
+ * \brief           PDU output stream
+ *
+ * Octets are written to buffer, passed to output function or only counted,
+ * when buffer and function are both `NULL`
+ */
+typedef struct {
+    uint8_t* buff;                              /*!< Output buffer */
+    size_t size;                                /*!< Size of output buffer */
+    size_t len;                                 /*!< Number of octets written to output */
+    void (*fn)(uint8_t octet);                  /*!< Output function */
+    uint32_t acc;                               /*!< Bit accumulator for septet packing */
+    uint8_t bits;                               /*!< Number of valid bits in accumulator */
+} pdu_out_t;
+
+/**
+ * \brief           Write single octet to output stream
+ * \param[in]       o: Output stream
+ * \param[in]       octet: Octet to write
+ */
+static void
+out_octet(pdu_out_t* o, uint8_t octet) {
+    if (o->fn != NULL) {
+        o->fn(octet);
+    } else if (o->buff != NULL && o->len < o->size) {
+        o->buff[o->len] = octet;
+    }
+    ++o->len;
+}
+
+/**
+ * \brief           Pack single septet to output stream
+ * \param[in]       o: Output stream
+ * \param[in]       septet: Septet to write
+ */
+static void
+out_septet(pdu_out_t* o, uint8_t septet) {
+    o->acc |= GSM_U32(septet & 0x7F) << o->bits;
+    o->bits += 7;
+    while (o->bits >= 8) {
+        out_octet(o, GSM_U8(o->acc));
+        o->acc >>= 8;
+        o->bits -= 8;
+    }
+}
+
+/**
+ * \brief           Write remaining packed bits to output stream
+ * \param[in]       o: Output stream
+ */
+static void
+out_septet_flush(pdu_out_t* o) {
+    if (o->bits > 0) {
+        out_octet(o, GSM_U8(o->acc));
+    }
+    o->acc = 0;
+    o->bits = 0;
+}
+
+/**
+ * \brief           Get next unicode code point from UTF-8 text
+ * \param[in,out]   text: Pointer to text pointer, advanced after character
+ * \param[in,out]   len: Pointer to remaining text length, decreased after character
+ * \param[out]      cp: Output code point
+ * \return          `1` on success, `0` on invalid or incomplete UTF-8 sequence
+ */
+static uint8_t
+text_next_cp(const char** text, size_t* len, uint32_t* cp) {
+    gsm_unicode_t uni = {0};
+    gsmr_t res;
+
+    while (*len > 0) {
+        res = gsmi_unicode_decode(&uni, GSM_U8(**text));
+        ++*text;
+        --*len;
+        if (res == gsmOK) {
+            *cp = gsmi_unicode_get_code_point(&uni);
+            return 1;
+        } else if (res != gsmINPROG) {
+            break;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Find GSM 03.38 septet for unicode code point
+ * \param[in]       cp: Unicode code point
+ * \return          Septet value, septet value with \ref GSM7_EXT bit set for extension table
+ *                  or \ref GSM7_NONE when character is not in alphabet
+ */
+static uint8_t
+gsm7_lookup(uint32_t cp) {
+    if (cp < 0x80) {                            /* Fast path for ASCII text */
+        return gsm7_from_ascii[cp];
+    }
+    for (size_t i = 0; i < GSM_ARRAYSIZE(gsm7_default); ++i) {
+        if (gsm7_default[i] == cp) {
+            return GSM_U8(i);
+        }
+    }
+    for (size_t i = 0; i < GSM_ARRAYSIZE(gsm7_ext); ++i) {
+        if (gsm7_ext[i].cp == cp) {
+            return GSM_U8(GSM7_EXT | gsm7_ext[i].septet);
+        }
+    }
+    return GSM7_NONE;
+}
+
+/**
+ * \brief           Encode UTF-8 text to packed GSM 03.38 septets
+ * \param[in]       text: UTF-8 text
+ * \param[in]       len: Length of text in units of bytes
+ * \param[in]       o: Output stream
+ * \param[out]      septets: Number of septets written, including escape characters
+ * \return          `1` on success, `0` if text cannot be represented with GSM alphabet
+ */
+static uint8_t
+gsm7_write(const char* text, size_t len, pdu_out_t* o, size_t* septets) {
+    uint32_t cp;
+    uint8_t s;
+    size_t cnt = 0;
+
+    while (len > 0) {
+        if (!text_next_cp(&text, &len, &cp) || (s = gsm7_lookup(cp)) == GSM7_NONE) {
+            return 0;
+        }
+        if (s & GSM7_EXT) {
+            out_septet(o, GSM7_ESC);
+            ++cnt;
+        }
+        out_septet(o, s & 0x7F);
+        ++cnt;
+    }
+    *septets = cnt;
+    return 1;
+}
+
+/**
+ * \brief           Encode UTF-8 text to UCS2 big endian characters
+ *
+ * Characters outside basic multilingual plane are encoded as surrogate pairs
+ *
+ * \param[in]       text: UTF-8 text
+ * \param[in]       len: Length of text in units of bytes
+ * \param[in]       o: Output stream
+ * \return          `1` on success, `0` on invalid UTF-8 text
+ */
+static uint8_t
+ucs2_write(const char* text, size_t len, pdu_out_t* o) {
+    uint32_t cp;
+
+    while (len > 0) {
+        if (!text_next_cp(&text, &len, &cp)) {
+            return 0;
+        }
+        if (cp >= 0x10000) {
+            cp -= 0x10000;
+            out_octet(o, GSM_U8(0xD8 | ((cp >> 18) & 0x03)));
+            out_octet(o, GSM_U8(cp >> 10));
+            cp = 0xDC00 | (cp & 0x3FF);
+        }
+        out_octet(o, GSM_U8(cp >> 8));
+        out_octet(o, GSM_U8(cp));
+    }
+    return 1;
+}
+
+/**
+ * \brief           Write UTF-8 sequence for code point to output string
+ * \param[in]       cp: Unicode code point
+ * \param[out]      out: Output string
+ * \param[in]       out_size: Size of output string, including memory for `NULL` termination
+ * \param[in,out]   pos: Current write position, advanced on success
+ * \return          `1` on success, `0` if there is no memory for sequence
+ */
+static uint8_t
+utf8_put(uint32_t cp, char* out, size_t out_size, size_t* pos) {
+    char b[4];
+    size_t l;
+
+    l = gsmi_unicode_encode(cp, b);
+    if ((*pos + l) >= out_size) {
+        return 0;
+    }
+    GSM_MEMCPY(&out[*pos], b, l);
+    *pos += l;
+    return 1;
+}
+
+/**
+ * \brief           Get septet at specific bit position
+ * \param[in]       data: Packed data
+ * \param[in]       data_len: Length of packed data in units of bytes
+ * \param[in]       bit_pos: Bit position of septet
+ * \return          Septet value
+ */
+static uint8_t
+gsm7_get_septet(const uint8_t* data, size_t data_len, size_t bit_pos) {
+    size_t i = bit_pos >> 3;
+    uint8_t shift = GSM_U8(bit_pos & 0x07);
+    uint16_t v = 0;
+
+    if (i < data_len) {
+        v = data[i] >> shift;
+        if (shift > 1 && (i + 1) < data_len) {
+            v |= GSM_U16(data[i + 1]) << (8 - shift);
+        }
+    }
+    return GSM_U8(v & 0x7F);
+}
+
+/**
+ * \brief           Get data coding scheme for UTF-8 text
+ * \param[in]       text: UTF-8 text
+ * \param[in]       len: Length of text in units of bytes
+ * \return          \ref GSM_SMS_DCS_GSM7 if all characters are in GSM 03.38 alphabet,
+ *                  \ref GSM_SMS_DCS_UCS2 otherwise
+ */
+gsm_sms_dcs_t
+gsm_sms_pdu_get_dcs(const char* text, size_t len) {
+    pdu_out_t o = {0};
+    size_t septets;
+
+    return gsm7_write(text, len, &o, &septets) ? GSM_SMS_DCS_GSM7 : GSM_SMS_DCS_UCS2;
+}
+
+/**
+ * \brief           Encode UTF-8 text to packed GSM 03.38 alphabet
+ * \param[in]       text: UTF-8 text
+ * \param[in]       len: Length of text in units of bytes
+ * \param[in]       fill_bits: Number of zero bits before first septet, between `0` and `6`.
+ *                      Used to align septets after user data header
+ * \param[out]      out: Output memory for packed data
+ * \param[in]       out_size: Size of output memory in units of bytes
+ * \param[out]      septets: Optional output for number of encoded septets, including escape characters
+ * \return          Number of bytes written to output memory,
+ *                  or `0` if text cannot be represented with GSM alphabet or output memory is too small
+ */
+size_t
+gsm_sms_pdu_gsm7_encode(const char* text, size_t len, uint8_t fill_bits, uint8_t* out, size_t out_size, size_t* septets) {
+    pdu_out_t o = {0};
+    size_t cnt;
+
+    o.buff = out;
+    o.size = out_size;
+    o.bits = GSM_U8(fill_bits % 7);
+    if (!gsm7_write(text, len, &o, &cnt)) {
+        return 0;
+    }
+    out_septet_flush(&o);
+    if (o.len > out_size) {
+        return 0;
+    }
+    if (septets != NULL) {
+        *septets = cnt;
+    }
+    return o.len;
+}
+
+/**
+ * \brief           Decode packed GSM 03.38 septets to UTF-8 text
+ * \param[in]       data: Packed data
+ * \param[in]       data_len: Length of packed data in units of bytes
+ * \param[in]       septets: Number of septets to decode
+ * \param[in]       fill_bits: Number of bits before first septet, between `0` and `6`
+ * \param[out]      out: Output memory for UTF-8 text. It is always `NULL` terminated
+ * \param[in]       out_size: Size of output memory, including memory for `NULL` termination
+ * \return          Number of bytes written to output memory, excluding `NULL` termination
+ */
+size_t
+gsm_sms_pdu_gsm7_decode(const uint8_t* data, size_t data_len, size_t septets, uint8_t fill_bits, char* out, size_t out_size) {
+    size_t pos = 0;
+    uint8_t s;
+    uint32_t cp;
+
+    if (out_size == 0) {
+        return 0;
+    }
+    for (size_t i = 0; i < septets; ++i) {
+        s = gsm7_get_septet(data, data_len, fill_bits + i * 7);
+        if (s == GSM7_ESC && (i + 1) < septets) {
+            s = gsm7_get_septet(data, data_len, fill_bits + ++i * 7);
+            cp = gsm7_default[s];               /* Unknown extension is shown as default character */
+            for (size_t k = 0; k < GSM_ARRAYSIZE(gsm7_ext); ++k) {
+                if (gsm7_ext[k].septet == s) {
+                    cp = gsm7_ext[k].cp;
+                    break;
+                }
+            }
+        } else {
+            cp = s == GSM7_ESC ? ' ' : gsm7_default[s];
+        }
+        if (!utf8_put(cp, out, out_size, &pos)) {
+            break;
+        }
+    }
+    out[pos] = 0;
+    return pos;
+}
+
+/**
+ * \brief           Encode UTF-8 text to UCS2 big endian characters
+ * \param[in]       text: UTF-8 text
+ * \param[in]       len: Length of text in units of bytes
+ * \param[out]      out: Output memory for UCS2 data
+ * \param[in]       out_size: Size of output memory in units of bytes
+ * \return          Number of bytes written to output memory,
+ *                  or `0` on invalid text or if output memory is too small
+ */
+size_t
+gsm_sms_pdu_ucs2_encode(const char* text, size_t len, uint8_t* out, size_t out_size) {
+    pdu_out_t o = {0};
+
+    o.buff = out;
+    o.size = out_size;
+    if (!ucs2_write(text, len, &o) || o.len > out_size) {
+        return 0;
+    }
+    return o.len;
+}
+
+/**
+ * \brief           Decode UCS2 big endian characters to UTF-8 text
+ * \param[in]       data: UCS2 data
+ * \param[in]       len: Length of UCS2 data in units of bytes
+ * \param[out]      out: Output memory for UTF-8 text. It is always `NULL` terminated
+ * \param[in]       out_size: Size of output memory, including memory for `NULL` termination
+ * \return          Number of bytes written to output memory, excluding `NULL` termination
+ */
+size_t
+gsm_sms_pdu_ucs2_decode(const uint8_t* data, size_t len, char* out, size_t out_size) {
+    size_t pos = 0;
+    uint32_t cp, lo;
+
+    if (out_size == 0) {
+        return 0;
+    }
+    for (size_t i = 0; (i + 1) < len; i += 2) {
+        cp = (GSM_U32(data[i]) << 8) | data[i + 1];
+        if (cp >= 0xD800 && cp < 0xDC00 && (i + 3) < len) {    /* Surrogate pair */
+            lo = (GSM_U32(data[i + 2]) << 8) | data[i + 3];
+            if (lo >= 0xDC00 && lo < 0xE000) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                i += 2;
+            }
+        }
+        if (!utf8_put(cp, out, out_size, &pos)) {
+            break;
+        }
+    }
+    out[pos] = 0;
+    return pos;
+}
+
+/**
+ * \brief           Convert address character to semi-octet
+ * \param[in]       ch: Address character
+ * \return          Semi-octet value or `0xFF` if character is not allowed
+ */
+static uint8_t
+addr_char_to_semi_octet(char ch) {
+    if (GSM_CHARISNUM(ch)) {
+        return GSM_U8(GSM_CHARTONUM(ch));
+    } else if (ch == '*') {
+        return 0x0A;
+    } else if (ch == '#') {
+        return 0x0B;
+    }
+    return 0xFF;
+}
+
+/**
+ * \brief           Write destination address to output stream
+ * \param[in]       num: Phone number, optionally starting with `+` for international format
+ * \param[in]       o: Output stream
+ * \return          `1` on success, `0` on invalid number
+ */
+static uint8_t
+addr_write(const char* num, pdu_out_t* o) {
+    uint8_t toa = PDU_TOA_UNKNOWN, lo, hi;
+    size_t digits;
+
+    if (*num == '+') {
+        toa = PDU_TOA_INTERNATIONAL;
+        ++num;
+    }
+    digits = strlen(num);
+    if (digits == 0 || digits > 20) {
+        return 0;
+    }
+    for (size_t i = 0; i < digits; ++i) {
+        if (addr_char_to_semi_octet(num[i]) == 0xFF) {
+            return 0;
+        }
+    }
+
+    out_octet(o, GSM_U8(digits));
+    out_octet(o, toa);
+    for (size_t i = 0; i < digits; i += 2) {
+        lo = addr_char_to_semi_octet(num[i]);
+        hi = (i + 1) < digits ? addr_char_to_semi_octet(num[i + 1]) : 0x0F;
+        out_octet(o, GSM_U8((hi << 4) | lo));
+    }
+    return 1;
+}
+
+/**
+ * \brief           Read originating or destination address
+ * \param[in]       data: Address value, without length and type
+ * \param[in]       digits: Address length from PDU, in units of semi-octets
+ * \param[in]       toa: Type of address
+ * \param[out]      out: Output string
+ * \param[in]       out_size: Size of output string, including memory for `NULL` termination
+ */
+static void
+addr_read(const uint8_t* data, size_t digits, uint8_t toa, char* out, size_t out_size) {
+    static const char semi_octets[] = "0123456789*#abc";
+    size_t pos = 0;
+    uint8_t v;
+
+    if ((toa & PDU_TOA_TON_MASK) == PDU_TOA_TON_ALPHANUMERIC) {
+        gsm_sms_pdu_gsm7_decode(data, (digits + 1) / 2, digits * 4 / 7, 0, out, out_size);
+        return;
+    }
+    if ((toa & PDU_TOA_TON_MASK) == PDU_TOA_TON_INTERNATIONAL && (pos + 1) < out_size) {
+        out[pos++] = '+';
+    }
+    for (size_t i = 0; i < digits && (pos + 1) < out_size; ++i) {
+        v = (i & 0x01) ? (data[i / 2] >> 4) : (data[i / 2] & 0x0F);
+        if (v < 0x0F) {
+            out[pos++] = semi_octets[v];
+        }
+    }
+    if (out_size > 0) {
+        out[pos] = 0;
+    }
+}
+
+/**
+ * \brief           Read service center time stamp
+ * \param[in]       data: Time stamp with `7` semi-octet swapped bytes
+ * \param[out]      dt: Output date and time
+ */
+static void
+scts_read(const uint8_t* data, gsm_datetime_t* dt) {
+    uint8_t v[6];
+
+    for (size_t i = 0; i < GSM_ARRAYSIZE(v); ++i) {
+        v[i] = GSM_U8((data[i] & 0x0F) * 10 + (data[i] >> 4));
+    }
+    dt->year = GSM_U16(2000) + v[0];
+    dt->month = v[1];
+    dt->date = v[2];
+    dt->hours = v[3];
+    dt->minutes = v[4];
+    dt->seconds = v[5];
+    dt->day = 0;                                /* Day in a week is not part of time stamp */
+}
+
+/**
+ * \brief           Get alphabet from data coding scheme byte
+ * \param[in]       dcs: Data coding scheme byte from PDU
+ * \return          Alphabet of user data
+ */
+static gsm_sms_dcs_t
+dcs_read(uint8_t dcs) {
+    if ((dcs & 0x80) == 0x00) {                 /* General data coding groups */
+        switch (dcs & 0x0C) {
+            case 0x04: return GSM_SMS_DCS_8BIT;
+            case 0x08: return GSM_SMS_DCS_UCS2;
+            default: return GSM_SMS_DCS_GSM7;
+        }
+    } else if ((dcs & 0xF0) == 0xF0) {          /* Data coding and message class */
+        return (dcs & 0x04) ? GSM_SMS_DCS_8BIT : GSM_SMS_DCS_GSM7;
+    } else if ((dcs & 0xF0) == 0xE0) {          /* Message waiting indication, UCS2 */
+        return GSM_SMS_DCS_UCS2;
+    }
+    return GSM_SMS_DCS_GSM7;
+}
+
+/**
+ * \brief           Read concatenation information from user data header
+ * \param[in]       udh: User data header information elements, without header length byte
+ * \param[in]       len: Length of information elements
+ * \param[out]      e: SMS entry to set concatenation information to
+ */
+static void
+udh_read(const uint8_t* udh, size_t len, gsm_sms_entry_t* e) {
+    uint8_t iei, iel;
+
+    for (size_t i = 0; (i + 2) <= len; i += iel) {
+        iei = udh[i];
+        iel = udh[i + 1];
+        i += 2;
+        if ((i + iel) > len) {
+            break;
+        }
+        if (iei == PDU_IEI_CONCAT8 && iel == 3) {
+            e->concat_ref = udh[i];
+            e->concat_total = udh[i + 1];
+            e->concat_seq = udh[i + 2];
+        } else if (iei == PDU_IEI_CONCAT16 && iel == 4) {
+            e->concat_ref = GSM_U16((GSM_U16(udh[i]) << 8) | udh[i + 1]);
+            e->concat_total = udh[i + 2];
+            e->concat_seq = udh[i + 3];
+        }
+    }
+    if (e->concat_seq == 0 || e->concat_seq > e->concat_total) {
+        e->concat_ref = 0;                      /* Invalid values, handle as single message */
+        e->concat_total = 0;
+        e->concat_seq = 0;
+    }
+}
+
+/**
+ * \brief           Encode SMS-SUBMIT PDU to output stream
+ * \param[in]       num: Destination phone number
+ * \param[in]       data: UTF-8 text for \ref GSM_SMS_DCS_GSM7 and \ref GSM_SMS_DCS_UCS2 or binary data
+ * \param[in]       len: Length of data in units of bytes
+ * \param[in]       dcs: Data coding scheme
+ * \param[in]       udh: User data header information elements, without header length byte
+ * \param[in]       udh_len: Length of user data header information elements
+ * \param[in]       o: Output stream
+ * \return          PDU length in units of bytes or `0` on failure
+ */
+static size_t
+pdu_encode(const char* num, const void* data, size_t len, gsm_sms_dcs_t dcs,
+            const uint8_t* udh, size_t udh_len, pdu_out_t* o) {
+    pdu_out_t cnt = {0};
+    size_t units, udl, udh_octets;
+    uint8_t fill = 0;
+
+    udh_octets = udh_len > 0 ? (udh_len + 1) : 0;
+
+    /* Count user data first, its length is sent before data */
+    switch (dcs) {
+        case GSM_SMS_DCS_GSM7:
+            if (!gsm7_write(data, len, &cnt, &units)) {
+                return 0;
+            }
+            fill = GSM_U8((7 - (udh_octets * 8) % 7) % 7);
+            udl = (udh_octets * 8 + fill) / 7 + units;
+            if (udl > GSM_SMS_PDU_GSM7_MAX_LEN) {
+                return 0;
+            }
+            break;
+        case GSM_SMS_DCS_UCS2:
+            if (!ucs2_write(data, len, &cnt)) {
+                return 0;
+            }
+            udl = udh_octets + cnt.len;
+            break;
+        case GSM_SMS_DCS_8BIT:
+            udl = udh_octets + len;
+            break;
+        default:
+            return 0;
+    }
+    if (dcs != GSM_SMS_DCS_GSM7 && udl > GSM_SMS_PDU_UD_MAX_LEN) {
+        return 0;
+    }
+
+    out_octet(o, 0x00);                         /* Use service center stored on SIM card */
+    out_octet(o, GSM_U8(PDU_FO_MTI_SUBMIT | (udh_octets > 0 ? PDU_FO_UDHI : 0)));
+    out_octet(o, 0x00);                         /* Message reference is set by device */
+    if (!addr_write(num, o)) {
+        return 0;
+    }
+    out_octet(o, 0x00);                         /* Protocol identifier */
+    out_octet(o, GSM_U8(dcs));
+    out_octet(o, GSM_U8(udl));
+    if (udh_octets > 0) {
+        out_octet(o, GSM_U8(udh_len));
+        for (size_t i = 0; i < udh_len; ++i) {
+            out_octet(o, udh[i]);
+        }
+    }
+    switch (dcs) {
+        case GSM_SMS_DCS_GSM7:
+            o->acc = 0;
+            o->bits = fill;                     /* Align septets after user data header */
+            gsm7_write(data, len, o, &units);
+            out_septet_flush(o);
+            break;
+        case GSM_SMS_DCS_UCS2:
+            ucs2_write(data, len, o);
+            break;
+        default:
+            for (size_t i = 0; i < len; ++i) {
+                out_octet(o, ((const uint8_t *)data)[i]);
+            }
+            break;
+    }
+    return o->len;
+}
+
+/**
+ * \brief           Encode SMS-SUBMIT PDU
+ *
+ * Length of TPDU, used with `AT+CMGS` command, is returned length minus `1`,
+ * as service center address is always empty
+ *
+ * \param[in]       num: Destination phone number, optionally starting with `+` for international format
+ * \param[in]       data: UTF-8 text for \ref GSM_SMS_DCS_GSM7 and \ref GSM_SMS_DCS_UCS2 or binary data for \ref GSM_SMS_DCS_8BIT
+ * \param[in]       len: Length of data in units of bytes
+ * \param[in]       dcs: Data coding scheme
+ * \param[in]       udh: User data header information elements, without header length byte. Set to `NULL` when not used
+ * \param[in]       udh_len: Length of user data header information elements. Set to `0` when not used
+ * \param[out]      pdu: Output memory for PDU. Set to `NULL` to only calculate PDU length
+ * \param[in]       pdu_size: Size of output memory in units of bytes
+ * \return          PDU length in units of bytes, or `0` if data do not fit single message,
+ *                  cannot be encoded or output memory is too small
+ */
+size_t
+gsm_sms_pdu_encode(const char* num, const void* data, size_t len, gsm_sms_dcs_t dcs,
+                    const uint8_t* udh, size_t udh_len, uint8_t* pdu, size_t pdu_size) {
+    pdu_out_t o = {0};
+    size_t res;
+
+    if (num == NULL || (data == NULL && len > 0) || (udh == NULL && udh_len > 0)) {
+        return 0;
+    }
+    o.buff = pdu;
+    o.size = pdu_size;
+    res = pdu_encode(num, data, len, dcs, udh, udh_len, &o);
+    if (pdu != NULL && res > pdu_size) {
+        return 0;
+    }
+    return res;
+}
+
+/**
+ * \brief           Encode SMS-SUBMIT PDU and pass every byte to output function
+ * \note            Input parameters must be verified with \ref gsm_sms_pdu_encode first
+ * \param[in]       num: Destination phone number
+ * \param[in]       data: UTF-8 text or binary data
+ * \param[in]       len: Length of data in units of bytes
+ * \param[in]       dcs: Data coding scheme
+ * \param[in]       udh: User data header information elements, without header length byte
+ * \param[in]       udh_len: Length of user data header information elements
+ * \param[in]       out_fn: Output function called for every PDU byte
+ * \return          PDU length in units of bytes or `0` on failure
+ */
+size_t
+gsmi_sms_pdu_send(const char* num, const void* data, size_t len, gsm_sms_dcs_t dcs,
+                    const uint8_t* udh, size_t udh_len, void (*out_fn)(uint8_t octet)) {
+    pdu_out_t o = {0};
+
+    o.fn = out_fn;
+    return pdu_encode(num, data, len, dcs, udh, udh_len, &o);
+}
+
+/**
+ * \brief           Decode SMS-DELIVER or SMS-SUBMIT PDU to SMS entry
+ *
+ * Function sets phone number, date and time (SMS-DELIVER only), data coding scheme, data
+ * and concatenation information from user data header.
+ * Memory, position and status are not part of PDU and are not modified
+ *
+ * \param[in]       pdu: PDU data, including service center address
+ * \param[in]       len: Length of PDU in units of bytes
+ * \param[out]      entry: SMS entry to fill
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_sms_pdu_decode(const uint8_t* pdu, size_t len, gsm_sms_entry_t* entry) {
+    const uint8_t* ud;
+    size_t i, n, udl, ud_len, udh_octets = 0, skip;
+    uint8_t fo, toa, vpf;
+
+    GSM_ASSERT("pdu != NULL", pdu != NULL);
+    GSM_ASSERT("entry != NULL", entry != NULL);
+
+#define PDU_CHECK_LEN(n)    if ((i + (n)) > len) { return gsmERR; }
+    i = 0;
+    PDU_CHECK_LEN(1);
+    i += 1 + pdu[0];                            /* Skip service center address */
+    PDU_CHECK_LEN(1);
+    fo = pdu[i++];
+    if ((fo & 0x03) == PDU_FO_MTI_SUBMIT) {
+        PDU_CHECK_LEN(1);
+        ++i;                                    /* Skip message reference */
+    } else if ((fo & 0x03) != PDU_FO_MTI_DELIVER) {
+        return gsmERR;
+    }
+
+    /* Originating or destination address */
+    PDU_CHECK_LEN(2);
+    n = pdu[i];
+    toa = pdu[i + 1];
+    i += 2;
+    PDU_CHECK_LEN((n + 1) / 2);
+    addr_read(&pdu[i], n, toa, entry->number, sizeof(entry->number));
+    i += (n + 1) / 2;
+
+    PDU_CHECK_LEN(2);
+    ++i;                                        /* Skip protocol identifier */
+    entry->dcs = dcs_read(pdu[i++]);
+    if ((fo & 0x03) == PDU_FO_MTI_DELIVER) {
+        PDU_CHECK_LEN(7);
+        scts_read(&pdu[i], &entry->datetime);
+        i += 7;
+    } else {
+        vpf = GSM_U8((fo >> 3) & 0x03);         /* Validity period format */
+        i += vpf == 0x02 ? 1 : (vpf != 0x00 ? 7 : 0);
+    }
+    PDU_CHECK_LEN(1);
+    udl = pdu[i++];
+    ud = &pdu[i];
+    ud_len = len - i;
+#undef PDU_CHECK_LEN
+
+    entry->concat_ref = 0;
+    entry->concat_total = 0;
+    entry->concat_seq = 0;
+    if (fo & PDU_FO_UDHI) {
+        if (ud_len == 0 || (udh_octets = GSM_SZ(ud[0]) + 1) > ud_len) {
+            return gsmERR;
+        }
+        udh_read(&ud[1], udh_octets - 1, entry);
+    }
+    if (entry->dcs == GSM_SMS_DCS_GSM7) {
+        skip = (udh_octets * 8 + 6) / 7;        /* Septets used by user data header and fill bits */
+        if (udl < skip || (udl * 7 + 7) / 8 > ud_len) {
+            return gsmERR;
+        }
+        entry->length = gsm_sms_pdu_gsm7_decode(&ud[udh_octets], ud_len - udh_octets,
+            udl - skip, GSM_U8(skip * 7 - udh_octets * 8), entry->data, sizeof(entry->data));
+    } else {
+        if (udl < udh_octets || udl > ud_len) {
+            return gsmERR;
+        }
+        n = udl - udh_octets;
+        if (entry->dcs == GSM_SMS_DCS_UCS2) {
+            entry->length = gsm_sms_pdu_ucs2_decode(&ud[udh_octets], n, entry->data, sizeof(entry->data));
+        } else {
+            entry->length = GSM_MIN(n, sizeof(entry->data) - 1);
+            GSM_MEMCPY(entry->data, &ud[udh_octets], entry->length);
+            entry->data[entry->length] = 0;
+        }
+    }
+    return gsmOK;
+}
+
+/**
+ * \brief           Build concatenation user data header for message part
+ * \param[out]      udh: Output memory for information element,
+ *                      at least \ref GSM_SMS_PDU_CONCAT_UDH_MAX_LEN bytes long
+ * \param[in]       ref: Reference number, same for all parts of message
+ * \param[in]       total: Number of parts of message
+ * \param[in]       seq: Part sequence number, starting with `1`
+ * \param[in]       ref16: Set to `1` to use 16-bit reference number or `0` for 8-bit
+ * \return          Length of user data header, to be used with \ref gsm_sms_pdu_encode
+ */
+size_t
+gsm_sms_pdu_concat_udh(uint8_t* udh, uint16_t ref, uint8_t total, uint8_t seq, uint8_t ref16) {
+    size_t i = 0;
+
+    if (ref16) {
+        udh[i++] = PDU_IEI_CONCAT16;
+        udh[i++] = 4;
+        udh[i++] = GSM_U8(ref >> 8);
+    } else {
+        udh[i++] = PDU_IEI_CONCAT8;
+        udh[i++] = 3;
+    }
+    udh[i++] = GSM_U8(ref);
+    udh[i++] = total;
+    udh[i++] = seq;
+    return i;
+}
+
+/**
+ * \brief           Get length of data that fits single message
+ *
+ * GSM escape sequences and UCS2 surrogate pairs are never split between messages
+ *
+ * \param[in]       data: UTF-8 text for \ref GSM_SMS_DCS_GSM7 and \ref GSM_SMS_DCS_UCS2 or binary data
+ * \param[in]       len: Length of data in units of bytes
+ * \param[in]       dcs: Data coding scheme
+ * \param[in]       udh_len: Length of user data header information elements, sent with message
+ * \return          Number of data bytes from beginning of data that fit single message,
+ *                  or `0` if first character cannot be encoded
+ */
+size_t
+gsm_sms_pdu_get_part_len(const void* data, size_t len, gsm_sms_dcs_t dcs, size_t udh_len) {
+    const char* text = data;
+    size_t udh_octets, cap, used = 0, n, rem = len, res = 0;
+    uint32_t cp;
+    uint8_t s;
+
+    udh_octets = udh_len > 0 ? (udh_len + 1) : 0;
+    if (data == NULL || udh_octets >= GSM_SMS_PDU_UD_MAX_LEN) {
+        return 0;
+    }
+    if (dcs == GSM_SMS_DCS_8BIT) {
+        return GSM_MIN(len, GSM_SMS_PDU_UD_MAX_LEN - udh_octets);
+    } else if (dcs == GSM_SMS_DCS_GSM7) {
+        cap = GSM_SMS_PDU_GSM7_MAX_LEN - (udh_octets * 8 + 6) / 7;
+    } else {
+        cap = (GSM_SMS_PDU_UD_MAX_LEN - udh_octets) & ~GSM_SZ(0x01);    /* Keep whole UCS2 characters */
+    }
+    while (rem > 0 && text_next_cp(&text, &rem, &cp)) {
+        if (dcs == GSM_SMS_DCS_GSM7) {
+            if ((s = gsm7_lookup(cp)) == GSM7_NONE) {
+                break;
+            }
+            n = (s & GSM7_EXT) ? 2 : 1;
+        } else {
+            n = cp >= 0x10000 ? 4 : 2;
+        }
+        if ((used + n) > cap) {
+            break;
+        }
+        used += n;
+        res = len - rem;
+    }
+    return res;
+}
+
+/**
+ * \brief           Get number of messages needed to send data
+ * \param[in]       data: UTF-8 text for \ref GSM_SMS_DCS_GSM7 and \ref GSM_SMS_DCS_UCS2 or binary data
+ * \param[in]       len: Length of data in units of bytes
+ * \param[in]       dcs: Data coding scheme
+ * \param[in]       udh_len: Length of concatenation user data header, used when data do not fit single message
+ * \return          Number of messages, `1` if data fit single message without user data header,
+ *                  or `0` if data cannot be encoded
+ */
+size_t
+gsm_sms_pdu_get_parts(const void* data, size_t len, gsm_sms_dcs_t dcs, size_t udh_len) {
+    size_t parts = 0, n;
+
+    if (len == 0) {
+        return 0;
+    } else if (gsm_sms_pdu_get_part_len(data, len, dcs, 0) == len) {
+        return 1;
+    }
+    while (len > 0) {
+        if ((n = gsm_sms_pdu_get_part_len(data, len, dcs, udh_len)) == 0) {
+            return 0;
+        }
+        data = (const uint8_t *)data + n;
+        len -= n;
+        ++parts;
+    }
+    return parts;
+}
+
+#endif /* (GSM_CFG_SMS && GSM_CFG_SMS_PDU) || __DOXYGEN__ */
@@ -40,6 +40,184 @@
 #include "gsm/gsm_mem.h"
 #include "system/gsm_sys.h"
 
+#if GSM_CFG_BATCH
+
+static gsm_msg_t* batch_active;
+
+/**
+ * \brief           Get next step of active batch
+ *
+ * When all steps are executed, batch message is finished
+ *
+ * \return          Next message to execute or `NULL` if there is no active batch
+ */
+static gsm_msg_t*
+prv_batch_next_step(void) {
+    gsm_msg_t* msg = NULL;
+
+    if (batch_active != NULL) {
+        if ((msg = batch_active->msg.batch.first) != NULL) {
+            batch_active->msg.batch.first = msg->batch_next;
+            msg->batch_next = NULL;
+        } else {
+            gsm_core_lock();
+            gsmi_msg_complete(batch_active);    /* Single completion for entire batch */
+            gsm_core_unlock();
+            batch_active = NULL;
+        }
+    }
+    return msg;
+}
+
+#endif /* GSM_CFG_BATCH */
+
+#if GSM_CFG_PRODUCER_PRIORITY
+
+static gsm_msg_t* prio_first[GSM_MSG_PRIO_END];
+static gsm_msg_t* prio_last[GSM_MSG_PRIO_END];
+static uint8_t prio_skip[GSM_MSG_PRIO_END];
+static size_t prio_cnt;
+
+/**
+ * \brief           Get connection message belongs to
+ * \param[in]       msg: Message to check
+ * \return          Connection handle or `NULL` if message is not connection specific
+ */
+static gsm_conn_t*
+prv_msg_get_conn(gsm_msg_t* msg) {
+#if GSM_CFG_CONN
+    if (msg->cmd_def == GSM_CMD_CIPSEND) {
+        return msg->msg.conn_send.conn;
+    } else if (msg->cmd_def == GSM_CMD_CIPCLOSE) {
+        return msg->msg.conn_close.conn;
+    }
+#endif /* GSM_CFG_CONN */
+    GSM_UNUSED(msg);
+    return NULL;
+}
+
+/**
+ * \brief           Get priority class of message
+ * \param[in]       msg: Message to check
+ * \return          Member of \ref gsm_msg_prio_t enumeration
+ */
+static gsm_msg_prio_t
+prv_msg_get_prio(gsm_msg_t* msg) {
+    gsm_conn_t* conn;
+
+    /* Keep order of commands for the same connection */
+    if ((conn = prv_msg_get_conn(msg)) != NULL) {
+        for (size_t i = 0; i < GSM_MSG_PRIO_END; ++i) {
+            for (gsm_msg_t* m = prio_first[i]; m != NULL; m = m->next) {
+                if (prv_msg_get_conn(m) == conn) {
+                    return (gsm_msg_prio_t)i;
+                }
+            }
+        }
+    }
+
+    switch (msg->cmd_def) {
+        case GSM_CMD_RESET:
+        case GSM_CMD_ATH:
+        case GSM_CMD_CSQ_GET:
+        case GSM_CMD_CIPCLOSE:
+            return GSM_MSG_PRIO_CONTROL;
+        case GSM_CMD_COPS_GET_OPT:
+        case GSM_CMD_CMGL:
+        case GSM_CMD_SMS_SEND_BATCH:
+        case GSM_CMD_SMS_DRAIN:
+        case GSM_CMD_CPBR:
+        case GSM_CMD_CPBF:
+        case GSM_CMD_PB_CACHE_LOAD:
+            return GSM_MSG_PRIO_BULK;
+#if GSM_CFG_CONN
+        case GSM_CMD_CIPSEND:
+            return msg->msg.conn_send.btw >= GSM_CFG_PRODUCER_PRIORITY_BULK_SEND_LEN ? GSM_MSG_PRIO_BULK : GSM_MSG_PRIO_INTERACTIVE;
+#endif /* GSM_CFG_CONN */
+        default:
+            return GSM_MSG_PRIO_INTERACTIVE;
+    }
+}
+
+/**
+ * \brief           Add message to the end of its priority list
+ * \param[in]       msg: Message to add
+ */
+static void
+prv_prio_put(gsm_msg_t* msg) {
+    gsm_msg_prio_t p = prv_msg_get_prio(msg);
+
+    msg->next = NULL;
+    if (prio_last[p] != NULL) {
+        prio_last[p]->next = msg;
+    } else {
+        prio_first[p] = msg;
+    }
+    prio_last[p] = msg;
+    ++prio_cnt;
+}
+
+/**
+ * \brief           Get next message to execute
+ *
+ * Highest non-empty class is served first,
+ * unless lower class was overtaken too many times
+ *
+ * \param[in]       e: GSM global structure
+ * \return          Message to execute
+ */
+static gsm_msg_t*
+prv_prio_get(gsm_t* e) {
+    gsm_msg_t* msg;
+    size_t p;
+
+    /* Wait for first message when nothing is waiting */
+    if (prio_cnt == 0) {
+        uint32_t time;
+        do {
+            time = gsm_sys_mbox_get(&e->mbox_producer, (void **)&msg, 0);
+        } while (time == GSM_SYS_TIMEOUT || msg == NULL);
+        prv_prio_put(msg);
+    }
+
+    /* Sort all messages currently in queue, keep total number limited to queue size */
+    while (prio_cnt < GSM_CFG_THREAD_PRODUCER_MBOX_SIZE
+            && gsm_sys_mbox_getnow(&e->mbox_producer, (void **)&msg)) {
+        if (msg != NULL) {
+            prv_prio_put(msg);
+        }
+    }
+
+    /* Find starving class first, then highest non-empty class */
+    for (p = GSM_MSG_PRIO_END - 1; p > 0; --p) {
+        if (prio_first[p] != NULL && prio_skip[p] >= GSM_CFG_PRODUCER_PRIORITY_STARVE_LIMIT) {
+            break;
+        }
+    }
+    if (p == 0) {
+        for (; prio_first[p] == NULL; ++p) {}
+    }
+
+    msg = prio_first[p];
+    prio_first[p] = msg->next;
+    if (prio_first[p] == NULL) {
+        prio_last[p] = NULL;
+    }
+    msg->next = NULL;
+    --prio_cnt;
+
+    /* Lower classes were overtaken */
+    prio_skip[p] = 0;
+    for (size_t i = p + 1; i < GSM_MSG_PRIO_END; ++i) {
+        if (prio_first[i] != NULL) {
+            ++prio_skip[i];
+        }
+    }
+    return msg;
+}
+
+#endif /* GSM_CFG_PRODUCER_PRIORITY */
+
 /**
  * \brief           User thread to process input packets from API functions
  * \param[in]       arg: User argument. Semaphore to release when thread starts
@@ -60,12 +238,29 @@ gsm_thread_produce(void* const arg) {
     gsm_core_lock();
     while (1) {
         gsm_core_unlock();
-        do {
-            time = gsm_sys_mbox_get(&e->mbox_producer, (void **)&msg, 0);   /* Get message from queue */
-        } while (time == GSM_SYS_TIMEOUT || msg == NULL);
+        msg = NULL;
+#if GSM_CFG_BATCH
+        msg = prv_batch_next_step();            /* Steps of active batch have precedence */
+#endif /* GSM_CFG_BATCH */
+        if (msg == NULL) {
+#if GSM_CFG_PRODUCER_PRIORITY
+            msg = prv_prio_get(e);              /* Get next message by priority */
+#else /* GSM_CFG_PRODUCER_PRIORITY */
+            do {
+                time = gsm_sys_mbox_get(&e->mbox_producer, (void **)&msg, 0);   /* Get message from queue */
+            } while (time == GSM_SYS_TIMEOUT || msg == NULL);
+#endif /* !GSM_CFG_PRODUCER_PRIORITY */
+        }
         GSM_THREAD_PRODUCER_HOOK();             /* Execute producer thread hook */
         gsm_core_lock();
 
+#if GSM_CFG_BATCH
+        if (msg->cmd_def == GSM_CMD_BATCH) {    /* Execute steps in next iterations */
+            batch_active = msg;
+            continue;
+        }
+#endif /* GSM_CFG_BATCH */
+
         res = gsmOK;                            /* Start with OK */
         e->msg = msg;                           /* Set message handle */
 
@@ -91,6 +286,8 @@ gsm_thread_produce(void* const arg) {
          * Usually it should be function to transmit data to AT port
          */
         if (res == gsmOK && msg->fn != NULL) {  /* Check for callback processing function */
+            uint32_t block_time = msg->block_time;  /* Message may be released by processing thread during wait */
+
             /*
              * Obtain semaphore
              * This code should not block at any point.
@@ -104,7 +301,7 @@ gsm_thread_produce(void* const arg) {
             time = ~GSM_SYS_TIMEOUT;            /* Reset time */
             if (res == gsmOK) {                 /* We have valid data and data were sent */
                 gsm_core_unlock();
-                time = gsm_sys_sem_wait(&e->sem_sync, msg->block_time); /* Second call; Wait for synchronization semaphore from processing thread or timeout */
+                time = gsm_sys_sem_wait(&e->sem_sync, block_time);  /* Second call; Wait for synchronization semaphore from processing thread or timeout */
                 gsm_core_lock();
                 if (time == GSM_SYS_TIMEOUT) {  /* Sync timeout occurred? */
                     res = gsmTIMEOUT;           /* Timeout on command */
@@ -145,29 +342,20 @@ gsm_thread_produce(void* const arg) {
                 res = gsmERR;                   /* Simply set error message */
             }
         }
-        if (res != gsmOK) {
-            /* Process global callbacks */
-            gsmi_process_events_for_timeout_or_error(msg, res);
-
-            msg->res = res;                     /* Save response */
-        }
-
-#if GSM_CFG_USE_API_FUNC_EVT
-        /* Send event function to user */
-        if (msg->evt_fn != NULL) {
-            msg->evt_fn(msg->res, msg->evt_arg);/* Send event with user argument */
-        }
-#endif /* GSM_CFG_USE_API_FUNC_EVT */
 
         /*
-         * In case message is blocking,
-         * release semaphore and notify finished with processing
-         * otherwise directly free memory of message structure
+         * Finished commands are released by processing thread,
+         * which already notified the caller and cleared active message.
+         * Finish message here only if it did not start or timeout occurred
          */
-        if (msg->is_blocking) {
-            gsm_sys_sem_release(&msg->sem);
-        } else {
-            GSM_MSG_VAR_FREE(msg);
+        if (e->msg == msg) {
+            if (res != gsmOK) {
+                /* Process global callbacks */
+                gsmi_process_events_for_timeout_or_error(msg, res);
+
+                msg->res = res;                 /* Save response */
+            }
+            gsmi_msg_complete(msg);
         }
         e->msg = NULL;
     }
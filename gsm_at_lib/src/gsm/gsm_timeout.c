@@ -188,18 +188,20 @@ gsm_timeout_add(uint32_t time, gsm_timeout_fn fn, void* arg) {
 }
 
 /**
- * \brief           Remove callback from timeout list
+ * \brief           Remove first timeout with matching callback and optionally argument
  * \param[in]       fn: Callback function to identify timeout to remove
+ * \param[in]       arg: Callback argument to identify timeout to remove
+ * \param[in]       match_arg: Set to `1` to compare argument too
  * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
  */
-gsmr_t
-gsm_timeout_remove(gsm_timeout_fn fn) {
+static gsmr_t
+prv_timeout_remove(gsm_timeout_fn fn, void* arg, uint8_t match_arg) {
     uint8_t success = 0;
 
     gsm_core_lock();
     for (gsm_timeout_t* t = first_timeout, *t_prev = NULL; t != NULL;
             t_prev = t, t = t->next) {          /* Check all entries */
-        if (t->fn == fn) {                      /* Do we have a match from callback point of view? */
+        if (t->fn == fn && (!match_arg || t->arg == arg)) { /* Do we have a match from callback point of view? */
 
             /*
              * We have to first increase
@@ -229,3 +231,27 @@ gsm_timeout_remove(gsm_timeout_fn fn) {
     gsm_core_unlock();
     return success ? gsmOK : gsmERR;
 }
+
+/**
+ * \brief           Remove callback from timeout list
+ * \param[in]       fn: Callback function to identify timeout to remove
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_timeout_remove(gsm_timeout_fn fn) {
+    return prv_timeout_remove(fn, NULL, 0);
+}
+
+/**
+ * \brief           Remove callback with specific argument from timeout list
+ *
+ * Use it when the same callback is used for multiple objects
+ *
+ * \param[in]       fn: Callback function to identify timeout to remove
+ * \param[in]       arg: Callback argument used when timeout was added
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_timeout_remove_with_arg(gsm_timeout_fn fn, void* arg) {
+    return prv_timeout_remove(fn, arg, 1);
+}
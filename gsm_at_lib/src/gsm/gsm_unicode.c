@@ -73,3 +73,60 @@ gsmi_unicode_decode(gsm_unicode_t* s, uint8_t c) {
     }
     return gsmERR;                              /* An error, unknown UTF-8 character entered */
 }
+
+/**
+ * \brief           Get code point of successfully decoded UTF-8 sequence
+ * \param[in]       s: Pointer to unicode decode control structure after \ref gsmi_unicode_decode returned \ref gsmOK
+ * \return          Unicode code point
+ */
+uint32_t
+gsmi_unicode_get_code_point(const gsm_unicode_t* s) {
+    uint32_t cp;
+
+    switch (s->t) {
+        case 1: return s->ch[0];
+        case 2: cp = s->ch[0] & 0x1F; break;
+        case 3: cp = s->ch[0] & 0x0F; break;
+        default: cp = s->ch[0] & 0x07; break;
+    }
+    for (size_t i = 1; i < s->t; ++i) {
+        cp = (cp << 6) | (s->ch[i] & 0x3F);
+    }
+    return cp;
+}
+
+/**
+ * \brief           Encode unicode code point to UTF-8 sequence
+ * \param[in]       cp: Unicode code point
+ * \param[out]      out: Output memory with at least `4` bytes, or `NULL` to only get sequence length
+ * \return          Number of bytes in UTF-8 sequence, between `1` and `4`
+ */
+size_t
+gsmi_unicode_encode(uint32_t cp, char* out) {
+    uint8_t b[4];
+    size_t len;
+
+    if (cp < 0x80) {
+        b[0] = GSM_U8(cp);
+        len = 1;
+    } else if (cp < 0x800) {
+        b[0] = GSM_U8(0xC0 | (cp >> 6));
+        b[1] = GSM_U8(0x80 | (cp & 0x3F));
+        len = 2;
+    } else if (cp < 0x10000) {
+        b[0] = GSM_U8(0xE0 | (cp >> 12));
+        b[1] = GSM_U8(0x80 | ((cp >> 6) & 0x3F));
+        b[2] = GSM_U8(0x80 | (cp & 0x3F));
+        len = 3;
+    } else {
+        b[0] = GSM_U8(0xF0 | ((cp >> 18) & 0x07));
+        b[1] = GSM_U8(0x80 | ((cp >> 12) & 0x3F));
+        b[2] = GSM_U8(0x80 | ((cp >> 6) & 0x3F));
+        b[3] = GSM_U8(0x80 | (cp & 0x3F));
+        len = 4;
+    }
+    if (out != NULL) {
+        GSM_MEMCPY(out, b, len);
+    }
+    return len;
+}
@@ -36,6 +36,7 @@
 
 #include "gsm/gsm.h"
 #include "gsm/apps/gsm_mqtt_client_evt.h"
+#include "gsm/apps/gsm_mqtt_client_queue.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -57,6 +58,37 @@ typedef enum {
     GSM_MQTT_QOS_EXACTLY_ONCE = 0x02,           /*!< Delivery is quaranteed `exactly once` = very critical packets such as billing informations or similar */
 } gsm_mqtt_qos_t;
 
+/**
+ * \brief           MQTT protocol version
+ */
+typedef enum {
+    GSM_MQTT_PROTOCOL_VERSION_3_1_1 = 0x04,     /*!< MQTT v3.1.1, used also when version is set to `0` */
+    GSM_MQTT_PROTOCOL_VERSION_5_0 = 0x05,       /*!< MQTT v5.0. Requires \ref GSM_CFG_MQTT_V5 enabled */
+} gsm_mqtt_protocol_version_t;
+
+/**
+ * \brief           MQTT v5.0 property identifiers
+ */
+typedef enum {
+    GSM_MQTT_PROP_PAYLOAD_FORMAT = 0x01,        /*!< Payload format indicator, byte */
+    GSM_MQTT_PROP_MESSAGE_EXPIRY = 0x02,        /*!< Message expiry interval, 4-byte integer */
+    GSM_MQTT_PROP_CONTENT_TYPE = 0x03,          /*!< Content type, string */
+    GSM_MQTT_PROP_RESPONSE_TOPIC = 0x08,        /*!< Response topic, string */
+    GSM_MQTT_PROP_CORRELATION_DATA = 0x09,      /*!< Correlation data, binary */
+    GSM_MQTT_PROP_SUBSCRIPTION_ID = 0x0B,       /*!< Subscription identifier, variable byte integer */
+    GSM_MQTT_PROP_SESSION_EXPIRY = 0x11,        /*!< Session expiry interval, 4-byte integer */
+    GSM_MQTT_PROP_ASSIGNED_CLIENT_ID = 0x12,    /*!< Assigned client identifier, string */
+    GSM_MQTT_PROP_SERVER_KEEP_ALIVE = 0x13,     /*!< Server keep alive, 2-byte integer */
+    GSM_MQTT_PROP_REASON_STRING = 0x1F,         /*!< Reason string, string */
+    GSM_MQTT_PROP_RECEIVE_MAXIMUM = 0x21,       /*!< Receive maximum, 2-byte integer */
+    GSM_MQTT_PROP_TOPIC_ALIAS_MAXIMUM = 0x22,   /*!< Topic alias maximum, 2-byte integer */
+    GSM_MQTT_PROP_TOPIC_ALIAS = 0x23,           /*!< Topic alias, 2-byte integer */
+    GSM_MQTT_PROP_MAXIMUM_QOS = 0x24,           /*!< Maximum QoS, byte */
+    GSM_MQTT_PROP_RETAIN_AVAILABLE = 0x25,      /*!< Retain available, byte */
+    GSM_MQTT_PROP_USER_PROPERTY = 0x26,         /*!< User property, string pair */
+    GSM_MQTT_PROP_MAXIMUM_PACKET_SIZE = 0x27,   /*!< Maximum packet size, 4-byte integer */
+} gsm_mqtt_prop_t;
+
 struct gsm_mqtt_client;
 
 /**
@@ -90,6 +122,11 @@ typedef struct {
     const char* will_topic;                     /*!< Will topic */
     const char* will_message;                   /*!< Will message */
     gsm_mqtt_qos_t will_qos;                    /*!< Will topic quality of service */
+
+    uint8_t keep_session;                       /*!< Set to `1` to connect with clean session flag cleared.
+                                                    Server keeps subscriptions and unacknowledged messages between connections */
+
+    gsm_mqtt_protocol_version_t protocol_version;   /*!< Protocol version. Set to `0` for default MQTT v3.1.1 */
 } gsm_mqtt_client_info_t;
 
 /**
@@ -143,17 +180,24 @@ typedef struct {
     union {
         struct {
             gsm_mqtt_conn_status_t status;      /*!< Connection status with MQTT */
+            uint8_t session_present;            /*!< Set to `1` when server resumed previous session */
+            uint8_t reason_code;                /*!< Reason code received from server */
+            const uint8_t* props;               /*!< MQTT v5.0 properties of CONNACK packet */
+            size_t props_len;                   /*!< Length of properties in units of bytes */
         } connect;                              /*!< Event for connecting to server */
         struct {
             uint8_t is_accepted;                /*!< Status if client was accepted to MQTT prior disconnect event */
+            uint8_t reason_code;                /*!< Reason code of DISCONNECT packet sent by MQTT v5.0 server, `0` otherwise */
         } disconnect;                           /*!< Event for disconnecting from server */
         struct {
             void* arg;                          /*!< User argument for callback function */
             gsmr_t res;                         /*!< Rgsmonse status */
+            uint8_t reason_code;                /*!< First failed or first reason code received from server */
         } sub_unsub_scribed;                    /*!< Event for (un)subscribe to/from topics */
         struct {
             void* arg;                          /*!< User argument for callback function */
             gsmr_t res;                         /*!< Rgsmonse status */
+            uint8_t reason_code;                /*!< Reason code received from server */
         } publish;                              /*!< Published event */
         struct {
             const uint8_t* topic;               /*!< Pointer to topic identifier */
@@ -162,6 +206,8 @@ typedef struct {
             size_t payload_len;                 /*!< Length of topic payload */
             uint8_t dup;                        /*!< Duplicate flag if message was sent again */
             gsm_mqtt_qos_t qos;                 /*!< Received packet quality of service */
+            const uint8_t* props;               /*!< MQTT v5.0 properties of PUBLISH packet */
+            size_t props_len;                   /*!< Length of properties in units of bytes */
         } publish_recv;                         /*!< Publish received event */
     } evt;                                      /*!< Event data parameters */
 } gsm_mqtt_evt_t;
@@ -185,6 +231,19 @@ gsmr_t              gsm_mqtt_client_unsubscribe(gsm_mqtt_client_p client, const
 
 gsmr_t              gsm_mqtt_client_publish(gsm_mqtt_client_p client, const char* topic, const void* payload, uint16_t len, gsm_mqtt_qos_t qos, uint8_t retain, void* arg);
 
+#if GSM_CFG_MQTT_V5 || __DOXYGEN__
+uint8_t             gsm_mqtt_client_prop_find(const uint8_t* props, size_t props_len, gsm_mqtt_prop_t id, uint32_t* num, const uint8_t** data, size_t* data_len);
+#endif /* GSM_CFG_MQTT_V5 || __DOXYGEN__ */
+
+#if GSM_CFG_MQTT_RECONNECT || __DOXYGEN__
+gsmr_t              gsm_mqtt_client_set_reconnect(gsm_mqtt_client_p client, uint8_t enable);
+#endif /* GSM_CFG_MQTT_RECONNECT || __DOXYGEN__ */
+
+#if GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__
+gsmr_t              gsm_mqtt_client_queue_set(gsm_mqtt_client_p client, const gsm_mqtt_client_queue_ops_t* ops, void* arg);
+gsmr_t              gsm_mqtt_client_queue_get_stats(gsm_mqtt_client_p client, gsm_mqtt_client_queue_stats_t* stats);
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE || __DOXYGEN__ */
+
 void*               gsm_mqtt_client_get_arg(gsm_mqtt_client_p client);
 void                gsm_mqtt_client_set_arg(gsm_mqtt_client_p client, void* arg);
 
@@ -73,6 +73,46 @@ extern "C" {
  */
 #define gsm_mqtt_client_evt_connect_get_status(client, evt)         ((gsm_mqtt_conn_status_t)(evt)->evt.connect.status)
 
+/**
+ * \brief           Check if server resumed previous session on connect
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          `1` if session is present, `0` otherwise
+ * \hideinitializer
+ */
+#define gsm_mqtt_client_evt_connect_is_session_present(client, evt) (GSM_U8((evt)->evt.connect.session_present))
+
+/**
+ * \brief           Get reason code of connect event
+ *
+ * For MQTT v3.1.1 this is return code of CONNACK packet
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Reason code received from server
+ * \hideinitializer
+ */
+#define gsm_mqtt_client_evt_connect_get_reason_code(client, evt)    (GSM_U8((evt)->evt.connect.reason_code))
+
+/**
+ * \brief           Get MQTT v5.0 properties of CONNACK packet
+ * \note            Use \ref gsm_mqtt_client_prop_find to get value of specific property
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Pointer to properties, valid only during event callback
+ * \hideinitializer
+ */
+#define gsm_mqtt_client_evt_connect_get_props(client, evt)          ((evt)->evt.connect.props)
+
+/**
+ * \brief           Get length of MQTT v5.0 properties of CONNACK packet
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Properties length in units of bytes
+ * \hideinitializer
+ */
+#define gsm_mqtt_client_evt_connect_get_props_len(client, evt)      (GSM_SZ((evt)->evt.connect.props_len))
+
 /**
  * \}
  */
@@ -94,6 +134,15 @@ extern "C" {
  */
 #define gsm_mqtt_client_evt_disconnect_is_accepted(client, evt)     ((gsm_mqtt_conn_status_t)(evt)->evt.disconnect.is_accepted)
 
+/**
+ * \brief           Get reason code of DISCONNECT packet sent by MQTT v5.0 server
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Reason code or `0` if server closed connection without DISCONNECT packet
+ * \hideinitializer
+ */
+#define gsm_mqtt_client_evt_disconnect_get_reason_code(client, evt) (GSM_U8((evt)->evt.disconnect.reason_code))
+
 /**
  * \}
  */
@@ -142,6 +191,18 @@ extern "C" {
  */
 #define gsm_mqtt_client_evt_unsubscribe_get_result(client, evt)     ((gsmr_t)(evt)->evt.sub_unsub_scribed.res)
 
+/**
+ * \brief           Get reason code of subscribe or unsubscribe event
+ *
+ * For MQTT v3.1.1 subscribe this is return code of SUBACK packet
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          First failed reason code or first reason code on success
+ * \hideinitializer
+ */
+#define gsm_mqtt_client_evt_sub_unsub_get_reason_code(client, evt)  (GSM_U8((evt)->evt.sub_unsub_scribed.reason_code))
+
 /**
  * \}
  */
@@ -208,6 +269,25 @@ extern "C" {
  */
 #define gsm_mqtt_client_evt_publish_recv_get_qos(client, evt)       ((evt)->evt.publish_recv.qos)
 
+/**
+ * \brief           Get MQTT v5.0 properties of received publish packet
+ * \note            Use \ref gsm_mqtt_client_prop_find to get value of specific property
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Pointer to properties, valid only during event callback
+ * \hideinitializer
+ */
+#define gsm_mqtt_client_evt_publish_recv_get_props(client, evt)     ((evt)->evt.publish_recv.props)
+
+/**
+ * \brief           Get length of MQTT v5.0 properties of received publish packet
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Properties length in units of bytes
+ * \hideinitializer
+ */
+#define gsm_mqtt_client_evt_publish_recv_get_props_len(client, evt) (GSM_SZ((evt)->evt.publish_recv.props_len))
+
 /**
  * \}
  */
@@ -238,6 +318,18 @@ extern "C" {
  */
 #define gsm_mqtt_client_evt_publish_get_result(client, evt)     ((gsmr_t)(evt)->evt.publish.res)
 
+/**
+ * \brief           Get reason code of publish event
+ *
+ * Reason code is received in MQTT v5.0 acknowledge packets. It is `0` for MQTT v3.1.1
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Reason code received from server
+ * \hideinitializer
+ */
+#define gsm_mqtt_client_evt_publish_get_reason_code(client, evt) (GSM_U8((evt)->evt.publish.reason_code))
+
 /**
  * \}
  */
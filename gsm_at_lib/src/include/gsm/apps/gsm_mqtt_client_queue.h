@@ -0,0 +1,153 @@
+/**
+ * \file            gsm_mqtt_client_queue.h
+ * \brief           MQTT client offline queue
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef GSM_HDR_APP_MQTT_CLIENT_QUEUE_H
+#define GSM_HDR_APP_MQTT_CLIENT_QUEUE_H
+
+#include "gsm/gsm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         GSM_APP_MQTT_CLIENT
+ * \defgroup        GSM_APP_MQTT_CLIENT_QUEUE Offline queue
+ * \brief           Store-and-forward queue for publish messages
+ * \{
+ *
+ * Queue keeps publish messages with quality of service `1` or `2` until server acknowledges them.
+ * Messages written while client is not connected are kept in storage and replayed
+ * in batches, in the same order, when connection with server is accepted again.
+ *
+ * Storage is opaque to MQTT client and is accessed through \ref gsm_mqtt_client_queue_ops_t.
+ * Library provides RAM ring buffer storage and file storage (\ref GSM_CFG_MQTT_OFFLINE_QUEUE_FILE).
+ *
+ * Each record keeps packet ID assigned when message was written to queue.
+ * Acknowledge is matched to its record by packet ID, as messages with quality of service `1` and `2`
+ * may be acknowledged in different order than sent. Replayed message uses the same packet ID.
+ * Message with quality of service `2`, already received by server, is replayed with release packet only.
+ *
+ * \note            User argument of publish is kept in memory only. Messages restored from
+ *                  persistent storage after restart report `NULL` argument in publish event
+ */
+
+/**
+ * \brief           Single memory chunk of queue record
+ */
+typedef struct {
+    const void* data;                           /*!< Pointer to chunk data */
+    size_t len;                                 /*!< Length of chunk data in units of bytes */
+} gsm_mqtt_client_queue_chunk_t;
+
+/**
+ * \brief           Queue storage operations
+ *
+ * Records are opaque byte arrays, stored in FIFO order.
+ * Record may be removed from any position, records behind it keep their order.
+ * Part of stored record may be overwritten, its length never changes.
+ * All functions are called with core lock acquired.
+ */
+typedef struct {
+    gsmr_t  (*push)(void* arg, const gsm_mqtt_client_queue_chunk_t* chunks, size_t chunks_cnt); /*!< Store new record at the end of queue.
+                                                    Record consists of all chunks, written one after another */
+    size_t  (*read)(void* arg, size_t index, size_t offset, void* data, size_t len);  /*!< Read part of record at `index` position from beginning of queue.
+                                                    Function returns number of bytes copied to `data` */
+    gsmr_t  (*remove)(void* arg, size_t index); /*!< Remove record at `index` position from beginning of queue */
+    gsmr_t  (*update)(void* arg, size_t index, size_t offset, const void* data, size_t len);  /*!< Overwrite part of record at `index` position
+                                                    with `len` bytes of `data`, starting at `offset` inside record */
+    size_t  (*get_count)(void* arg);            /*!< Get number of records in queue */
+} gsm_mqtt_client_queue_ops_t;
+
+/**
+ * \brief           Queue statistics
+ */
+typedef struct {
+    size_t depth;                               /*!< Number of messages currently in queue, including in-flight */
+    size_t in_flight;                           /*!< Number of queued messages sent to server and waiting for acknowledge */
+    uint32_t enqueued;                          /*!< Total number of messages written to queue */
+    uint32_t drained;                           /*!< Total number of messages acknowledged by server and removed from queue */
+    uint32_t dropped;                           /*!< Total number of messages rejected by storage */
+    uint32_t drain_rate;                        /*!< Number of messages drained per second since last successful connect */
+} gsm_mqtt_client_queue_stats_t;
+
+/**
+ * \brief           RAM ring buffer storage
+ */
+typedef struct {
+    gsm_buff_t buff;                            /*!< Ring buffer with length-prefixed records */
+    size_t count;                               /*!< Number of records in buffer */
+} gsm_mqtt_client_queue_ram_t;
+
+extern const gsm_mqtt_client_queue_ops_t gsm_mqtt_client_queue_ram_ops;
+
+uint8_t     gsm_mqtt_client_queue_ram_init(gsm_mqtt_client_queue_ram_t* q, size_t size);
+void        gsm_mqtt_client_queue_ram_free(gsm_mqtt_client_queue_ram_t* q);
+
+#if GSM_CFG_MQTT_OFFLINE_QUEUE_FILE || __DOXYGEN__
+
+/**
+ * \brief           File storage
+ *
+ * File starts with header with read position and number of records,
+ * followed by length-prefixed records. Record removed out of order is only marked in its length prefix.
+ * File is truncated each time queue becomes empty, and partially written records
+ * at the end of file are cut off when file is opened.
+ * Removed records are dropped from file when their size reaches \ref GSM_CFG_MQTT_OFFLINE_QUEUE_FILE_COMPACT
+ * and size of remaining records.
+ */
+typedef struct {
+    void* file;                                 /*!< Opened file handle */
+    const char* path;                           /*!< Path to file */
+    uint32_t read_pos;                          /*!< Position of first record in file */
+    uint32_t write_pos;                         /*!< Position after last complete record in file */
+    uint32_t count;                             /*!< Number of records in file */
+    uint32_t removed_len;                       /*!< Number of bytes used by records removed out of order, after read position */
+} gsm_mqtt_client_queue_file_t;
+
+extern const gsm_mqtt_client_queue_ops_t gsm_mqtt_client_queue_file_ops;
+
+uint8_t     gsm_mqtt_client_queue_file_open(gsm_mqtt_client_queue_file_t* q, const char* path);
+void        gsm_mqtt_client_queue_file_close(gsm_mqtt_client_queue_file_t* q);
+
+#endif /* GSM_CFG_MQTT_OFFLINE_QUEUE_FILE || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* GSM_HDR_APP_MQTT_CLIENT_QUEUE_H */
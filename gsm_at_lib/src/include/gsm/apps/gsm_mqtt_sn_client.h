@@ -0,0 +1,223 @@
+/**
+ * \file            gsm_mqtt_sn_client.h
+ * \brief           MQTT-SN client
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef GSM_HDR_APP_MQTT_SN_CLIENT_H
+#define GSM_HDR_APP_MQTT_SN_CLIENT_H
+
+#include "gsm/gsm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         GSM_APPS
+ * \defgroup        GSM_APP_MQTT_SN_CLIENT MQTT-SN client
+ * \brief           MQTT-SN v1.2 client over UDP connection
+ * \{
+ *
+ * Client talks to MQTT-SN gateway over single UDP connection.
+ * Topics are addressed with 2-byte topic IDs instead of topic names, which are either
+ * registered at runtime, predefined on gateway or short (2 characters) topic names.
+ *
+ * As required by protocol, only one request waiting for gateway reply is allowed at a time.
+ * Requests are sent again after \ref GSM_CFG_MQTT_SN_RETRY_TIMEOUT milliseconds
+ * and gateway is considered lost after \ref GSM_CFG_MQTT_SN_RETRY_COUNT retries.
+ */
+
+/**
+ * \brief           Quality of service enumeration
+ */
+typedef enum {
+    GSM_MQTT_SN_QOS_AT_MOST_ONCE = 0x00,        /*!< Delivery is not guaranteed, client must be connected */
+    GSM_MQTT_SN_QOS_AT_LEAST_ONCE = 0x01,       /*!< Delivery is acknowledged by gateway, client must be connected */
+    GSM_MQTT_SN_QOS_NO_CONNECT = 0x03,          /*!< QoS `-1`. Publish without connection, only with predefined or short topic IDs */
+} gsm_mqtt_sn_qos_t;
+
+/**
+ * \brief           Topic ID type
+ */
+typedef enum {
+    GSM_MQTT_SN_TOPIC_NORMAL = 0x00,            /*!< Topic ID registered with gateway */
+    GSM_MQTT_SN_TOPIC_PREDEFINED = 0x01,        /*!< Topic ID predefined on client and gateway */
+    GSM_MQTT_SN_TOPIC_SHORT = 0x02,             /*!< Short topic name, 2 characters used as topic ID */
+} gsm_mqtt_sn_topic_type_t;
+
+/**
+ * \brief           Create topic ID from short topic name characters
+ * \param[in]       c1: First character of topic name
+ * \param[in]       c2: Second character of topic name
+ */
+#define GSM_MQTT_SN_SHORT_TOPIC_ID(c1, c2)      ((uint16_t)((((uint16_t)(uint8_t)(c1)) << 8) | ((uint16_t)(uint8_t)(c2))))
+
+/**
+ * \brief           Return codes from MQTT-SN gateway
+ */
+typedef enum {
+    GSM_MQTT_SN_RC_ACCEPTED =               0x00,   /*!< Request accepted */
+    GSM_MQTT_SN_RC_REJECTED_CONGESTION =    0x01,   /*!< Rejected, gateway congestion. Try again later */
+    GSM_MQTT_SN_RC_REJECTED_INVALID_TOPIC = 0x02,   /*!< Rejected, invalid topic ID */
+    GSM_MQTT_SN_RC_REJECTED_NOT_SUPPORTED = 0x03,   /*!< Rejected, not supported */
+    GSM_MQTT_SN_RC_TIMEOUT =                0x100,  /*!< Gateway did not reply after all retries */
+    GSM_MQTT_SN_RC_UDP_FAILED =             0x101,  /*!< UDP connection could not be started */
+} gsm_mqtt_sn_rc_t;
+
+struct gsm_mqtt_sn_client;
+
+/**
+ * \brief           Pointer to \ref gsm_mqtt_sn_client_t structure
+ */
+typedef struct gsm_mqtt_sn_client* gsm_mqtt_sn_client_p;
+
+/**
+ * \brief           State of MQTT-SN client
+ */
+typedef enum {
+    GSM_MQTT_SN_STATE_CLOSED = 0x00,            /*!< UDP connection is not active */
+    GSM_MQTT_SN_STATE_OPENING,                  /*!< UDP connection is starting */
+    GSM_MQTT_SN_STATE_OPEN,                     /*!< UDP connection is active, client is not connected to gateway */
+    GSM_MQTT_SN_STATE_CONNECTING,               /*!< CONNECT has been sent to gateway */
+    GSM_MQTT_SN_STATE_CONNECTED,                /*!< Client is active and connected to gateway */
+    GSM_MQTT_SN_STATE_ASLEEP,                   /*!< Client is sleeping, gateway buffers messages for it */
+    GSM_MQTT_SN_STATE_AWAKE,                    /*!< Sleeping client is awake and receives buffered messages */
+    GSM_MQTT_SN_STATE_DISCONNECTING,            /*!< DISCONNECT has been sent to gateway */
+} gsm_mqtt_sn_state_t;
+
+/**
+ * \brief           MQTT-SN client information structure
+ */
+typedef struct {
+    const char* id;                             /*!< Client unique identifier, `1` to `23` characters. It is required and must be set by user */
+    uint16_t keep_alive;                        /*!< Keep-alive parameter in units of seconds.
+                                                    When set to `0`, functionality is disabled */
+    uint8_t keep_session;                       /*!< Set to `1` to connect with clean session flag cleared */
+} gsm_mqtt_sn_client_info_t;
+
+/**
+ * \brief           MQTT-SN event types
+ */
+typedef enum {
+    GSM_MQTT_SN_EVT_OPEN,                       /*!< UDP connection is active. Publish with \ref GSM_MQTT_SN_QOS_NO_CONNECT is possible */
+    GSM_MQTT_SN_EVT_CONNECT,                    /*!< Connect to gateway finished */
+    GSM_MQTT_SN_EVT_REGISTER,                   /*!< Topic name registration finished */
+    GSM_MQTT_SN_EVT_SUBSCRIBE,                  /*!< Subscribe to topic finished */
+    GSM_MQTT_SN_EVT_UNSUBSCRIBE,                /*!< Unsubscribe from topic finished */
+    GSM_MQTT_SN_EVT_PUBLISH,                    /*!< Publish with \ref GSM_MQTT_SN_QOS_AT_LEAST_ONCE finished */
+    GSM_MQTT_SN_EVT_PUBLISH_RECV,               /*!< Publish message received from gateway */
+    GSM_MQTT_SN_EVT_KEEP_ALIVE,                 /*!< Keep-alive sent to gateway and reply received */
+    GSM_MQTT_SN_EVT_SLEEP,                      /*!< Gateway accepted sleep request */
+    GSM_MQTT_SN_EVT_WAKEUP,                     /*!< Awake period finished, all buffered messages received. Client is asleep again */
+    GSM_MQTT_SN_EVT_DISCONNECT,                 /*!< Client disconnected from gateway */
+} gsm_mqtt_sn_evt_type_t;
+
+/**
+ * \brief           MQTT-SN event structure for callback function
+ */
+typedef struct {
+    gsm_mqtt_sn_evt_type_t type;                /*!< Event type */
+    union {
+        struct {
+            gsm_mqtt_sn_rc_t rc;                /*!< Connection status */
+        } connect;                              /*!< Event for connecting to gateway */
+        struct {
+            uint8_t is_accepted;                /*!< Status if client was connected to gateway prior disconnect event */
+        } disconnect;                           /*!< Event for disconnecting from gateway */
+        struct {
+            void* arg;                          /*!< User argument for callback function */
+            gsmr_t res;                         /*!< Response status */
+            gsm_mqtt_sn_rc_t rc;                /*!< Return code from gateway */
+            uint16_t topic_id;                  /*!< Topic ID assigned by gateway */
+        } reg;                                  /*!< Event for registering topic name */
+        struct {
+            void* arg;                          /*!< User argument for callback function */
+            gsmr_t res;                         /*!< Response status */
+            gsm_mqtt_sn_rc_t rc;                /*!< Return code from gateway */
+            uint16_t topic_id;                  /*!< Topic ID assigned by gateway. `0` for wildcard topics */
+            gsm_mqtt_sn_qos_t qos;              /*!< Granted quality of service */
+        } sub_unsub_scribed;                    /*!< Event for (un)subscribe to/from topics */
+        struct {
+            void* arg;                          /*!< User argument for callback function */
+            gsmr_t res;                         /*!< Response status */
+            gsm_mqtt_sn_rc_t rc;                /*!< Return code from gateway */
+        } publish;                              /*!< Published event */
+        struct {
+            gsm_mqtt_sn_topic_type_t topic_type;/*!< Topic ID type */
+            uint16_t topic_id;                  /*!< Topic ID */
+            const char* topic;                  /*!< Registered topic name for topic ID or `NULL` if not known */
+            const void* payload;                /*!< Topic payload */
+            size_t payload_len;                 /*!< Length of topic payload */
+            uint8_t dup;                        /*!< Duplicate flag if message was sent again */
+            gsm_mqtt_sn_qos_t qos;              /*!< Received packet quality of service */
+        } publish_recv;                         /*!< Publish received event */
+    } evt;                                      /*!< Event data parameters */
+} gsm_mqtt_sn_evt_t;
+
+/**
+ * \brief           MQTT-SN event callback function
+ * \param[in]       client: MQTT-SN client
+ * \param[in]       evt: MQTT-SN event with type and related data
+ */
+typedef void        (*gsm_mqtt_sn_evt_fn)(gsm_mqtt_sn_client_p client, gsm_mqtt_sn_evt_t* evt);
+
+gsm_mqtt_sn_client_p    gsm_mqtt_sn_client_new(size_t tx_buff_len, size_t rx_buff_len);
+void                    gsm_mqtt_sn_client_delete(gsm_mqtt_sn_client_p client);
+
+gsmr_t                  gsm_mqtt_sn_client_connect(gsm_mqtt_sn_client_p client, const char* host, gsm_port_t port, gsm_mqtt_sn_evt_fn evt_fn, const gsm_mqtt_sn_client_info_t* info);
+gsmr_t                  gsm_mqtt_sn_client_disconnect(gsm_mqtt_sn_client_p client);
+uint8_t                 gsm_mqtt_sn_client_is_connected(gsm_mqtt_sn_client_p client);
+
+gsmr_t                  gsm_mqtt_sn_client_sleep(gsm_mqtt_sn_client_p client, uint16_t duration);
+gsmr_t                  gsm_mqtt_sn_client_wakeup(gsm_mqtt_sn_client_p client);
+
+gsmr_t                  gsm_mqtt_sn_client_register(gsm_mqtt_sn_client_p client, const char* topic, void* arg);
+uint8_t                 gsm_mqtt_sn_client_get_topic_id(gsm_mqtt_sn_client_p client, const char* topic, uint16_t* topic_id);
+
+gsmr_t                  gsm_mqtt_sn_client_subscribe(gsm_mqtt_sn_client_p client, const char* topic, gsm_mqtt_sn_qos_t qos, void* arg);
+gsmr_t                  gsm_mqtt_sn_client_subscribe_predefined(gsm_mqtt_sn_client_p client, uint16_t topic_id, gsm_mqtt_sn_qos_t qos, void* arg);
+gsmr_t                  gsm_mqtt_sn_client_unsubscribe(gsm_mqtt_sn_client_p client, const char* topic, void* arg);
+
+gsmr_t                  gsm_mqtt_sn_client_publish(gsm_mqtt_sn_client_p client, gsm_mqtt_sn_topic_type_t topic_type, uint16_t topic_id,
+                                                    const void* payload, uint16_t len, gsm_mqtt_sn_qos_t qos, uint8_t retain, void* arg);
+
+void*                   gsm_mqtt_sn_client_get_arg(gsm_mqtt_sn_client_p client);
+void                    gsm_mqtt_sn_client_set_arg(gsm_mqtt_sn_client_p client, void* arg);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* GSM_HDR_APP_MQTT_SN_CLIENT_H */
@@ -51,8 +51,12 @@ gsmr_t      gsm_init(gsm_evt_fn evt_func, const uint32_t blocking);
 gsmr_t      gsm_reset(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t      gsm_reset_with_delay(uint32_t delay, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 
+gsmr_t      gsm_set_at_baudrate(uint32_t baud, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t      gsm_set_func_mode(uint8_t mode, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 
+gsmr_t      gsm_batch_begin(void);
+gsmr_t      gsm_batch_commit(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+
 gsmr_t      gsm_core_lock(void);
 gsmr_t      gsm_core_unlock(void);
 
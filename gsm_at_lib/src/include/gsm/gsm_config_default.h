@@ -145,6 +145,39 @@
 #define GSM_CFG_AT_PORT_BAUDRATE            115200
 #endif
 
+/**
+ * \brief           Baudrate to switch AT port to during reset sequence
+ *
+ * When set to non-zero value, reset sequence sends `AT+IPR` with this value
+ * after device responds, reconfigures low-level driver and verifies link with `AT` probe.
+ * When probe fails, device is probed at previous baudrate and, when it does not respond there either,
+ * searched for with \ref GSM_CFG_AT_PORT_AUTOBAUD, if enabled.
+ * Set to `0` to keep \ref GSM_CFG_AT_PORT_BAUDRATE
+ *
+ * \note            Maximal value is `921600`
+ */
+#ifndef GSM_CFG_AT_PORT_BAUDRATE_FAST
+#define GSM_CFG_AT_PORT_BAUDRATE_FAST       0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` AT port baudrate detection during reset sequence
+ *
+ * When device does not respond at current baudrate after reset,
+ * all common baudrates are tried until device responds to `AT` probe.
+ * Useful when device was left at unknown baudrate, for example after host crash
+ */
+#ifndef GSM_CFG_AT_PORT_AUTOBAUD
+#define GSM_CFG_AT_PORT_AUTOBAUD            0
+#endif
+
+/**
+ * \brief           Time in units of milliseconds to wait for `AT` response after baudrate change
+ */
+#ifndef GSM_CFG_AT_PORT_BAUDRATE_PROBE_TIMEOUT
+#define GSM_CFG_AT_PORT_BAUDRATE_PROBE_TIMEOUT  500
+#endif
+
 /**
  * \brief           Buffer size for received data waiting to be processed
  * \note            When server mode is active and a lot of connections are in queue
@@ -188,6 +221,37 @@
 #define GSM_CFG_RESET_DELAY_DEFAULT         1000
 #endif
 
+/**
+ * \brief           Maximal time in units of milliseconds to wait for device or SIM to become ready
+ *
+ * Waiting finishes earlier when device reports readiness with `RDY`, `+CPIN: READY`,
+ * `Call Ready` or `SMS Ready` message, or when device responds to `AT` probe after reset.
+ * When time expires, sequence continues as if device was ready
+ */
+#ifndef GSM_CFG_READY_TIMEOUT
+#define GSM_CFG_READY_TIMEOUT               5000
+#endif
+
+/**
+ * \brief           Time in units of milliseconds to wait for response on `AT` probe,
+ *                  before it is sent again, while waiting for device to start after reset
+ */
+#ifndef GSM_CFG_READY_PROBE_INTERVAL
+#define GSM_CFG_READY_PROBE_INTERVAL        250
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` warm start with stored device profile
+ *
+ * When enabled, reset sequence reads serial number first and compares it with
+ * profile loaded by user callback, set with \ref gsm_device_set_profile_fn.
+ * When it matches, identification commands are skipped and stored identity is used.
+ * Volatile settings (echo, functionality, error reporting, URCs) are always sent
+ */
+#ifndef GSM_CFG_WARM_START
+#define GSM_CFG_WARM_START                  0
+#endif
+
 /**
  * \defgroup        GSM_CONFIG_DBG Debugging
  * \brief           Debugging configurations
@@ -363,6 +427,88 @@
 #define GSM_CFG_THREAD_PROCESS_MBOX_SIZE    16
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` priority processing of API commands
+ *
+ * When enabled, producer thread sorts waiting commands to control, interactive and bulk class
+ * and executes higher class first. Long commands (operator scan, SMS and phonebook listing,
+ * large data send) are bulk, connection close, hang up and signal quality are control class.
+ *
+ * Commands for the same connection are always executed in order they were sent
+ */
+#ifndef GSM_CFG_PRODUCER_PRIORITY
+#define GSM_CFG_PRODUCER_PRIORITY           0
+#endif
+
+/**
+ * \brief           Number of times lower class command may be overtaken before it is executed anyway
+ */
+#ifndef GSM_CFG_PRODUCER_PRIORITY_STARVE_LIMIT
+#define GSM_CFG_PRODUCER_PRIORITY_STARVE_LIMIT  4
+#endif
+
+/**
+ * \brief           Minimal length of data in units of bytes for connection send command to be bulk class
+ */
+#ifndef GSM_CFG_PRODUCER_PRIORITY_BULK_SEND_LEN
+#define GSM_CFG_PRODUCER_PRIORITY_BULK_SEND_LEN 256
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` suspending long running commands
+ *
+ * When new command is sent to queue while operator scan is in progress,
+ * scan is aborted on device side, new command is executed
+ * and scan is repeated from the beginning afterwards.
+ * Data connections are therefore not blocked for duration of the scan
+ */
+#ifndef GSM_CFG_CMD_SUSPEND
+#define GSM_CFG_CMD_SUSPEND                 0
+#endif
+
+/**
+ * \brief           Maximal number of times single command may be suspended
+ *
+ * When limit is reached, command is executed till the end regardless of other commands
+ */
+#ifndef GSM_CFG_CMD_SUSPEND_MAX
+#define GSM_CFG_CMD_SUSPEND_MAX             3
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` coalescing of read-only commands
+ *
+ * When signal strength, current operator or connection status command
+ * is requested while the same command is already waiting or in progress,
+ * new request does not send its own AT command but gets result of the pending one
+ */
+#ifndef GSM_CFG_CMD_COALESCE
+#define GSM_CFG_CMD_COALESCE                0
+#endif
+
+/**
+ * \brief           Time in units of milliseconds for which last result of read-only command is reused
+ *
+ * Request within this time after successful command finishes immediately with stored result.
+ * Set to `0` to disable result caching
+ *
+ * \note            \ref GSM_CFG_CMD_COALESCE must be enabled to use this feature
+ */
+#ifndef GSM_CFG_CMD_COALESCE_CACHE_TTL
+#define GSM_CFG_CMD_COALESCE_CACHE_TTL      0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` batch API
+ *
+ * API functions called between \ref gsm_batch_begin and \ref gsm_batch_commit
+ * are collected and sent to producer thread as one message,
+ * executed back to back with single completion
+ */
+#ifndef GSM_CFG_BATCH
+#define GSM_CFG_BATCH                       0
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` direct support for processing input data
  *
@@ -474,6 +620,135 @@
 #define GSM_CFG_MQTT_MAX_REQUESTS           8
 #endif
 
+/**
+ * \brief           Maximal number of send commands client keeps in flight on connection
+ *
+ * Packets written while all sends are in flight stay in output buffer
+ * and are transmitted together with next send command.
+ * Each send covers up to \ref GSM_CFG_CONN_MAX_DATA_LEN bytes,
+ * including data wrapped around end of output buffer.
+ *
+ * \note            Set to `1` to wait for each send to finish before next one starts
+ */
+#ifndef GSM_CFG_MQTT_MAX_SENDS
+#define GSM_CFG_MQTT_MAX_SENDS              2
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` store-and-forward offline queue
+ *                  for publish packets with quality of service `1` or `2`
+ *
+ * When enabled and queue is assigned to client with \ref gsm_mqtt_client_queue_set,
+ * messages are stored while link is down and replayed in order once client is connected again
+ */
+#ifndef GSM_CFG_MQTT_OFFLINE_QUEUE
+#define GSM_CFG_MQTT_OFFLINE_QUEUE          0
+#endif
+
+/**
+ * \brief           Maximal number of queued messages written to output buffer
+ *                  in single shot when offline queue is drained
+ *
+ * Messages are written back-to-back and transmitted with single send command
+ *
+ * \note            Actual number is limited also by \ref GSM_CFG_MQTT_MAX_REQUESTS
+ *                  and free memory in client output buffer
+ */
+#ifndef GSM_CFG_MQTT_OFFLINE_QUEUE_BATCH
+#define GSM_CFG_MQTT_OFFLINE_QUEUE_BATCH    4
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` file-backed storage for offline queue
+ *
+ * Storage uses standard C file functions and survives device restart
+ *
+ * \note            \ref GSM_CFG_MQTT_OFFLINE_QUEUE must be enabled
+ */
+#ifndef GSM_CFG_MQTT_OFFLINE_QUEUE_FILE
+#define GSM_CFG_MQTT_OFFLINE_QUEUE_FILE     0
+#endif
+
+/**
+ * \brief           Minimal number of bytes of removed records in offline queue file before file is compacted
+ *
+ * File is compacted only when removed records also take more space than remaining ones,
+ * so queue which never gets empty does not grow without limit
+ *
+ * \note            \ref GSM_CFG_MQTT_OFFLINE_QUEUE_FILE must be enabled
+ */
+#ifndef GSM_CFG_MQTT_OFFLINE_QUEUE_FILE_COMPACT
+#define GSM_CFG_MQTT_OFFLINE_QUEUE_FILE_COMPACT 4096
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` automatic reconnect of MQTT client
+ *
+ * When enabled with \ref gsm_mqtt_client_set_reconnect, client reconnects to server
+ * with exponential backoff after connection is lost or could not be established,
+ * and restores subscriptions if server did not keep the session
+ */
+#ifndef GSM_CFG_MQTT_RECONNECT
+#define GSM_CFG_MQTT_RECONNECT              0
+#endif
+
+/**
+ * \brief           Delay before first reconnect attempt in units of milliseconds
+ *
+ * Delay is doubled on each failed attempt. Random jitter reduces it for up to half
+ */
+#ifndef GSM_CFG_MQTT_RECONNECT_MIN_DELAY
+#define GSM_CFG_MQTT_RECONNECT_MIN_DELAY    1000
+#endif
+
+/**
+ * \brief           Maximal delay between reconnect attempts in units of milliseconds
+ */
+#ifndef GSM_CFG_MQTT_RECONNECT_MAX_DELAY
+#define GSM_CFG_MQTT_RECONNECT_MAX_DELAY    60000
+#endif
+
+/**
+ * \brief           Maximal number of topic subscriptions remembered by client
+ *                  and restored after reconnect
+ *
+ * \note            Used only when \ref GSM_CFG_MQTT_RECONNECT is enabled
+ */
+#ifndef GSM_CFG_MQTT_MAX_SUBSCRIPTIONS
+#define GSM_CFG_MQTT_MAX_SUBSCRIPTIONS      8
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` MQTT v5.0 protocol support
+ *
+ * When enabled, protocol is selected per connection with \ref gsm_mqtt_client_info_t.protocol_version
+ */
+#ifndef GSM_CFG_MQTT_V5
+#define GSM_CFG_MQTT_V5                     0
+#endif
+
+/**
+ * \brief           Maximal number of topic aliases client uses on MQTT v5.0 connection
+ *
+ * Topic alias replaces topic string in publish packets after first use on connection.
+ * Actual number is limited also by server, set to `0` to disable topic aliases
+ *
+ * \note            Each alias keeps allocated copy of topic string while connected
+ */
+#ifndef GSM_CFG_MQTT_TOPIC_ALIAS_MAX
+#define GSM_CFG_MQTT_TOPIC_ALIAS_MAX        8
+#endif
+
+/**
+ * \brief           Session expiry interval in units of seconds, sent on MQTT v5.0 connection
+ *                  when client requests to keep the session
+ *
+ * \note            Used only when \ref gsm_mqtt_client_info_t.keep_session is set
+ */
+#ifndef GSM_CFG_MQTT_SESSION_EXPIRY
+#define GSM_CFG_MQTT_SESSION_EXPIRY         3600
+#endif
+
 /**
  * \brief           Set debug level for MQTT client module
  *
@@ -492,6 +767,48 @@
 #define GSM_CFG_DBG_MQTT_API                GSM_DBG_OFF
 #endif
 
+/**
+ * \}
+ */
+
+/**
+ * \defgroup        GSM_CONFIG_MODULES_MQTT_SN MQTT-SN client module
+ * \brief           Configuration of MQTT-SN client module
+ * \{
+ */
+
+/**
+ * \brief           Maximal number of topic names with topic IDs
+ *                  registered at a time on single MQTT-SN client
+ */
+#ifndef GSM_CFG_MQTT_SN_MAX_TOPICS
+#define GSM_CFG_MQTT_SN_MAX_TOPICS          8
+#endif
+
+/**
+ * \brief           Time in units of milliseconds to wait for gateway reply
+ *                  before request is sent again
+ */
+#ifndef GSM_CFG_MQTT_SN_RETRY_TIMEOUT
+#define GSM_CFG_MQTT_SN_RETRY_TIMEOUT       10000
+#endif
+
+/**
+ * \brief           Number of retransmissions before gateway is considered lost
+ */
+#ifndef GSM_CFG_MQTT_SN_RETRY_COUNT
+#define GSM_CFG_MQTT_SN_RETRY_COUNT         3
+#endif
+
+/**
+ * \brief           Set debug level for MQTT-SN client module
+ *
+ * Possible values are \ref GSM_DBG_ON or \ref GSM_DBG_OFF
+ */
+#ifndef GSM_CFG_DBG_MQTT_SN
+#define GSM_CFG_DBG_MQTT_SN                 GSM_DBG_OFF
+#endif
+
 /**
  * \}
  */
@@ -517,6 +834,36 @@
 #define GSM_CFG_NETWORK_IGNORE_CGACT_RESULT 0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` network registration and bearer state tracker
+ *
+ * When enabled, `+CREG` and `+CGREG` are reported with location area code and cell ID,
+ * state changes are published with \ref GSM_EVT_NETWORK_STATE event,
+ * and PDP context is automatically re-attached after loss,
+ * if application attached with \ref gsm_network_attach before
+ *
+ * \note            \ref GSM_CFG_NETWORK must be enabled to use this feature
+ */
+#ifndef GSM_CFG_NETWORK_TRACKER
+#define GSM_CFG_NETWORK_TRACKER             0
+#endif
+
+/**
+ * \brief           Initial automatic re-attach backoff in units of milliseconds
+ *
+ * Backoff doubles after each failed attempt. Actual delay is random between half and full backoff
+ */
+#ifndef GSM_CFG_NETWORK_TRACKER_BACKOFF_MIN
+#define GSM_CFG_NETWORK_TRACKER_BACKOFF_MIN 2000
+#endif
+
+/**
+ * \brief           Maximal automatic re-attach backoff in units of milliseconds
+ */
+#ifndef GSM_CFG_NETWORK_TRACKER_BACKOFF_MAX
+#define GSM_CFG_NETWORK_TRACKER_BACKOFF_MAX 120000
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` connection API.
  *
@@ -534,6 +881,115 @@
 #define GSM_CFG_SMS                         0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` PDU mode for SMS API
+ *
+ * When enabled, messages are sent, read and listed in PDU mode.
+ * Text is encoded with GSM 03.38 default alphabet when possible or UCS2 otherwise,
+ * and binary messages can be sent with \ref gsm_sms_send_data function
+ *
+ * \note            \ref GSM_CFG_SMS must be enabled to use this feature
+ */
+#ifndef GSM_CFG_SMS_PDU
+#define GSM_CFG_SMS_PDU                     0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` concatenated SMS messages
+ *
+ * When enabled, long text or binary data is split to multiple messages
+ * with concatenation user data header, sent with single API call.
+ * Received message parts are collected and reported with
+ * \ref GSM_EVT_SMS_CONCAT_RECV event once all parts have been read from device
+ *
+ * \note            \ref GSM_CFG_SMS_PDU must be enabled to use this feature
+ */
+#ifndef GSM_CFG_SMS_CONCAT
+#define GSM_CFG_SMS_CONCAT                  0
+#endif
+
+/**
+ * \brief           Maximal number of parts of single concatenated message,
+ *                  used for send and receive operations
+ */
+#ifndef GSM_CFG_SMS_CONCAT_MAX_PARTS
+#define GSM_CFG_SMS_CONCAT_MAX_PARTS        4
+#endif
+
+/**
+ * \brief           Maximal number of concatenated messages being reassembled at a time
+ *
+ * When all slots are used, oldest message is dropped to make space for new one
+ */
+#ifndef GSM_CFG_SMS_CONCAT_MAX_MSGS
+#define GSM_CFG_SMS_CONCAT_MAX_MSGS         2
+#endif
+
+/**
+ * \brief           Time in units of milliseconds after last received part
+ *                  when incomplete concatenated message is dropped
+ */
+#ifndef GSM_CFG_SMS_CONCAT_TIMEOUT
+#define GSM_CFG_SMS_CONCAT_TIMEOUT          600000
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` 16-bit reference number for sent concatenated messages
+ *
+ * 8-bit reference leaves `153` GSM characters per part, 16-bit reference leaves `152` characters
+ */
+#ifndef GSM_CFG_SMS_CONCAT_REF16
+#define GSM_CFG_SMS_CONCAT_REF16            0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` direct delivery of received SMS messages
+ *
+ * When enabled, device is configured with `AT+CNMI=2,2` when SMS is enabled.
+ * Received messages are not stored to memory but sent over AT port with `+CMT`
+ * and reported with \ref GSM_EVT_SMS_DELIVER event, without any read or delete command.
+ *
+ * Use \ref gsm_sms_ack to acknowledge message when device requires it
+ *
+ * \note            \ref GSM_CFG_SMS must be enabled to use this feature
+ */
+#ifndef GSM_CFG_SMS_DIRECT
+#define GSM_CFG_SMS_DIRECT                  0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` background SMS storage drainer
+ *
+ * When enabled, unread messages of receive storage are listed with single command
+ * after `+CMTI` is received or storage usage reaches \ref GSM_CFG_SMS_DRAIN_WATERMARK.
+ * Every message is reported with \ref GSM_EVT_SMS_DRAIN event and reported messages
+ * are deleted afterwards by their position.
+ *
+ * Drain can also be started manually with \ref gsm_sms_drain function
+ *
+ * \note            \ref GSM_CFG_SMS must be enabled to use this feature
+ */
+#ifndef GSM_CFG_SMS_DRAIN
+#define GSM_CFG_SMS_DRAIN                   0
+#endif
+
+/**
+ * \brief           Receive storage usage in units of percent to start SMS drain
+ */
+#ifndef GSM_CFG_SMS_DRAIN_WATERMARK
+#define GSM_CFG_SMS_DRAIN_WATERMARK         80
+#endif
+
+/**
+ * \brief           Maximal number of messages reported and deleted by single SMS drain
+ *
+ * Messages listed above this number are not reported and stay unread,
+ * drain is started again when current one finishes
+ */
+#ifndef GSM_CFG_SMS_DRAIN_MAX_MSGS
+#define GSM_CFG_SMS_DRAIN_MAX_MSGS          16
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` call API.
  *
@@ -550,6 +1006,27 @@
 #define GSM_CFG_PHONEBOOK                   0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` phonebook mirror in RAM
+ *
+ * When enabled, single phonebook memory can be loaded to RAM with \ref gsm_pb_cache_load
+ * and searched by number or name prefix without any AT command.
+ * Mirror is kept in sync by \ref gsm_pb_add, \ref gsm_pb_edit and \ref gsm_pb_delete functions
+ * and used to resolve caller name on `+CLCC` when device does not report it
+ *
+ * \note            \ref GSM_CFG_PHONEBOOK must be enabled to use this feature
+ */
+#ifndef GSM_CFG_PHONEBOOK_CACHE
+#define GSM_CFG_PHONEBOOK_CACHE             0
+#endif
+
+/**
+ * \brief           Maximal number of entries in phonebook mirror
+ */
+#ifndef GSM_CFG_PHONEBOOK_CACHE_SIZE
+#define GSM_CFG_PHONEBOOK_CACHE_SIZE        50
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` HTTP API.
  *
@@ -664,6 +1141,56 @@ void *  my_memset(void* dst, int b, size_t len);
     #endif /* GSM_CFG_INPUT_USE_PROCESS */
 #endif /* !GSM_CFG_OS */
 
+#if !GSM_CFG_SMS
+    #if GSM_CFG_SMS_PDU
+    #error "GSM_CFG_SMS_PDU may only be enabled when GSM_CFG_SMS is enabled!"
+    #endif /* GSM_CFG_SMS_PDU */
+    #if GSM_CFG_SMS_DIRECT
+    #error "GSM_CFG_SMS_DIRECT may only be enabled when GSM_CFG_SMS is enabled!"
+    #endif /* GSM_CFG_SMS_DIRECT */
+    #if GSM_CFG_SMS_DRAIN
+    #error "GSM_CFG_SMS_DRAIN may only be enabled when GSM_CFG_SMS is enabled!"
+    #endif /* GSM_CFG_SMS_DRAIN */
+#endif /* !GSM_CFG_SMS */
+
+#if !GSM_CFG_NETWORK
+    #if GSM_CFG_NETWORK_TRACKER
+    #error "GSM_CFG_NETWORK_TRACKER may only be enabled when GSM_CFG_NETWORK is enabled!"
+    #endif /* GSM_CFG_NETWORK_TRACKER */
+#endif /* !GSM_CFG_NETWORK */
+
+#if GSM_CFG_PRODUCER_PRIORITY && (GSM_CFG_PRODUCER_PRIORITY_STARVE_LIMIT < 1 || GSM_CFG_PRODUCER_PRIORITY_STARVE_LIMIT > 255)
+#error "GSM_CFG_PRODUCER_PRIORITY_STARVE_LIMIT must be between 1 and 255!"
+#endif /* GSM_CFG_PRODUCER_PRIORITY && (GSM_CFG_PRODUCER_PRIORITY_STARVE_LIMIT < 1 || GSM_CFG_PRODUCER_PRIORITY_STARVE_LIMIT > 255) */
+
+#if GSM_CFG_AT_PORT_BAUDRATE_FAST > 921600
+#error "GSM_CFG_AT_PORT_BAUDRATE_FAST must not be greater than 921600!"
+#endif /* GSM_CFG_AT_PORT_BAUDRATE_FAST > 921600 */
+
+#if GSM_CFG_NETWORK_TRACKER && GSM_CFG_NETWORK_TRACKER_BACKOFF_MIN > GSM_CFG_NETWORK_TRACKER_BACKOFF_MAX
+#error "GSM_CFG_NETWORK_TRACKER_BACKOFF_MIN must not be greater than GSM_CFG_NETWORK_TRACKER_BACKOFF_MAX!"
+#endif /* GSM_CFG_NETWORK_TRACKER && GSM_CFG_NETWORK_TRACKER_BACKOFF_MIN > GSM_CFG_NETWORK_TRACKER_BACKOFF_MAX */
+
+#if !GSM_CFG_PHONEBOOK
+    #if GSM_CFG_PHONEBOOK_CACHE
+    #error "GSM_CFG_PHONEBOOK_CACHE may only be enabled when GSM_CFG_PHONEBOOK is enabled!"
+    #endif /* GSM_CFG_PHONEBOOK_CACHE */
+#endif /* !GSM_CFG_PHONEBOOK */
+
+#if GSM_CFG_PHONEBOOK_CACHE && (GSM_CFG_PHONEBOOK_CACHE_SIZE < 1 || GSM_CFG_PHONEBOOK_CACHE_SIZE > 65535)
+#error "GSM_CFG_PHONEBOOK_CACHE_SIZE must be between 1 and 65535!"
+#endif /* GSM_CFG_PHONEBOOK_CACHE && (GSM_CFG_PHONEBOOK_CACHE_SIZE < 1 || GSM_CFG_PHONEBOOK_CACHE_SIZE > 65535) */
+
+#if !GSM_CFG_SMS_PDU
+    #if GSM_CFG_SMS_CONCAT
+    #error "GSM_CFG_SMS_CONCAT may only be enabled when GSM_CFG_SMS_PDU is enabled!"
+    #endif /* GSM_CFG_SMS_CONCAT */
+#endif /* !GSM_CFG_SMS_PDU */
+
+#if GSM_CFG_SMS_CONCAT && (GSM_CFG_SMS_CONCAT_MAX_PARTS < 2 || GSM_CFG_SMS_CONCAT_MAX_PARTS > 255)
+#error "GSM_CFG_SMS_CONCAT_MAX_PARTS must be between 2 and 255!"
+#endif /* GSM_CFG_SMS_CONCAT && (GSM_CFG_SMS_CONCAT_MAX_PARTS < 2 || GSM_CFG_SMS_CONCAT_MAX_PARTS > 255) */
+
 #endif /* !__DOXYGEN__ */
 
 #endif /* GSM_HDR_DEFAULT_CONFIG_H */
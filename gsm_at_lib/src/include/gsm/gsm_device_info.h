@@ -52,6 +52,10 @@ gsmr_t      gsm_device_get_model(char* model, size_t len, const gsm_api_cmd_evt_
 gsmr_t      gsm_device_get_revision(char* rev, size_t len, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t      gsm_device_get_serial_number(char* serial, size_t len, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 
+#if GSM_CFG_WARM_START || __DOXYGEN__
+gsmr_t      gsm_device_set_profile_fn(gsm_device_profile_load_fn load_fn, gsm_device_profile_save_fn save_fn);
+#endif /* GSM_CFG_WARM_START || __DOXYGEN__ */
+
 /**
  * \}
  */
@@ -87,6 +87,22 @@ const gsm_operator_curr_t*  gsm_evt_network_operator_get_current(gsm_evt_t* cc);
  * \}
  */
 
+#if GSM_CFG_NETWORK_TRACKER || __DOXYGEN__
+
+/**
+ * \anchor          GSM_EVT_NETWORK_STATE
+ * \name            Network state
+ * \brief           Event helper functions for \ref GSM_EVT_NETWORK_STATE event
+ */
+
+const gsm_network_state_t*  gsm_evt_network_state_get_state(gsm_evt_t* cc);
+
+/**
+ * \}
+ */
+
+#endif /* GSM_CFG_NETWORK_TRACKER || __DOXYGEN__ */
+
 /**
  * \anchor          GSM_EVT_CONN_RECV
  * \name            Connection data received
@@ -217,6 +233,19 @@ gsmr_t              gsm_evt_sms_read_get_result(gsm_evt_t* cc);
 gsmr_t  gsm_evt_sms_send_get_result(gsm_evt_t* cc);
 size_t  gsm_evt_sms_send_get_pos(gsm_evt_t* cc);
 
+/**
+ * \}
+ */
+
+/**
+ * \anchor          GSM_EVT_SMS_SEND_BATCH
+ * \name            SMS batch send
+ * \brief           Event helper functions for \ref GSM_EVT_SMS_SEND_BATCH event
+ */
+
+gsm_sms_batch_entry_t*  gsm_evt_sms_send_batch_get_entry(gsm_evt_t* cc);
+size_t                  gsm_evt_sms_send_batch_get_index(gsm_evt_t* cc);
+
 /**
  * \}
  */
@@ -231,6 +260,48 @@ gsmr_t      gsm_evt_sms_delete_get_result(gsm_evt_t* cc);
 size_t      gsm_evt_sms_delete_get_pos(gsm_evt_t* cc);
 gsm_mem_t   gsm_evt_sms_delete_get_mem(gsm_evt_t* cc);
 
+/**
+ * \}
+ */
+
+/**
+ * \anchor          GSM_EVT_SMS_CONCAT_RECV
+ * \name            Concatenated SMS received
+ * \brief           Event helper functions for \ref GSM_EVT_SMS_CONCAT_RECV event
+ */
+
+const char* gsm_evt_sms_concat_recv_get_number(gsm_evt_t* cc);
+const char* gsm_evt_sms_concat_recv_get_data(gsm_evt_t* cc);
+size_t      gsm_evt_sms_concat_recv_get_length(gsm_evt_t* cc);
+gsm_sms_dcs_t   gsm_evt_sms_concat_recv_get_dcs(gsm_evt_t* cc);
+gsm_mem_t   gsm_evt_sms_concat_recv_get_mem(gsm_evt_t* cc);
+uint8_t     gsm_evt_sms_concat_recv_get_parts(gsm_evt_t* cc);
+size_t      gsm_evt_sms_concat_recv_get_pos(gsm_evt_t* cc, uint8_t index);
+
+/**
+ * \}
+ */
+
+/**
+ * \anchor          GSM_EVT_SMS_DELIVER
+ * \name            SMS delivered directly
+ * \brief           Event helper functions for \ref GSM_EVT_SMS_DELIVER event
+ */
+
+gsm_sms_entry_t*    gsm_evt_sms_deliver_get_entry(gsm_evt_t* cc);
+
+/**
+ * \}
+ */
+
+/**
+ * \anchor          GSM_EVT_SMS_DRAIN
+ * \name            SMS listed by storage drainer
+ * \brief           Event helper functions for \ref GSM_EVT_SMS_DRAIN event
+ */
+
+gsm_sms_entry_t*    gsm_evt_sms_drain_get_entry(gsm_evt_t* cc);
+
 /**
  * \}
  */
@@ -51,6 +51,9 @@
 #if GSM_CFG_SMS || __DOXYGEN__
 #include "gsm/gsm_sms.h"
 #endif /* GSM_CFG_SMS || __DOXYGEN__ */
+#if (GSM_CFG_SMS && GSM_CFG_SMS_PDU) || __DOXYGEN__
+#include "gsm/gsm_sms_pdu.h"
+#endif /* (GSM_CFG_SMS && GSM_CFG_SMS_PDU) || __DOXYGEN__ */
 #if GSM_CFG_CALL || __DOXYGEN__
 #include "gsm/gsm_call.h"
 #endif /* GSM_CFG_CALL || __DOXYGEN__ */
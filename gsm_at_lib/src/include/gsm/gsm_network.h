@@ -57,6 +57,9 @@ gsmr_t      gsm_network_detach(const gsm_api_cmd_evt_fn evt_fn, void* const evt_
 uint8_t     gsm_network_is_attached(void);
 gsmr_t      gsm_network_copy_ip(gsm_ip_t* ip);
 gsmr_t      gsm_network_check_status(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#if GSM_CFG_NETWORK_TRACKER || __DOXYGEN__
+gsmr_t      gsm_network_get_state(gsm_network_state_t* state);
+#endif /* GSM_CFG_NETWORK_TRACKER || __DOXYGEN__ */
 
 /**
  * \}
@@ -47,10 +47,12 @@ uint8_t     gsmi_parse_mac(const char** src, gsm_mac_t* mac);
 
 uint8_t     gsmi_parse_cpin(const char* str, uint8_t send_evt);
 uint8_t     gsmi_parse_creg(const char* str, uint8_t skip_first);
+uint8_t     gsmi_parse_cgreg(const char* str, uint8_t skip_first);
 uint8_t     gsmi_parse_csq(const char* str);
 
 uint8_t     gsmi_parse_cmgs(const char* str, size_t* num);
 uint8_t     gsmi_parse_cmti(const char* str, uint8_t send_evt);
+uint8_t     gsmi_parse_cmt(const char* str);
 uint8_t     gsmi_parse_cmgr(const char* str);
 uint8_t     gsmi_parse_cmgl(const char* str);
 
@@ -57,6 +57,12 @@ gsmr_t      gsm_pb_read(gsm_mem_t mem, size_t pos, gsm_pb_entry_t* entry, const
 gsmr_t      gsm_pb_list(gsm_mem_t mem, size_t start_index, gsm_pb_entry_t* entries, size_t etr, size_t* er, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t      gsm_pb_search(gsm_mem_t mem, const char* search, gsm_pb_entry_t* entries, size_t etr, size_t* er, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 
+#if GSM_CFG_PHONEBOOK_CACHE || __DOXYGEN__
+gsmr_t      gsm_pb_cache_load(gsm_mem_t mem, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t      gsm_pb_cache_find_number(const char* num, gsm_pb_entry_t* entry);
+gsmr_t      gsm_pb_cache_find_name(const char* prefix, gsm_pb_entry_t* entries, size_t etr, size_t* er);
+#endif /* GSM_CFG_PHONEBOOK_CACHE || __DOXYGEN__ */
+
 /**
  * \}
  */
@@ -52,20 +52,25 @@ extern "C" {
  */
 typedef enum {
     GSM_CMD_IDLE = 0,                           /*!< IDLE mode */
+    GSM_CMD_BATCH,                              /*!< Execute collected messages back to back */
 
     /* Basic AT commands */
     GSM_CMD_RESET,                              /*!< Reset device */
     GSM_CMD_RESET_DEVICE_FIRST_CMD,             /*!< Reset device first driver specific command */
+    GSM_CMD_READY_PROBE,                        /*!< Send `AT` until device responds after reset */
+    GSM_CMD_READY_WAIT,                         /*!< Wait for device readiness message, no command is sent */
+    GSM_CMD_UART_PROBE,                         /*!< Send `AT` until device responds after baudrate change */
     GSM_CMD_ATE0,                               /*!< Disable ECHO mode on AT commands */
     GSM_CMD_ATE1,                               /*!< Enable ECHO mode on AT commands */
     GSM_CMD_GSLP,                               /*!< Set GSM to sleep mode */
     GSM_CMD_RESTORE,                            /*!< Restore GSM internal settings to default values */
-    GSM_CMD_UART,
+    GSM_CMD_UART,                               /*!< Set AT port baudrate with `AT+IPR` */
 
     GSM_CMD_CGACT_SET_0,
     GSM_CMD_CGACT_SET_1,
     GSM_CMD_CGATT_SET_0,
     GSM_CMD_CGATT_SET_1,
+    GSM_CMD_CGATT_GET,                          /*!< Get GPRS attach state */
     GSM_CMD_NETWORK_ATTACH,                     /*!< Attach to a network */
     GSM_CMD_NETWORK_DETACH,                     /*!< Detach from network */
 
@@ -150,6 +155,7 @@ typedef enum {
     GSM_CMD_COLP,                               /*!< Connected Line Identification Presentation */
 
     GSM_CMD_PHONEBOOK_ENABLE,
+    GSM_CMD_PB_CACHE_LOAD,                      /*!< Load phonebook memory to RAM mirror */
     GSM_CMD_CPBF,                               /*!< Find Phonebook Entries */
     GSM_CMD_CPBR,                               /*!< Read Current Phonebook Entries  */
     GSM_CMD_CPBS_SET,                           /*!< Select Phonebook Memory Storage */
@@ -171,6 +177,8 @@ typedef enum {
     GSM_CMD_CFUN_GET,                           /*!< Get Phone Functionality */
     GSM_CMD_CREG_SET,                           /*!< Network Registration set output */
     GSM_CMD_CREG_GET,                           /*!< Get current network registration status */
+    GSM_CMD_CGREG_SET,                          /*!< GPRS network registration set output */
+    GSM_CMD_CGREG_GET,                          /*!< Get current GPRS network registration status */
     GSM_CMD_CBC,                                /*!< Battery Charge */
     GSM_CMD_CNUM,                               /*!< Subscriber Number */
 
@@ -231,6 +239,8 @@ typedef enum {
     GSM_CMD_CIPSSL,                             /*!< Connection SSL function */
 
     GSM_CMD_SMS_ENABLE,
+    GSM_CMD_SMS_SEND_BATCH,                     /*!< Send multiple SMS messages */
+    GSM_CMD_SMS_DRAIN,                          /*!< List unread SMS messages and delete read ones */
     GSM_CMD_CMGD,                               /*!< Delete SMS Message */
     GSM_CMD_CMGF,                               /*!< Select SMS Message Format */
     GSM_CMD_CMGL,                               /*!< List SMS Messages from Preferred Store */
@@ -238,8 +248,10 @@ typedef enum {
     GSM_CMD_CMGS,                               /*!< Send SMS Message */
     GSM_CMD_CMGW,                               /*!< Write SMS Message to Memory */
     GSM_CMD_CMSS,                               /*!< Send SMS Message from Storage */
+    GSM_CMD_CMMS,                               /*!< More Messages to Send */
     GSM_CMD_CMGDA,                              /*!< MASS SMS delete */
     GSM_CMD_CNMI,                               /*!< New SMS Message Indications */
+    GSM_CMD_CNMA,                               /*!< New Message Acknowledgement to ME/TA */
     GSM_CMD_CPMS_SET,                           /*!< Set preferred SMS Message Storage */
     GSM_CMD_CPMS_GET,                           /*!< Get preferred SMS Message Storage */
     GSM_CMD_CPMS_GET_OPT,                       /*!< Get optional SMS message storages */
@@ -324,6 +336,16 @@ typedef enum {
     GSM_CONN_CONNECT_ALREADY,                   /*!< Already connected */
 } gsm_conn_connect_res_t;
 
+/**
+ * \brief           Priority class of message in producer thread
+ */
+typedef enum {
+    GSM_MSG_PRIO_CONTROL,                       /*!< Short commands which must not wait, such as connection close */
+    GSM_MSG_PRIO_INTERACTIVE,                   /*!< Default class */
+    GSM_MSG_PRIO_BULK,                          /*!< Long running commands and large data transfers */
+    GSM_MSG_PRIO_END,                           /*!< Number of priority classes */
+} gsm_msg_prio_t;
+
 /**
  * \brief           Message queue structure to share between threads
  */
@@ -341,13 +363,41 @@ typedef struct gsm_msg {
     gsm_api_cmd_evt_fn evt_fn;                  /*!< Command callback API function */
     void*           evt_arg;                    /*!< Command callback API callback parameter */
 #endif /* GSM_CFG_USE_API_FUNC_EVT */
+#if GSM_CFG_PRODUCER_PRIORITY || __DOXYGEN__
+    struct gsm_msg* next;                       /*!< Next message in producer priority list */
+#endif /* GSM_CFG_PRODUCER_PRIORITY || __DOXYGEN__ */
+#if GSM_CFG_CMD_SUSPEND || __DOXYGEN__
+    uint8_t         suspend_req;                /*!< Flag indicating command was aborted on device to let other command run */
+    uint8_t         suspended;                  /*!< Flag indicating command finished because of abort and must be repeated */
+    uint8_t         suspend_cnt;                /*!< Number of times command was suspended */
+#endif /* GSM_CFG_CMD_SUSPEND || __DOXYGEN__ */
+#if GSM_CFG_CMD_COALESCE || __DOXYGEN__
+    struct gsm_msg* coalesce_next;              /*!< Next message waiting for result of this one */
+#endif /* GSM_CFG_CMD_COALESCE || __DOXYGEN__ */
+#if GSM_CFG_BATCH || __DOXYGEN__
+    struct gsm_msg* batch;                      /*!< Batch message this message is part of */
+    struct gsm_msg* batch_next;                 /*!< Next message in the same batch */
+#endif /* GSM_CFG_BATCH || __DOXYGEN__ */
 
     union {
         struct {
             uint32_t delay;                     /*!< Delay to use before sending first reset AT command */
+            uint32_t baudrate_prev;             /*!< Baudrate to go back to when probe fails */
+            uint8_t fallback;                   /*!< Flag indicating device is probed at previous baudrate after failed switch */
+            uint8_t autobaud;                   /*!< Flag indicating baudrate detection is in progress */
+            uint8_t probed;                     /*!< Flag indicating device was probed before `AT+CFUN=1,1` reset */
+            size_t autobaud_idx;                /*!< Index of next baudrate to try */
         } reset;                                /*!< Reset device */
+#if GSM_CFG_BATCH || __DOXYGEN__
+        struct {
+            struct gsm_msg* first;              /*!< First message to execute */
+            struct gsm_msg* last;               /*!< Last collected message */
+        } batch;                                /*!< Batch of messages */
+#endif /* GSM_CFG_BATCH || __DOXYGEN__ */
         struct {
             uint32_t baudrate;                  /*!< Baudrate for AT port */
+            uint32_t baudrate_prev;             /*!< Baudrate to go back to when probe fails */
+            uint8_t fallback;                   /*!< Flag indicating device is probed at previous baudrate after failed switch */
         } uart;                                 /*!< UART configuration */
 
         struct {
@@ -438,6 +488,21 @@ typedef struct gsm_msg {
             const char* text;                   /*!< SMS content to send */
             uint8_t format;                     /*!< SMS format, `0 = PDU`, `1 = text` */
             size_t pos;                         /*!< Set on +CMGS response if command is OK */
+            gsm_sms_batch_entry_t* entries;     /*!< Entries of batch send operation */
+            size_t count;                       /*!< Number of entries of batch send operation */
+            size_t index;                       /*!< Index of entry currently sent in batch send operation */
+            size_t failed;                      /*!< Number of entries failed in batch send operation */
+#if GSM_CFG_SMS_PDU || __DOXYGEN__
+            size_t len;                         /*!< Length of content in units of bytes, used in PDU mode */
+            gsm_sms_dcs_t dcs;                  /*!< Data coding scheme, used in PDU mode */
+            uint16_t ref;                       /*!< Reference number of concatenated message */
+            uint8_t parts;                      /*!< Number of message parts. Set to `1` for single message */
+            uint8_t part;                       /*!< Index of part currently sent, starting with `0` */
+            size_t part_off;                    /*!< Offset of current part in content */
+            size_t part_len;                    /*!< Length of current part in content */
+            uint8_t udh[GSM_SMS_PDU_CONCAT_UDH_MAX_LEN];/*!< User data header of current part */
+            size_t udh_len;                     /*!< Length of user data header of current part */
+#endif /* GSM_CFG_SMS_PDU || __DOXYGEN__ */
         } sms_send;                             /*!< Send SMS */
         struct {
             gsm_mem_t mem;                      /*!< Memory to read from */
@@ -461,6 +526,10 @@ typedef struct gsm_msg {
             size_t etr;                         /*!< Entries to read (array length) */
             size_t ei;                          /*!< Current entry index in array */
             size_t* er;                         /*!< Final entries read pointer for user */
+            size_t cnt;                         /*!< Number of entries read or passed to callback */
+            gsm_sms_list_fn fn;                 /*!< Entry callback function, entries array is single scratch entry when set */
+            void* fn_arg;                       /*!< Custom argument for entry callback function */
+            const char* number;                 /*!< Phone number to filter entries passed to callback, `NULL` for all */
             uint8_t update;                     /*!< Update SMS status after read operation */
             uint8_t format;                     /*!< SMS format, `0 = PDU`, `1 = text` */
             uint8_t read;                       /*!< Read the data flag */
@@ -513,6 +582,7 @@ typedef struct gsm_msg {
             const char* apn;                    /*!< APN address */
             const char* user;                   /*!< APN username */
             const char* pass;                   /*!< APN password */
+            uint8_t gprs_attached;              /*!< GPRS attach state from `+CGATT?` */
         } network_attach;                       /*!< Settings for network attach */
 #endif /* GSM_CFG_NETWORK || __DOXYGEN__ */
     } msg;                                      /*!< Group of different possible message contents */
@@ -560,6 +630,28 @@ typedef struct {
     size_t used;                                /*!< Number of used entries */
 } gsm_sms_mem_t;
 
+#if GSM_CFG_SMS_CONCAT || __DOXYGEN__
+
+/**
+ * \ingroup         GSM_SMS
+ * \brief           Concatenated SMS reassembly slot
+ */
+typedef struct {
+    uint8_t used;                               /*!< Flag indicating slot is in use */
+    char number[26];                            /*!< Phone number of sender */
+    uint16_t ref;                               /*!< Reference number of message */
+    uint8_t total;                              /*!< Number of parts of message */
+    uint8_t received;                           /*!< Number of parts received so far */
+    gsm_sms_dcs_t dcs;                          /*!< Data coding scheme of message */
+    gsm_mem_t mem;                              /*!< Memory of message parts */
+    char* data[GSM_CFG_SMS_CONCAT_MAX_PARTS];   /*!< Data of received parts, `NULL` for missing part */
+    size_t len[GSM_CFG_SMS_CONCAT_MAX_PARTS];   /*!< Length of received parts */
+    size_t pos[GSM_CFG_SMS_CONCAT_MAX_PARTS];   /*!< Positions in memory of received parts */
+    uint32_t time;                              /*!< Time when last part was received */
+} gsm_sms_concat_t;
+
+#endif /* GSM_CFG_SMS_CONCAT || __DOXYGEN__ */
+
 /**
  * \ingroup         GSM_SMS
  * \brief           SMS structure
@@ -569,6 +661,32 @@ typedef struct {
     uint8_t enabled;                            /*!< Flag indicating feature enabled */
 
     gsm_sms_mem_t mem[3];                       /*!< 3 memory info for operation,receive,sent storage */
+    uint8_t mem_valid;                          /*!< Flag indicating current memories match modem state */
+    uint8_t format;                             /*!< Last applied message format, `1` for text, `0` for PDU mode */
+    uint8_t format_valid;                       /*!< Flag indicating `format` matches modem state */
+#if GSM_CFG_SMS_PDU || __DOXYGEN__
+    uint8_t pdu[GSM_SMS_PDU_MAX_LEN];           /*!< Received PDU of message currently read */
+    size_t pdu_len;                             /*!< Number of bytes in received PDU */
+    uint8_t pdu_hex;                            /*!< Set to `1` when first hex character of next byte is received */
+#endif /* GSM_CFG_SMS_PDU || __DOXYGEN__ */
+#if GSM_CFG_SMS_CONCAT || __DOXYGEN__
+    uint16_t concat_ref;                        /*!< Reference number of last sent concatenated message */
+    gsm_sms_concat_t concat[GSM_CFG_SMS_CONCAT_MAX_MSGS];   /*!< Concatenated messages being reassembled */
+#endif /* GSM_CFG_SMS_CONCAT || __DOXYGEN__ */
+#if GSM_CFG_SMS_DIRECT || __DOXYGEN__
+    gsm_sms_entry_t direct;                     /*!< Message received with `+CMT` */
+    uint8_t direct_read;                        /*!< Set to `1` when message data of `+CMT` is expected in next line */
+    uint8_t direct_format;                      /*!< Format of `+CMT` message data, `1` for text, `0` for PDU mode */
+#endif /* GSM_CFG_SMS_DIRECT || __DOXYGEN__ */
+#if GSM_CFG_SMS_DRAIN || __DOXYGEN__
+    gsm_sms_entry_t drain;                      /*!< Entry used by storage drainer for every listed message */
+    size_t drain_pos[GSM_CFG_SMS_DRAIN_MAX_MSGS];   /*!< Positions of messages reported by current drain, deleted after list */
+    size_t drain_cnt;                           /*!< Number of valid entries in \ref drain_pos */
+    size_t drain_del;                           /*!< Index in \ref drain_pos of message being deleted */
+    uint8_t drain_pending;                      /*!< Flag indicating drain was started in background and did not finish yet */
+    uint8_t drain_rerun;                        /*!< Set to `1` when drain must start again after current one,
+                                                    because new message was received or not all messages were reported */
+#endif /* GSM_CFG_SMS_DRAIN || __DOXYGEN__ */
 } gsm_sms_t;
 
 /**
@@ -582,6 +700,25 @@ typedef struct {
     size_t used;                                /*!< Number of used entries */
 } gsm_pb_mem_t;
 
+#if GSM_CFG_PHONEBOOK_CACHE || __DOXYGEN__
+
+/**
+ * \ingroup         GSM_PB
+ * \brief           Phonebook mirror in RAM
+ */
+typedef struct {
+    uint8_t valid;                              /*!< Flag indicating mirror is loaded from device */
+    uint8_t complete;                           /*!< Flag indicating all entries of memory are in mirror */
+    gsm_mem_t mem;                              /*!< Mirrored memory */
+    size_t count;                               /*!< Number of valid entries */
+    gsm_pb_entry_t entries[GSM_CFG_PHONEBOOK_CACHE_SIZE];   /*!< Entries, in no particular order */
+    uint16_t hash[GSM_CFG_PHONEBOOK_CACHE_SIZE];    /*!< First entry of number hash bucket, index plus one or `0` when empty */
+    uint16_t next[GSM_CFG_PHONEBOOK_CACHE_SIZE];    /*!< Next entry in same hash bucket, index plus one or `0` for last */
+    uint16_t name_idx[GSM_CFG_PHONEBOOK_CACHE_SIZE];/*!< Entry indexes sorted by name */
+} gsm_pb_cache_t;
+
+#endif /* GSM_CFG_PHONEBOOK_CACHE || __DOXYGEN__ */
+
 /**
  * \ingroup         GSM_PB
  * \brief           Phonebook structure
@@ -591,6 +728,10 @@ typedef struct {
     uint8_t enabled;                            /*!< Flag indicating feature enabled */
 
     gsm_pb_mem_t mem;                           /*!< Memory information */
+    uint8_t mem_valid;                          /*!< Flag indicating current memory matches modem state */
+#if GSM_CFG_PHONEBOOK_CACHE || __DOXYGEN__
+    gsm_pb_cache_t cache;                       /*!< Phonebook mirror */
+#endif /* GSM_CFG_PHONEBOOK_CACHE || __DOXYGEN__ */
 } gsm_pb_t;
 
 /**
@@ -600,6 +741,19 @@ typedef struct {
     gsm_sim_state_t state;                      /*!< Current SIM status */
 } gsm_sim_t;
 
+/**
+ * \brief           TCP/IP stack state reported by `+CIPSTATUS`
+ */
+typedef enum {
+    GSM_IP_STATE_UNKNOWN = 0x00,                /*!< State not known yet */
+    GSM_IP_STATE_INITIAL,                       /*!< `IP INITIAL`, stack shut */
+    GSM_IP_STATE_START,                         /*!< `IP START`, APN is set */
+    GSM_IP_STATE_CONFIG,                        /*!< `IP CONFIG`, bearer activation in progress */
+    GSM_IP_STATE_GPRSACT,                       /*!< `IP GPRSACT`, bearer is active */
+    GSM_IP_STATE_READY,                         /*!< `IP STATUS` or any connection state, local IP is known */
+    GSM_IP_STATE_PDP_DEACT,                     /*!< `PDP DEACT`, bearer lost */
+} gsm_ip_state_t;
+
 /**
  * \brief           Network info
  */
@@ -609,8 +763,37 @@ typedef struct {
 
     uint8_t is_attached;                        /*!< Flag indicating device is attached and PDP context is active */
     gsm_ip_t ip_addr;                           /*!< Device IP address when network PDP context is enabled */
+    gsm_ip_state_t ip_state;                    /*!< TCP/IP stack state */
+    uint32_t apn_hash;                          /*!< Hash of APN settings of active bearer */
+    uint8_t apn_valid;                          /*!< Flag indicating bearer was brought up with settings in \ref apn_hash */
+#if GSM_CFG_NETWORK_TRACKER || __DOXYGEN__
+    gsm_network_reg_status_t gprs_status;       /*!< GPRS network registration status */
+    uint32_t lac;                               /*!< Location area code of serving cell */
+    uint32_t ci;                                /*!< Cell ID of serving cell */
+#endif /* GSM_CFG_NETWORK_TRACKER || __DOXYGEN__ */
 } gsm_network_t;
 
+#if GSM_CFG_NETWORK_TRACKER || __DOXYGEN__
+
+/**
+ * \brief           Network state tracker
+ *
+ * Lives outside \ref gsm_modules_t to keep counters and attach request over device reset
+ */
+typedef struct {
+    gsm_network_state_t state;                  /*!< Last published state */
+    uint8_t want_attached;                      /*!< Flag indicating application requested attach */
+    const char* apn;                            /*!< APN used for automatic re-attach */
+    const char* user;                           /*!< User name used for automatic re-attach */
+    const char* pass;                           /*!< Password used for automatic re-attach */
+    uint32_t backoff;                           /*!< Current re-attach backoff in units of milliseconds */
+    uint8_t scheduled;                          /*!< Flag indicating re-attach timeout is scheduled */
+    uint8_t busy;                               /*!< Flag indicating re-attach command is in progress */
+    uint32_t seed;                              /*!< Pseudo random generator state for jitter */
+} gsm_network_tracker_t;
+
+#endif /* GSM_CFG_NETWORK_TRACKER || __DOXYGEN__ */
+
 /**
  * \brief           GSM modules structure
  */
@@ -668,6 +851,18 @@ typedef struct {
     gsm_evt_func_t*     evt_func;               /*!< Callback function linked list */
 
     gsm_modules_t       m;                      /*!< All modules. When resetting, reset structure */
+#if GSM_CFG_BATCH || __DOXYGEN__
+    gsm_msg_t*          batch;                  /*!< Batch currently collecting messages */
+#endif /* GSM_CFG_BATCH || __DOXYGEN__ */
+#if GSM_CFG_NETWORK_TRACKER || __DOXYGEN__
+    gsm_network_tracker_t network_tracker;      /*!< Network state tracker */
+#endif /* GSM_CFG_NETWORK_TRACKER || __DOXYGEN__ */
+#if GSM_CFG_WARM_START || __DOXYGEN__
+    struct {
+        gsm_device_profile_load_fn load_fn;     /*!< Callback to load profile from user storage */
+        gsm_device_profile_save_fn save_fn;     /*!< Callback to save profile to user storage */
+    } profile;                                  /*!< Warm start profile storage */
+#endif /* GSM_CFG_WARM_START || __DOXYGEN__ */
 
     union {
         struct {
@@ -788,7 +983,27 @@ void        gsmi_conn_start_timeout(gsm_conn_p conn);
 gsmr_t      gsmi_get_sim_info(const uint32_t blocking);
 
 void        gsmi_reset_everything(uint8_t forced);
+#if GSM_CFG_SMS && GSM_CFG_SMS_PDU
+size_t      gsmi_sms_pdu_send(const char* num, const void* data, size_t len, gsm_sms_dcs_t dcs,
+                                const uint8_t* udh, size_t udh_len, void (*out_fn)(uint8_t octet));
+#endif /* GSM_CFG_SMS && GSM_CFG_SMS_PDU */
+#if GSM_CFG_SMS_DRAIN
+void        gsmi_sms_drain_entry(gsm_sms_entry_t* entry, void* arg);
+#endif /* GSM_CFG_SMS_DRAIN */
+#if GSM_CFG_NETWORK_TRACKER
+void        gsmi_network_tracker_update(void);
+#endif /* GSM_CFG_NETWORK_TRACKER */
+#if GSM_CFG_PHONEBOOK_CACHE
+void        gsmi_pb_cache_loaded(size_t count);
+void        gsmi_pb_cache_write(gsm_mem_t mem, size_t pos, const char* name, const char* num, gsm_number_type_t type, uint8_t del);
+size_t      gsmi_pb_cache_get_free_pos(gsm_mem_t mem);
+const gsm_pb_entry_t*   gsmi_pb_cache_find_number(const char* num);
+#endif /* GSM_CFG_PHONEBOOK_CACHE */
 void        gsmi_process_events_for_timeout_or_error(gsm_msg_t* msg, gsmr_t err);
+void        gsmi_msg_complete(gsm_msg_t* msg);
+#if GSM_CFG_CMD_COALESCE
+void        gsmi_cmd_coalesce_done(gsm_msg_t* msg);
+#endif /* GSM_CFG_CMD_COALESCE */
 
 /**
  * \}
@@ -51,11 +51,22 @@ gsmr_t      gsm_sms_enable(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg,
 gsmr_t      gsm_sms_disable(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 
 gsmr_t      gsm_sms_send(const char* num, const char* text, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t      gsm_sms_send_batch(gsm_sms_batch_entry_t* entries, size_t count, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#if GSM_CFG_SMS_PDU || __DOXYGEN__
+gsmr_t      gsm_sms_send_data(const char* num, const void* data, size_t len, gsm_sms_dcs_t dcs, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#endif /* GSM_CFG_SMS_PDU || __DOXYGEN__ */
 gsmr_t      gsm_sms_read(gsm_mem_t mem, size_t pos, gsm_sms_entry_t* entry, uint8_t update, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t      gsm_sms_delete(gsm_mem_t mem, size_t pos, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t      gsm_sms_delete_all(gsm_sms_status_t status, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t      gsm_sms_list(gsm_mem_t mem, gsm_sms_status_t stat, gsm_sms_entry_t* entries, size_t etr, size_t* er, uint8_t update, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t      gsm_sms_list_cb(gsm_mem_t mem, gsm_sms_status_t stat, const char* number, gsm_sms_entry_t* entry, gsm_sms_list_fn fn, void* fn_arg, size_t* er, uint8_t update, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#if GSM_CFG_SMS_DRAIN || __DOXYGEN__
+gsmr_t      gsm_sms_drain(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#endif /* GSM_CFG_SMS_DRAIN || __DOXYGEN__ */
 gsmr_t      gsm_sms_set_preferred_storage(gsm_mem_t mem1, gsm_mem_t mem2, gsm_mem_t mem3, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#if GSM_CFG_SMS_DIRECT || __DOXYGEN__
+gsmr_t      gsm_sms_ack(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#endif /* GSM_CFG_SMS_DIRECT || __DOXYGEN__ */
 
 /**
  * \}
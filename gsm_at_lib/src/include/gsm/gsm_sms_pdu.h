@@ -0,0 +1,88 @@
+/**
+ * \file            gsm_sms_pdu.h
+ * \brief           SMS PDU codec
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef GSM_HDR_SMS_PDU_H
+#define GSM_HDR_SMS_PDU_H
+
+#include "gsm/gsm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         GSM_SMS
+ * \defgroup        GSM_SMS_PDU PDU codec
+ * \brief           SMS PDU encoder and decoder
+ * \{
+ *
+ * Codec encodes `SMS-SUBMIT` and decodes `SMS-DELIVER` and `SMS-SUBMIT` transfer protocol data units.
+ * Text is converted between UTF-8 and GSM 03.38 default alphabet (with extension table) or UCS2.
+ *
+ * Encoded PDU always starts with empty service center address,
+ * so service center stored on SIM card is used.
+ *
+ * Long data can be split to parts, each sent with concatenation user data header
+ * built with \ref gsm_sms_pdu_concat_udh. Parts never split GSM escape sequence or UCS2 surrogate pair.
+ */
+
+#define GSM_SMS_PDU_MAX_LEN             176 /*!< Maximal length of PDU, including service center address */
+#define GSM_SMS_PDU_GSM7_MAX_LEN        160 /*!< Maximal number of septets in single message with GSM 7-bit alphabet */
+#define GSM_SMS_PDU_UD_MAX_LEN          140 /*!< Maximal number of user data bytes in single message */
+#define GSM_SMS_PDU_CONCAT_UDH_MAX_LEN  6   /*!< Maximal length of concatenation user data header, without header length byte */
+#define GSM_SMS_PDU_CONCAT_UDH_LEN(ref16)   ((ref16) ? 6 : 5)   /*!< Length of concatenation user data header for 8-bit or 16-bit reference */
+
+gsm_sms_dcs_t   gsm_sms_pdu_get_dcs(const char* text, size_t len);
+
+size_t          gsm_sms_pdu_gsm7_encode(const char* text, size_t len, uint8_t fill_bits, uint8_t* out, size_t out_size, size_t* septets);
+size_t          gsm_sms_pdu_gsm7_decode(const uint8_t* data, size_t data_len, size_t septets, uint8_t fill_bits, char* out, size_t out_size);
+size_t          gsm_sms_pdu_ucs2_encode(const char* text, size_t len, uint8_t* out, size_t out_size);
+size_t          gsm_sms_pdu_ucs2_decode(const uint8_t* data, size_t len, char* out, size_t out_size);
+
+size_t          gsm_sms_pdu_encode(const char* num, const void* data, size_t len, gsm_sms_dcs_t dcs,
+                                    const uint8_t* udh, size_t udh_len, uint8_t* pdu, size_t pdu_size);
+gsmr_t          gsm_sms_pdu_decode(const uint8_t* pdu, size_t len, gsm_sms_entry_t* entry);
+
+size_t          gsm_sms_pdu_concat_udh(uint8_t* udh, uint16_t ref, uint8_t total, uint8_t seq, uint8_t ref16);
+size_t          gsm_sms_pdu_get_part_len(const void* data, size_t len, gsm_sms_dcs_t dcs, size_t udh_len);
+size_t          gsm_sms_pdu_get_parts(const void* data, size_t len, gsm_sms_dcs_t dcs, size_t udh_len);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* GSM_HDR_SMS_PDU_H */
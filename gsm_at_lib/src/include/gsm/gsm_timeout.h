@@ -49,6 +49,7 @@ extern "C" {
 
 gsmr_t          gsm_timeout_add(uint32_t time, gsm_timeout_fn fn, void* arg);
 gsmr_t          gsm_timeout_remove(gsm_timeout_fn fn);
+gsmr_t          gsm_timeout_remove_with_arg(gsm_timeout_fn fn, void* arg);
 
 /**
  * \}
@@ -186,6 +186,16 @@ typedef enum {
     GSM_SMS_STATUS_INBOX,                       /*!< SMS status, used only for mass delete operation */
 } gsm_sms_status_t;
 
+/**
+ * \ingroup         GSM_SMS
+ * \brief           SMS data coding scheme, alphabet used for user data in PDU mode
+ */
+typedef enum {
+    GSM_SMS_DCS_GSM7 = 0x00,                    /*!< GSM 03.38 default alphabet, packed to 7 bits per character */
+    GSM_SMS_DCS_8BIT = 0x04,                    /*!< Binary data, 8 bits per byte */
+    GSM_SMS_DCS_UCS2 = 0x08,                    /*!< UCS2 (UTF-16 big endian) characters */
+} gsm_sms_dcs_t;
+
 /**
  * \ingroup         GSM_SMS
  * \brief           SMS entry structure
@@ -197,10 +207,38 @@ typedef struct {
     gsm_sms_status_t status;                    /*!< Message status */
     char number[26];                            /*!< Phone number */
     char name[20];                              /*!< Name in phonebook if exists */
+#if GSM_CFG_SMS_PDU || __DOXYGEN__
+    gsm_sms_dcs_t dcs;                          /*!< Data coding scheme of received message */
+    char data[321];                             /*!< Data memory. Text messages are decoded to UTF-8,
+                                                    binary messages are stored as received */
+    uint16_t concat_ref;                        /*!< Reference number of concatenated message */
+    uint8_t concat_total;                       /*!< Number of parts of concatenated message or `0` if message is not concatenated */
+    uint8_t concat_seq;                         /*!< Part sequence number of concatenated message, starting with `1` */
+#else /* GSM_CFG_SMS_PDU || __DOXYGEN__ */
     char data[161];                             /*!< Data memory */
+#endif /* !(GSM_CFG_SMS_PDU || __DOXYGEN__) */
     size_t length;                              /*!< Length of SMS data */
 } gsm_sms_entry_t;
 
+/**
+ * \ingroup         GSM_SMS
+ * \brief           SMS batch send entry
+ */
+typedef struct {
+    const char* num;                            /*!< Phone number */
+    const char* text;                           /*!< Text to send */
+    gsmr_t res;                                 /*!< Send result, set by library */
+    size_t pos;                                 /*!< Position in memory of sent message, set by library on success */
+} gsm_sms_batch_entry_t;
+
+/**
+ * \ingroup         GSM_SMS
+ * \brief           Function declaration for SMS list entry callback
+ * \param[in]       entry: Listed SMS entry, valid only until function returns
+ * \param[in]       arg: Custom user argument
+ */
+typedef void (*gsm_sms_list_fn)(gsm_sms_entry_t* entry, void* arg);
+
 /**
  * \ingroup         GSM_PB
  * \brief           Phonebook entry structure
@@ -285,6 +323,33 @@ typedef enum {
     GSM_NETWORK_REG_STATUS_CONNECTED_ROAMING_SMS_ONLY = 0x07/*!< Device is roaming in SMS-only mode */
 } gsm_network_reg_status_t;
 
+#if GSM_CFG_NETWORK_TRACKER || __DOXYGEN__
+
+/**
+ * \ingroup         GSM_NETWORK
+ * \brief           Network registration and bearer state, maintained by tracker
+ *
+ * Data connectivity is up when device is registered (`+CREG` or `+CGREG`) and PDP context is active.
+ * Outage is period between data connectivity going down and coming up again
+ */
+typedef struct {
+    gsm_network_reg_status_t reg_status;        /*!< Circuit switched registration status from `+CREG` */
+    gsm_network_reg_status_t gprs_status;       /*!< Packet switched registration status from `+CGREG` */
+    uint32_t lac;                               /*!< Location area code of serving cell */
+    uint32_t ci;                                /*!< Cell ID of serving cell */
+    uint8_t is_attached;                        /*!< Flag indicating PDP context is active */
+    uint8_t is_up;                              /*!< Flag indicating data connectivity is up */
+    uint8_t in_outage;                          /*!< Flag indicating outage is in progress */
+    uint32_t last_change;                       /*!< Time of last state change in units of milliseconds */
+    uint32_t outage_start;                      /*!< Time when current or last outage started in units of milliseconds */
+    uint32_t outage_cnt;                        /*!< Number of outages since library init */
+    uint32_t outage_last;                       /*!< Duration of last finished outage in units of milliseconds */
+    uint32_t outage_total;                      /*!< Total duration of finished outages in units of milliseconds */
+    uint32_t reattach_cnt;                      /*!< Number of automatic re-attach attempts */
+} gsm_network_state_t;
+
+#endif /* GSM_CFG_NETWORK_TRACKER || __DOXYGEN__ */
+
 /**
  * \ingroup         GSM_CALL
  * \brief           List of call directions
@@ -391,6 +456,9 @@ typedef enum gsm_cb_type_t {
     GSM_EVT_NETWORK_ATTACHED,                   /*!< Attached to network, PDP context active and ready for TCP/IP application */
     GSM_EVT_NETWORK_DETACHED,                   /*!< Detached from network, PDP context not active anymore */
 #endif /* GSM_CFG_NETWORK || __DOXYGEN__ */
+#if GSM_CFG_NETWORK_TRACKER || __DOXYGEN__
+    GSM_EVT_NETWORK_STATE,                      /*!< Network registration or bearer state changed */
+#endif /* GSM_CFG_NETWORK_TRACKER || __DOXYGEN__ */
 
 #if GSM_CFG_CONN || __DOXYGEN__
     GSM_EVT_CONN_RECV,                          /*!< Connection data received */
@@ -405,10 +473,20 @@ typedef enum gsm_cb_type_t {
     GSM_EVT_SMS_ENABLE,                         /*!< SMS enable event */
     GSM_EVT_SMS_READY,                          /*!< SMS ready event */
     GSM_EVT_SMS_SEND,                           /*!< SMS send event */
+    GSM_EVT_SMS_SEND_BATCH,                     /*!< Single SMS of batch send operation has been processed */
     GSM_EVT_SMS_RECV,                           /*!< SMS received */
     GSM_EVT_SMS_READ,                           /*!< SMS read */
     GSM_EVT_SMS_DELETE,                         /*!< SMS delete */
     GSM_EVT_SMS_LIST,                           /*!< SMS list */
+#if GSM_CFG_SMS_CONCAT || __DOXYGEN__
+    GSM_EVT_SMS_CONCAT_RECV,                    /*!< All parts of concatenated SMS received */
+#endif /* GSM_CFG_SMS_CONCAT || __DOXYGEN__ */
+#if GSM_CFG_SMS_DIRECT || __DOXYGEN__
+    GSM_EVT_SMS_DELIVER,                        /*!< SMS received directly with `+CMT`, not stored in memory */
+#endif /* GSM_CFG_SMS_DIRECT || __DOXYGEN__ */
+#if GSM_CFG_SMS_DRAIN || __DOXYGEN__
+    GSM_EVT_SMS_DRAIN,                          /*!< Unread SMS listed by storage drainer, deleted after drain finishes */
+#endif /* GSM_CFG_SMS_DRAIN || __DOXYGEN__ */
 #endif /* GSM_CFG_SMS || __DOXYGEN__ */
 #if GSM_CFG_CALL || __DOXYGEN__
     GSM_EVT_CALL_ENABLE,                        /*!< Call enable event */
@@ -445,6 +523,11 @@ typedef struct gsm_evt {
         struct {
             const gsm_operator_curr_t* operator_current;    /*!< Current operator info */
         } operator_current;                     /*!< Current operator event. Use with \ref GSM_EVT_NETWORK_OPERATOR_CURRENT event */
+#if GSM_CFG_NETWORK_TRACKER || __DOXYGEN__
+        struct {
+            const gsm_network_state_t* state;   /*!< New network state */
+        } network_state;                        /*!< Network state changed. Use with \ref GSM_EVT_NETWORK_STATE event */
+#endif /* GSM_CFG_NETWORK_TRACKER || __DOXYGEN__ */
         struct {
             gsm_operator_t* ops;                /*!< Pointer to operators */
             size_t opf;                         /*!< Number of operators found */
@@ -491,6 +574,10 @@ typedef struct gsm_evt {
             size_t pos;                         /*!< Position in memory */
             gsmr_t res;                         /*!< SMS send result information */
         } sms_send;                             /*!< SMS sent info. Use with \ref GSM_EVT_SMS_SEND event */
+        struct {
+            gsm_sms_batch_entry_t* entry;       /*!< Processed entry, with result and position set */
+            size_t index;                       /*!< Index of entry in batch array */
+        } sms_send_batch;                       /*!< SMS batch send progress. Use with \ref GSM_EVT_SMS_SEND_BATCH event */
         struct {
             gsm_mem_t mem;                      /*!< Memory of received message */
             size_t pos;                         /*!< Received position in memory for sent SMS */
@@ -507,9 +594,30 @@ typedef struct gsm_evt {
         struct {
             gsm_mem_t mem;                      /*!< Memory used for scan */
             gsm_sms_entry_t* entries;           /*!< Pointer to entries */
-            size_t size;                        /*!< Number of valid entries */
+            size_t size;                        /*!< Number of valid entries, `0` when entries are passed to list callback */
             gsmr_t res;                         /*!< Result on command */
         } sms_list;                             /*!< SMS list. Use with \ref GSM_EVT_SMS_LIST event */
+#if GSM_CFG_SMS_CONCAT || __DOXYGEN__
+        struct {
+            const char* number;                 /*!< Phone number of sender */
+            const char* data;                   /*!< Message data, `NULL` terminated. Text is UTF-8 encoded */
+            size_t len;                         /*!< Length of message data in units of bytes */
+            gsm_sms_dcs_t dcs;                  /*!< Data coding scheme */
+            gsm_mem_t mem;                      /*!< Memory of message parts */
+            const size_t* pos;                  /*!< Positions in memory of message parts, in sequence order */
+            uint8_t parts;                      /*!< Number of message parts */
+        } sms_concat_recv;                      /*!< Concatenated SMS received. Use with \ref GSM_EVT_SMS_CONCAT_RECV event */
+#endif /* GSM_CFG_SMS_CONCAT || __DOXYGEN__ */
+#if GSM_CFG_SMS_DIRECT || __DOXYGEN__
+        struct {
+            gsm_sms_entry_t* entry;             /*!< Received SMS entry, memory and position are not valid */
+        } sms_deliver;                          /*!< SMS received directly. Use with \ref GSM_EVT_SMS_DELIVER event */
+#endif /* GSM_CFG_SMS_DIRECT || __DOXYGEN__ */
+#if GSM_CFG_SMS_DRAIN || __DOXYGEN__
+        struct {
+            gsm_sms_entry_t* entry;             /*!< Listed SMS entry */
+        } sms_drain;                            /*!< SMS listed by storage drainer. Use with \ref GSM_EVT_SMS_DRAIN event */
+#endif /* GSM_CFG_SMS_DRAIN || __DOXYGEN__ */
 #endif /* GSM_CFG_SMS || __DOXYGEN__ */
 #if GSM_CFG_CALL || __DOXYGEN__
         struct {
@@ -574,6 +682,41 @@ typedef struct {
     } uart;                                     /*!< UART communication parameters */
 } gsm_ll_t;
 
+#if GSM_CFG_WARM_START || __DOXYGEN__
+
+#define GSM_DEVICE_PROFILE_VERSION              1   /*!< Version of \ref gsm_device_profile_t layout */
+
+/**
+ * \ingroup         GSM_DEVICE_INFO
+ * \brief           Device profile kept by user over resets for warm start
+ */
+typedef struct {
+    uint32_t version;                           /*!< Profile version. Set to \ref GSM_DEVICE_PROFILE_VERSION when valid */
+    char model_manufacturer[20];                /*!< Device manufacturer */
+    char model_number[20];                      /*!< Device model number */
+    char model_serial_number[20];               /*!< Device serial number, used to check for same device */
+    char model_revision[20];                    /*!< Device revision */
+    gsm_device_model_t model;                   /*!< Device model */
+} gsm_device_profile_t;
+
+/**
+ * \ingroup         GSM_DEVICE_INFO
+ * \brief           Function prototype to load device profile from user storage
+ * \param[out]      profile: Pointer to profile to fill
+ * \return          `1` when profile was loaded, `0` otherwise
+ */
+typedef uint8_t (*gsm_device_profile_load_fn)(gsm_device_profile_t* profile);
+
+/**
+ * \ingroup         GSM_DEVICE_INFO
+ * \brief           Function prototype to save device profile to user storage
+ * \param[in]       profile: Pointer to profile to save
+ * \return          `1` when profile was saved, `0` otherwise
+ */
+typedef uint8_t (*gsm_device_profile_save_fn)(const gsm_device_profile_t* profile);
+
+#endif /* GSM_CFG_WARM_START || __DOXYGEN__ */
+
 /**
  * \ingroup         GSM_TIMEOUT
  * \brief           Timeout callback function prototype
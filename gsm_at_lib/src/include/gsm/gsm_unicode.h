@@ -48,6 +48,8 @@ extern "C" {
  */
 
 gsmr_t          gsmi_unicode_decode(gsm_unicode_t* uni, uint8_t ch);
+uint32_t        gsmi_unicode_get_code_point(const gsm_unicode_t* uni);
+size_t          gsmi_unicode_encode(uint32_t cp, char* out);
 
 /**
  * \}
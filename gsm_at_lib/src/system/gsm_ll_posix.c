@@ -0,0 +1,392 @@
+/**
+ * \file            gsm_ll_posix.c
+ * \brief           Low-level communication with GSM device for POSIX serial ports
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+
+/*
+ * How it works
+ *
+ * On first call to \ref gsm_ll_init, serial device (tty or pty) is opened in raw mode
+ * and new thread is created to receive data. Thread blocks in `poll` until data are available
+ * and reads them in large blocks, which are sent to upper layer with single call.
+ *
+ * Data to transmit are accumulated in local buffer until stack requests flush with `(NULL, 0)`,
+ * or until next fragment does not fit anymore. Buffer and fragment are then written with single `writev`.
+ *
+ * Device is selected with `GSM_AT_PORT` environment variable or \ref GSM_LL_POSIX_DEV when not set.
+ * Optional hardware reset is done by toggling modem control line, selected with \ref GSM_LL_POSIX_RESET_LINE.
+ */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif /* _DEFAULT_SOURCE */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include "gsm/gsm.h"
+#include "gsm/gsm_mem.h"
+#include "gsm/gsm_input.h"
+#include "system/gsm_ll.h"
+
+#if !__DOXYGEN__
+
+#if !defined(GSM_LL_POSIX_DEV)
+#define GSM_LL_POSIX_DEV                "/dev/ttyUSB0"
+#endif /* !defined(GSM_LL_POSIX_DEV) */
+
+/* Set to `1` to enable RTS/CTS hardware flow control */
+#if !defined(GSM_LL_POSIX_RTSCTS)
+#define GSM_LL_POSIX_RTSCTS             0
+#endif /* !defined(GSM_LL_POSIX_RTSCTS) */
+
+/* Modem control line connected to reset pin, `TIOCM_RTS` or `TIOCM_DTR`. Set to `0` when not used */
+#if !defined(GSM_LL_POSIX_RESET_LINE)
+#define GSM_LL_POSIX_RESET_LINE         0
+#endif /* !defined(GSM_LL_POSIX_RESET_LINE) */
+
+#if !defined(GSM_LL_POSIX_RX_BUFF_SIZE)
+#define GSM_LL_POSIX_RX_BUFF_SIZE       0x1000
+#endif /* !defined(GSM_LL_POSIX_RX_BUFF_SIZE) */
+
+#if !defined(GSM_LL_POSIX_TX_BUFF_SIZE)
+#define GSM_LL_POSIX_TX_BUFF_SIZE       0x400
+#endif /* !defined(GSM_LL_POSIX_TX_BUFF_SIZE) */
+
+#if !defined(GSM_MEM_SIZE)
+#define GSM_MEM_SIZE                    0x10000
+#endif /* !defined(GSM_MEM_SIZE) */
+
+static uint8_t      initialized;
+static int          dev_fd = -1;                /*!< Serial device file descriptor */
+static int          wake_fd[2] = { -1, -1 };    /*!< Pipe to wake up receive thread on deinit */
+static pthread_t    rx_thread;
+static uint8_t      rx_buff[GSM_LL_POSIX_RX_BUFF_SIZE];
+static uint8_t      tx_buff[GSM_LL_POSIX_TX_BUFF_SIZE];
+static size_t       tx_len;
+
+/**
+ * \brief           Write all data from vector to device
+ * \param[in]       iov: Vector of data to write, modified during write
+ * \param[in]       cnt: Number of entries in vector
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+write_all(struct iovec* iov, int cnt) {
+    ssize_t w;
+
+    while (cnt > 0) {
+        w = writev(dev_fd, iov, cnt);
+        if (w < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        /* Skip fully written entries and advance partially written one */
+        while (cnt > 0 && (size_t)w >= iov->iov_len) {
+            w -= (ssize_t)iov->iov_len;
+            ++iov;
+            --cnt;
+        }
+        if (cnt > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + w;
+            iov->iov_len -= (size_t)w;
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief           Send data to GSM device, function called from GSM stack when we have data to send
+ * \param[in]       data: Pointer to data to send. Set to `NULL` to flush buffered data
+ * \param[in]       len: Number of bytes to send
+ * \return          Number of bytes sent
+ */
+static size_t
+send_data(const void* data, size_t len) {
+    struct iovec iov[2];
+    int cnt = 0;
+
+    if (dev_fd < 0) {
+        return 0;
+    }
+
+    /* Small fragments are copied as they may live on caller stack */
+    if (data != NULL && len > 0 && tx_len + len <= sizeof(tx_buff)) {
+        memcpy(&tx_buff[tx_len], data, len);
+        tx_len += len;
+        return len;
+    }
+
+    /* Flush request or fragment does not fit, write everything at once */
+    if (tx_len > 0) {
+        iov[cnt].iov_base = tx_buff;
+        iov[cnt].iov_len = tx_len;
+        ++cnt;
+    }
+    if (data != NULL && len > 0) {
+        iov[cnt].iov_base = (void *)data;
+        iov[cnt].iov_len = len;
+        ++cnt;
+    }
+    tx_len = 0;
+    if (cnt > 0 && !write_all(iov, cnt)) {
+        return 0;
+    }
+    return len;
+}
+
+#if GSM_LL_POSIX_RESET_LINE
+/**
+ * \brief           Hardware reset callback
+ * \param[in]       state: `1` to assert reset line, `0` to release it
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+reset_device(uint8_t state) {
+    int line = GSM_LL_POSIX_RESET_LINE;
+
+    return ioctl(dev_fd, state ? TIOCMBIS : TIOCMBIC, &line) == 0;
+}
+#endif /* GSM_LL_POSIX_RESET_LINE */
+
+/**
+ * \brief           Get termios speed for baudrate
+ * \param[in]       baudrate: Baudrate in units of bits per second
+ * \return          Speed value or `B0` if baudrate is not supported
+ */
+static speed_t
+get_speed(uint32_t baudrate) {
+    static const struct {
+        uint32_t baudrate;
+        speed_t speed;
+    } speeds[] = {
+        { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 },
+        { 57600, B57600 }, { 115200, B115200 }, { 230400, B230400 },
+#if defined(B460800)
+        { 460800, B460800 },
+#endif /* defined(B460800) */
+#if defined(B921600)
+        { 921600, B921600 },
+#endif /* defined(B921600) */
+    };
+
+    for (size_t i = 0; i < GSM_ARRAYSIZE(speeds); ++i) {
+        if (speeds[i].baudrate == baudrate) {
+            return speeds[i].speed;
+        }
+    }
+    return B0;
+}
+
+/**
+ * \brief           Configure serial port in raw mode with selected baudrate
+ * \param[in]       baudrate: Baudrate in units of bits per second
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+configure_uart(uint32_t baudrate) {
+    struct termios tio;
+    speed_t speed;
+
+    if ((speed = get_speed(baudrate)) == B0 || tcgetattr(dev_fd, &tio) != 0) {
+        return 0;
+    }
+
+    /* Raw mode, 8N1, no software flow control */
+    tio.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON | IXOFF | IXANY);
+    tio.c_oflag &= ~OPOST;
+    tio.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+    tio.c_cflag &= ~(CSIZE | PARENB | CSTOPB);
+    tio.c_cflag |= CS8 | CREAD | CLOCAL;
+#if defined(CRTSCTS)
+#if GSM_LL_POSIX_RTSCTS
+    tio.c_cflag |= CRTSCTS;
+#else /* GSM_LL_POSIX_RTSCTS */
+    tio.c_cflag &= ~CRTSCTS;
+#endif /* !GSM_LL_POSIX_RTSCTS */
+#endif /* defined(CRTSCTS) */
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+
+    tcdrain(dev_fd);                            /* Send pending data with old baudrate */
+    return tcsetattr(dev_fd, TCSANOW, &tio) == 0;
+}
+
+/**
+ * \brief           Receive thread
+ * \param[in]       arg: Thread argument, not used
+ */
+static void*
+rx_thread_fn(void* arg) {
+    struct pollfd fds[2];
+    ssize_t len;
+
+    GSM_UNUSED(arg);
+
+    fds[0].fd = dev_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wake_fd[0];
+    fds[1].events = POLLIN;
+    while (1) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents != 0) {              /* Deinit requested */
+            break;
+        }
+        if (fds[0].revents & (POLLERR | POLLNVAL)) {
+            break;
+        }
+        if (fds[0].revents & (POLLIN | POLLHUP)) {
+            len = read(dev_fd, rx_buff, sizeof(rx_buff));
+            if (len > 0) {
+#if GSM_CFG_INPUT_USE_PROCESS
+                gsm_input_process(rx_buff, (size_t)len);
+#else /* GSM_CFG_INPUT_USE_PROCESS */
+                gsm_input(rx_buff, (size_t)len);
+#endif /* !GSM_CFG_INPUT_USE_PROCESS */
+            } else if (len == 0 || (errno != EINTR && errno != EAGAIN)) {
+                poll(NULL, 0, 10);              /* Other side of pty closed, avoid busy loop */
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Callback function called from initialization process
+ *
+ * \note            This function may be called multiple times if AT baudrate is changed from application.
+ *                  It is important that every configuration except AT baudrate is configured only once!
+ *
+ * \note            This function may be called from different threads in GSM stack when using OS.
+ *                  When \ref GSM_CFG_INPUT_USE_PROCESS is set to 1, this function may be called from user UART thread.
+ *
+ * \param[in,out]   ll: Pointer to \ref gsm_ll_t structure to fill data for communication functions
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_init(gsm_ll_t* ll) {
+#if !GSM_CFG_MEM_CUSTOM
+    static uint8_t memory[GSM_MEM_SIZE];
+    gsm_mem_region_t mem_regions[] = {
+        { memory, sizeof(memory) }
+    };
+
+    if (!initialized) {
+        gsm_mem_assignmemory(mem_regions, GSM_ARRAYSIZE(mem_regions));  /* Assign memory for allocations */
+    }
+#endif /* !GSM_CFG_MEM_CUSTOM */
+
+    if (!initialized) {
+        const char* dev = getenv("GSM_AT_PORT");
+        int line = TIOCM_DTR;
+
+        if (dev == NULL || dev[0] == '\0') {
+            dev = GSM_LL_POSIX_DEV;
+        }
+        if ((dev_fd = open(dev, O_RDWR | O_NOCTTY | O_CLOEXEC)) < 0) {
+            return gsmERR;
+        }
+        ioctl(dev_fd, TIOCMBIS, &line);         /* Assert DTR, fails silently on pty */
+
+        ll->send_fn = send_data;                /* Set callback function to send data */
+#if GSM_LL_POSIX_RESET_LINE
+        ll->reset_fn = reset_device;            /* Set callback for hardware reset */
+#endif /* GSM_LL_POSIX_RESET_LINE */
+    } else {
+        send_data(NULL, 0);                     /* Flush pending data before baudrate change */
+    }
+
+    if (!configure_uart(ll->uart.baudrate)) {   /* Initialize UART for communication */
+        if (!initialized) {
+            close(dev_fd);
+            dev_fd = -1;
+        }
+        return gsmERR;
+    }
+
+    if (!initialized) {
+        if (pipe(wake_fd) != 0) {
+            wake_fd[0] = wake_fd[1] = -1;
+        }
+        if (wake_fd[0] < 0 || pthread_create(&rx_thread, NULL, rx_thread_fn, NULL) != 0) {
+            close(dev_fd);
+            dev_fd = -1;
+            if (wake_fd[0] >= 0) {
+                close(wake_fd[0]);
+                close(wake_fd[1]);
+                wake_fd[0] = wake_fd[1] = -1;
+            }
+            return gsmERR;
+        }
+    }
+    initialized = 1;
+    return gsmOK;
+}
+
+/**
+ * \brief           Callback function to de-init low-level communication part
+ * \param[in,out]   ll: Pointer to \ref gsm_ll_t structure to fill data for communication functions
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_deinit(gsm_ll_t* ll) {
+    GSM_UNUSED(ll);
+
+    if (initialized) {
+        send_data(NULL, 0);
+        if (write(wake_fd[1], "", 1) == 1) {    /* Wake up and stop receive thread */
+            pthread_join(rx_thread, NULL);
+        }
+        close(wake_fd[0]);
+        close(wake_fd[1]);
+        close(dev_fd);
+        wake_fd[0] = wake_fd[1] = dev_fd = -1;
+        initialized = 0;
+    }
+    return gsmOK;
+}
+
+#endif /* !__DOXYGEN__ */
@@ -0,0 +1,512 @@
+/**
+ * \file            gsm_sys_posix.c
+ * \brief           System dependant functions for POSIX compliant systems
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif /* _POSIX_C_SOURCE */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include "system/gsm_sys.h"
+
+#if !__DOXYGEN__
+
+/**
+ * \brief           Mutex implementation, always recursive
+ */
+struct gsm_sys_posix_mutex {
+    pthread_mutex_t mutex;
+};
+
+/**
+ * \brief           Binary semaphore implementation
+ */
+struct gsm_sys_posix_sem {
+    pthread_mutex_t mutex;                      /*!< Mutex protecting count */
+    pthread_cond_t cond;                        /*!< Condition signalled on release */
+    uint8_t cnt;                                /*!< Semaphore count, `0` or `1` */
+    size_t waiters;                             /*!< Number of threads waiting for semaphore */
+};
+
+/**
+ * \brief           Bounded message queue implementation
+ */
+struct gsm_sys_posix_mbox {
+    pthread_mutex_t mutex;                      /*!< Mutex protecting queue */
+    pthread_cond_t not_empty;                   /*!< Condition signalled when entry is written */
+    pthread_cond_t not_full;                    /*!< Condition signalled when entry is read */
+    size_t get_waiters;                         /*!< Number of threads waiting for entry */
+    size_t put_waiters;                         /*!< Number of threads waiting for free slot */
+    size_t in, out, cnt, size;
+    void* entries[];
+};
+
+/**
+ * \brief           Thread start parameters
+ */
+typedef struct {
+    gsm_sys_thread_fn fn;                       /*!< Thread function */
+    void* arg;                                  /*!< Thread function argument */
+} posix_thread_start_t;
+
+static struct timespec sys_start_time;
+static pthread_condattr_t sys_condattr;         /* Condition attributes for monotonic clock */
+static gsm_sys_mutex_t sys_mutex;               /* Mutex ID for main protection */
+
+/**
+ * \brief           Get absolute monotonic time after timeout
+ * \param[out]      ts: Absolute time
+ * \param[in]       timeout: Timeout in units of milliseconds
+ */
+static void
+prv_deadline(struct timespec* ts, uint32_t timeout) {
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += timeout / 1000;
+    ts->tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ++ts->tv_sec;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * \brief           Wait for condition, with optional deadline
+ * \param[in]       cond: Condition to wait for
+ * \param[in]       mutex: Locked mutex protecting condition
+ * \param[in]       ts: Absolute deadline or `NULL` to wait forever
+ * \return          `1` if woken up, `0` on timeout
+ */
+static uint8_t
+prv_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* ts) {
+    if (ts == NULL) {
+        return pthread_cond_wait(cond, mutex) == 0;
+    }
+    return pthread_cond_timedwait(cond, mutex, ts) != ETIMEDOUT;
+}
+
+static pthread_cond_t*
+prv_cond_init(pthread_cond_t* cond) {
+    return pthread_cond_init(cond, &sys_condattr) == 0 ? cond : NULL;
+}
+
+static void*
+prv_thread_start(void* arg) {
+    posix_thread_start_t start = *(posix_thread_start_t *)arg;
+
+    free(arg);
+    start.fn(start.arg);
+    return NULL;
+}
+
+uint8_t
+gsm_sys_init(void) {
+    clock_gettime(CLOCK_MONOTONIC, &sys_start_time);
+
+    pthread_condattr_init(&sys_condattr);
+    pthread_condattr_setclock(&sys_condattr, CLOCK_MONOTONIC);
+
+    return gsm_sys_mutex_create(&sys_mutex);
+}
+
+uint32_t
+gsm_sys_now(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((now.tv_sec - sys_start_time.tv_sec) * 1000
+        + (now.tv_nsec - sys_start_time.tv_nsec) / 1000000L);
+}
+
+uint8_t
+gsm_sys_protect(void) {
+    gsm_sys_mutex_lock(&sys_mutex);
+    return 1;
+}
+
+uint8_t
+gsm_sys_unprotect(void) {
+    gsm_sys_mutex_unlock(&sys_mutex);
+    return 1;
+}
+
+uint8_t
+gsm_sys_mutex_create(gsm_sys_mutex_t* p) {
+    pthread_mutexattr_t attr;
+
+    *p = malloc(sizeof(**p));
+    if (*p == NULL) {
+        return 0;
+    }
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);  /* Core lock is recursive */
+    if (pthread_mutex_init(&(*p)->mutex, &attr) != 0) {
+        free(*p);
+        *p = NULL;
+    }
+    pthread_mutexattr_destroy(&attr);
+    return *p != NULL;
+}
+
+uint8_t
+gsm_sys_mutex_delete(gsm_sys_mutex_t* p) {
+    pthread_mutex_destroy(&(*p)->mutex);
+    free(*p);
+    return 1;
+}
+
+uint8_t
+gsm_sys_mutex_lock(gsm_sys_mutex_t* p) {
+    return pthread_mutex_lock(&(*p)->mutex) == 0;
+}
+
+uint8_t
+gsm_sys_mutex_unlock(gsm_sys_mutex_t* p) {
+    return pthread_mutex_unlock(&(*p)->mutex) == 0;
+}
+
+uint8_t
+gsm_sys_mutex_isvalid(gsm_sys_mutex_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+uint8_t
+gsm_sys_mutex_invalid(gsm_sys_mutex_t* p) {
+    *p = GSM_SYS_MUTEX_NULL;
+    return 1;
+}
+
+uint8_t
+gsm_sys_sem_create(gsm_sys_sem_t* p, uint8_t cnt) {
+    gsm_sys_sem_t s;
+
+    *p = NULL;
+    s = malloc(sizeof(*s));
+    if (s != NULL) {
+        s->cnt = !!cnt;
+        s->waiters = 0;
+        if (pthread_mutex_init(&s->mutex, NULL) != 0) {
+            free(s);
+        } else if (prv_cond_init(&s->cond) == NULL) {
+            pthread_mutex_destroy(&s->mutex);
+            free(s);
+        } else {
+            *p = s;
+        }
+    }
+    return *p != NULL;
+}
+
+uint8_t
+gsm_sys_sem_delete(gsm_sys_sem_t* p) {
+    pthread_cond_destroy(&(*p)->cond);
+    pthread_mutex_destroy(&(*p)->mutex);
+    free(*p);
+    return 1;
+}
+
+uint32_t
+gsm_sys_sem_wait(gsm_sys_sem_t* p, uint32_t timeout) {
+    gsm_sys_sem_t s = *p;
+    struct timespec ts;
+    uint32_t time = gsm_sys_now();
+
+    if (timeout > 0) {
+        prv_deadline(&ts, timeout);
+    }
+    pthread_mutex_lock(&s->mutex);
+    ++s->waiters;
+    while (s->cnt == 0) {
+        if (!prv_cond_wait(&s->cond, &s->mutex, timeout > 0 ? &ts : NULL) && s->cnt == 0) {
+            --s->waiters;
+            pthread_mutex_unlock(&s->mutex);
+            return GSM_SYS_TIMEOUT;
+        }
+    }
+    --s->waiters;
+    s->cnt = 0;
+    pthread_mutex_unlock(&s->mutex);
+    return gsm_sys_now() - time;
+}
+
+uint8_t
+gsm_sys_sem_release(gsm_sys_sem_t* p) {
+    gsm_sys_sem_t s = *p;
+
+    pthread_mutex_lock(&s->mutex);
+    s->cnt = 1;
+    if (s->waiters > 0) {                       /* Skip syscall when nobody waits */
+        pthread_cond_signal(&s->cond);
+    }
+    pthread_mutex_unlock(&s->mutex);
+    return 1;
+}
+
+uint8_t
+gsm_sys_sem_isvalid(gsm_sys_sem_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+uint8_t
+gsm_sys_sem_invalid(gsm_sys_sem_t* p) {
+    *p = GSM_SYS_SEM_NULL;
+    return 1;
+}
+
+uint8_t
+gsm_sys_mbox_create(gsm_sys_mbox_t* b, size_t size) {
+    gsm_sys_mbox_t mbox;
+
+    *b = NULL;
+    if (size == 0) {
+        return 0;
+    }
+
+    mbox = malloc(sizeof(*mbox) + size * sizeof(void *));
+    if (mbox != NULL) {
+        memset(mbox, 0x00, sizeof(*mbox));
+        mbox->size = size;
+        if (pthread_mutex_init(&mbox->mutex, NULL) != 0) {
+            free(mbox);
+        } else if (prv_cond_init(&mbox->not_empty) == NULL) {
+            pthread_mutex_destroy(&mbox->mutex);
+            free(mbox);
+        } else if (prv_cond_init(&mbox->not_full) == NULL) {
+            pthread_cond_destroy(&mbox->not_empty);
+            pthread_mutex_destroy(&mbox->mutex);
+            free(mbox);
+        } else {
+            *b = mbox;
+        }
+    }
+    return *b != NULL;
+}
+
+uint8_t
+gsm_sys_mbox_delete(gsm_sys_mbox_t* b) {
+    gsm_sys_mbox_t mbox = *b;
+
+    pthread_cond_destroy(&mbox->not_full);
+    pthread_cond_destroy(&mbox->not_empty);
+    pthread_mutex_destroy(&mbox->mutex);
+    free(mbox);
+    return 1;
+}
+
+/**
+ * \brief           Write entry to queue which is not full
+ * \note            Mutex must be locked when called
+ */
+static void
+prv_mbox_write(gsm_sys_mbox_t mbox, void* m) {
+    mbox->entries[mbox->in] = m;
+    if (++mbox->in >= mbox->size) {
+        mbox->in = 0;
+    }
+    ++mbox->cnt;
+    if (mbox->get_waiters > 0) {
+        pthread_cond_signal(&mbox->not_empty);
+    }
+}
+
+/**
+ * \brief           Read entry from queue which is not empty
+ * \note            Mutex must be locked when called
+ */
+static void
+prv_mbox_read(gsm_sys_mbox_t mbox, void** m) {
+    *m = mbox->entries[mbox->out];
+    if (++mbox->out >= mbox->size) {
+        mbox->out = 0;
+    }
+    --mbox->cnt;
+    if (mbox->put_waiters > 0) {
+        pthread_cond_signal(&mbox->not_full);
+    }
+}
+
+uint32_t
+gsm_sys_mbox_put(gsm_sys_mbox_t* b, void* m) {
+    gsm_sys_mbox_t mbox = *b;
+    uint32_t time = gsm_sys_now();              /* Get start time */
+
+    pthread_mutex_lock(&mbox->mutex);
+    ++mbox->put_waiters;
+    while (mbox->cnt == mbox->size) {
+        pthread_cond_wait(&mbox->not_full, &mbox->mutex);
+    }
+    --mbox->put_waiters;
+    prv_mbox_write(mbox, m);
+    pthread_mutex_unlock(&mbox->mutex);
+    return gsm_sys_now() - time;
+}
+
+uint32_t
+gsm_sys_mbox_get(gsm_sys_mbox_t* b, void** m, uint32_t timeout) {
+    gsm_sys_mbox_t mbox = *b;
+    struct timespec ts;
+    uint32_t time = gsm_sys_now();
+
+    if (timeout > 0) {
+        prv_deadline(&ts, timeout);
+    }
+    pthread_mutex_lock(&mbox->mutex);
+    ++mbox->get_waiters;
+    while (mbox->cnt == 0) {
+        if (!prv_cond_wait(&mbox->not_empty, &mbox->mutex, timeout > 0 ? &ts : NULL) && mbox->cnt == 0) {
+            --mbox->get_waiters;
+            pthread_mutex_unlock(&mbox->mutex);
+            return GSM_SYS_TIMEOUT;
+        }
+    }
+    --mbox->get_waiters;
+    prv_mbox_read(mbox, m);
+    pthread_mutex_unlock(&mbox->mutex);
+    return gsm_sys_now() - time;
+}
+
+uint8_t
+gsm_sys_mbox_putnow(gsm_sys_mbox_t* b, void* m) {
+    gsm_sys_mbox_t mbox = *b;
+    uint8_t res = 0;
+
+    pthread_mutex_lock(&mbox->mutex);
+    if (mbox->cnt < mbox->size) {
+        prv_mbox_write(mbox, m);
+        res = 1;
+    }
+    pthread_mutex_unlock(&mbox->mutex);
+    return res;
+}
+
+uint8_t
+gsm_sys_mbox_getnow(gsm_sys_mbox_t* b, void** m) {
+    gsm_sys_mbox_t mbox = *b;
+    uint8_t res = 0;
+
+    pthread_mutex_lock(&mbox->mutex);
+    if (mbox->cnt > 0) {
+        prv_mbox_read(mbox, m);
+        res = 1;
+    }
+    pthread_mutex_unlock(&mbox->mutex);
+    return res;
+}
+
+uint8_t
+gsm_sys_mbox_isvalid(gsm_sys_mbox_t* b) {
+    return b != NULL && *b != NULL;             /* Return status if message box is valid */
+}
+
+uint8_t
+gsm_sys_mbox_invalid(gsm_sys_mbox_t* b) {
+    *b = GSM_SYS_MBOX_NULL;                     /* Invalidate message box */
+    return 1;
+}
+
+uint8_t
+gsm_sys_thread_create(gsm_sys_thread_t* t, const char* name, gsm_sys_thread_fn thread_func, void* const arg, size_t stack_size, gsm_sys_thread_prio_t prio) {
+    posix_thread_start_t* start;
+    pthread_attr_t attr;
+    pthread_t thread;
+    int res;
+
+    start = malloc(sizeof(*start));
+    if (start == NULL) {
+        return 0;
+    }
+    start->fn = thread_func;
+    start->arg = arg;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (stack_size > 0) {
+        pthread_attr_setstacksize(&attr, stack_size < (size_t)PTHREAD_STACK_MIN ? (size_t)PTHREAD_STACK_MIN : stack_size);
+    }
+    if (prio > 0) {                             /* Real-time priority requested */
+        struct sched_param param;
+        int min = sched_get_priority_min(SCHED_FIFO), max = sched_get_priority_max(SCHED_FIFO);
+
+        param.sched_priority = prio < min ? min : (prio > max ? max : prio);
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+    }
+    res = pthread_create(&thread, &attr, prv_thread_start, start);
+    if (res == EPERM && prio > 0) {             /* Not privileged, fall back to inherited scheduling */
+        pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+        res = pthread_create(&thread, &attr, prv_thread_start, start);
+    }
+    pthread_attr_destroy(&attr);
+
+    if (res != 0) {
+        free(start);
+        return 0;
+    }
+#if defined(__GLIBC__)
+    if (name != NULL) {
+        char tname[16];
+
+        strncpy(tname, name, sizeof(tname) - 1);
+        tname[sizeof(tname) - 1] = '\0';
+        pthread_setname_np(thread, tname);      /* Name is limited to 15 characters */
+    }
+#endif /* defined(__GLIBC__) */
+    if (t != NULL) {
+        *t = thread;
+    }
+    return 1;
+}
+
+uint8_t
+gsm_sys_thread_terminate(gsm_sys_thread_t* t) {
+    if (t == NULL) {                            /* Shall we terminate ourself? */
+        pthread_exit(NULL);
+    }
+    pthread_cancel(*t);
+    return 1;
+}
+
+uint8_t
+gsm_sys_thread_yield(void) {
+    sched_yield();
+    return 1;
+}
+
+#endif /* !__DOXYGEN__ */